@@ -0,0 +1,181 @@
+/**
+* @brief Iterations and wall time of BicGStab with preconditioners on poorly conditioned systems
+* @details Convection-diffusion operators (5-point, upwind) on m*m grid and dense system with scaled rows.
+* Baseline "true residual" computes b - A * x on every iteration (LASsetup::residualCheckInterval = 1),
+* as BicGStab did before recurrence residuals. Tolerance is 1e-8 * ||b||, time is the best of 3 solves.
+*
+* Build and run on host:
+* @code
+* g++ -std=gnu++17 -O2 -I src benchmark/bicgstab.cpp -o bicgstab && ./bicgstab
+* @endcode
+*/
+
+#include <libmath/solver/las/bicgstab.h>
+#include <libmath/solver/las/preconditioner.h>
+#include <libmath/sparse.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <random>
+#include <vector>
+
+namespace
+{
+	/**
+	* @brief -eps * (u_xx + aniso * u_yy) + c * (u_x + u_y) on m*m grid of unit square
+	*/
+	math::SparseMatrix<double> convectionDiffusion(size_t m, double eps, double c, double aniso)
+	{
+		std::vector<math::Triplet<double>> t;
+		const double h = 1.0 / static_cast<double>(m + 1);
+		const double ax = eps / (h * h);
+		const double ay = aniso * eps / (h * h);
+		const double cx = c / h;
+		for (size_t i = 0; i < m; ++i)
+		{
+			for (size_t j = 0; j < m; ++j)
+			{
+				const size_t k = i * m + j;
+				t.push_back({ k, k, 2.0 * ax + 2.0 * ay + 2.0 * cx });
+				if (j > 0)
+				{
+					t.push_back({ k, k - 1, -ax - cx });
+				}
+				if (j + 1 < m)
+				{
+					t.push_back({ k, k + 1, -ax });
+				}
+				if (i > 0)
+				{
+					t.push_back({ k, k - m, -ay - cx });
+				}
+				if (i + 1 < m)
+				{
+					t.push_back({ k, k + m, -ay });
+				}
+			}
+		}
+		return math::SparseMatrix<double>::fromTriplets(m * m, m * m, t);
+	}
+
+	/// @brief Print iterations, best time of 3 solves and relative true residual
+	template <typename Operator>
+	void run(const char* name, math::BicGStab<double>& solver, const Operator& A, const math::Matrix<double>& b,
+		size_t residualCheckInterval = 50)
+	{
+		math::LASsetup setup;
+		setup.targetTolerance = 1e-8 * math::nrm2(b);
+		setup.abort_iter = 20000;
+		setup.residualCheckInterval = residualCheckInterval;
+		solver.setupSolver(setup);
+
+		math::Matrix<double> x(b.rows(), 1);
+		double best = 1e300;
+		for (int r = 0; r < 3; ++r)
+		{
+			x.fill(0.0);
+			const auto start = std::chrono::steady_clock::now();
+			try
+			{
+				solver.solve(A, b, x);
+			}
+			catch (const std::exception& e)
+			{
+				std::printf("  %-24s failed: %s\n", name, e.what());
+				return;
+			}
+			best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		math::Matrix<double> res = b;
+		A.apply(-1.0, x, 1.0, res);
+		std::printf("  %-24s %6zu it  %9.3f ms  residual %.1e\n", name, solver.iterations(), best,
+			math::nrm2(res) / math::nrm2(b));
+	}
+}
+
+int main()
+{
+	struct Case
+	{
+		const char* name;
+		size_t m;
+		double eps, c, aniso;
+	};
+	const Case cases[] = {
+		{ "Poisson", 32, 1.0, 0.0, 1.0 },
+		{ "anisotropic 100", 32, 1.0, 0.0, 100.0 },
+		{ "convection-diffusion", 50, 1e-2, 1.0, 1.0 },
+		{ "anisotropic 1000", 50, 1.0, 0.0, 1000.0 },
+	};
+
+	std::mt19937 generator(2);
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+	for (const Case& c : cases)
+	{
+		const math::SparseMatrix<double> A = convectionDiffusion(c.m, c.eps, c.c, c.aniso);
+		const size_t n = A.rows();
+		math::Matrix<double> b(n, 1);
+		for (size_t i = 0; i < n; ++i)
+		{
+			b(i, 0) = uniform(generator);
+		}
+		std::printf("%s, n = %zu, nnz = %zu\n", c.name, n, A.nnz());
+
+		math::BicGStab<double> solver;
+		run("true residual", solver, A, b, 1);
+		run("recurrence residual", solver, A, b);
+
+		const math::JacobiPreconditioner<double> jacobi(A);
+		solver.setPreconditioner(&jacobi);
+		run("Jacobi", solver, A, b);
+
+		const math::BlockJacobiPreconditioner<double> blockJacobi(A, c.m);
+		solver.setPreconditioner(&blockJacobi);
+		run("block-Jacobi (grid row)", solver, A, b);
+
+		const math::ILU0Preconditioner<double> ilu(A);
+		solver.setPreconditioner(&ilu);
+		run("ILU(0) right", solver, A, b);
+		solver.setPreconditioner(&ilu, math::PreconditionerSide::Left);
+		run("ILU(0) left", solver, A, b);
+
+		if (c.c == 0.0)
+		{
+			const math::IC0Preconditioner<double> ic(A);
+			solver.setPreconditioner(&ic);
+			run("IC(0)", solver, A, b);
+		}
+	}
+
+	// dense system with rows scaled by 1..1e5
+	const size_t n = 30;
+	math::Matrix<double> A(n, n);
+	math::Matrix<double> b(n, 1);
+	for (size_t i = 0; i < n; ++i)
+	{
+		const double scale = std::pow(1e5, static_cast<double>(i) / static_cast<double>(n - 1));
+		for (size_t j = 0; j < n; ++j)
+		{
+			A(i, j) = scale * (uniform(generator) + (i == j ? static_cast<double>(n) : 0.0));
+		}
+		b(i, 0) = scale;
+	}
+	std::printf("dense with scaled rows, n = %zu\n", n);
+	const math::DenseOperator<double> D(A);
+	math::BicGStab<double> solver;
+	run("true residual", solver, D, b, 1);
+	run("recurrence residual", solver, D, b);
+	const math::JacobiPreconditioner<double> jacobi(A);
+	solver.setPreconditioner(&jacobi);
+	run("Jacobi", solver, D, b);
+	const math::BlockJacobiPreconditioner<double> blockJacobi(A, 3);
+	solver.setPreconditioner(&blockJacobi);
+	run("block-Jacobi (3)", solver, D, b);
+	const math::ILU0Preconditioner<double> ilu(A);
+	solver.setPreconditioner(&ilu);
+	run("ILU(0)", solver, D, b);
+	return 0;
+}
@@ -0,0 +1,100 @@
+/**
+* @brief Speedup of blas::gemm (operator* of Matrix) over triple loop
+* @details Square random matrices n*n in double and float. Reference is i-j-k triple loop with element
+* access, as operator*(Matrix, Matrix) was computed before blas::gemm. Time is the best of repeats,
+* results are compared with the reference.
+*
+* Build and run on host (AVX2/FMA micro-kernel):
+* @code
+* g++ -std=gnu++17 -O2 -march=native -I src benchmark/gemm.cpp -o gemm && ./gemm
+* @endcode
+* Without -march=native the scalar micro-kernel is measured. Triple loop for n = 1024 takes minutes.
+*/
+
+#include <libmath/matrix.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+	/// @brief C = A * B by triple loop
+	template <typename T>
+	void reference(const math::Matrix<T>& A, const math::Matrix<T>& B, math::Matrix<T>& C)
+	{
+		for (size_t i = 0; i < A.rows(); ++i)
+		{
+			for (size_t j = 0; j < B.cols(); ++j)
+			{
+				T s = T(0);
+				for (size_t k = 0; k < A.cols(); ++k)
+				{
+					s += A(i, k) * B(k, j);
+				}
+				C(i, j) = s;
+			}
+		}
+	}
+
+	/// @brief Best time of f in ns, repeats are chosen so that every size runs about the same time
+	template <typename F>
+	double timeOf(size_t n, F f)
+	{
+		const size_t repeats = std::max<size_t>(3, 20000000 / (n * n * n + 100));
+		double best = 1e300;
+		for (size_t r = 0; r < repeats; ++r)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			f();
+			best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+		}
+		return best;
+	}
+
+	template <typename T>
+	void run(const char* type, size_t n)
+	{
+		std::mt19937 generator(static_cast<unsigned>(n));
+		std::uniform_real_distribution<T> uniform(T(-1), T(1));
+		math::Matrix<T> A(n, n), B(n, n), C(n, n), R(n, n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t j = 0; j < n; ++j)
+			{
+				A(i, j) = uniform(generator);
+				B(i, j) = uniform(generator);
+			}
+		}
+
+		const double tr = timeOf(n, [&]() { reference(A, B, R); });
+		const double tg = timeOf(n, [&]() { C = A * B; });
+
+		T diff = T(0);
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t j = 0; j < n; ++j)
+			{
+				diff = std::max(diff, std::abs(C(i, j) - R(i, j)));
+			}
+		}
+		const double flops = 2.0 * static_cast<double>(n) * static_cast<double>(n) * static_cast<double>(n);
+		std::printf("%-6s n = %4zu  loop %12.0f ns  gemm %12.0f ns  x%6.1f  %6.2f GFLOP/s  max diff %.1e\n",
+			type, n, tr, tg, tr / tg, flops / tg, static_cast<double>(diff));
+	}
+}
+
+int main()
+{
+	for (size_t n : { 3, 4, 8, 16, 32, 64, 128, 256, 512, 1024 })
+	{
+		run<double>("double", n);
+	}
+	for (size_t n : { 3, 16, 64, 256, 1024 })
+	{
+		run<float>("float", n);
+	}
+	return 0;
+}
@@ -0,0 +1,145 @@
+/**
+* @brief Time and heap allocations of small matrix code with and without inline storage of Matrix
+* @details operator new is replaced by counting one. Cases: Secant::solve of 3 equations (new solver
+* every call, so work matrices are allocated too), Secant::solve of 3 equations by kept solver, and small
+* expressions 3x3 and 4x4. Time is the best of repeats, allocations are counted per call.
+* Build twice to compare with storage on heap (as std::vector<T> before SmallVector):
+* @code
+* g++ -std=gnu++17 -O2 -I src benchmark/inline_storage.cpp -o inline_storage && ./inline_storage
+* g++ -std=gnu++17 -O2 -DMATH_MATRIX_INLINE_SIZE=0 -I src benchmark/inline_storage.cpp -o heap_storage && ./heap_storage
+* @endcode
+* Limb::calcServoPos isn't measured: it works on SMatrix only (never allocated), and limb.cpp needs
+* Arduino and Adafruit headers.
+*/
+
+#include <libmath/solver/us/secant.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+
+namespace
+{
+	size_t allocations = 0;
+
+	void* allocate(size_t bytes, size_t alignment)
+	{
+		++allocations;
+		bytes = (std::max<size_t>(bytes, 1) + alignment - 1) / alignment * alignment;
+		void* p = std::aligned_alloc(alignment, bytes);
+		if (p == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	/// @brief Result sink, so that compiler doesn't remove measured calls
+	volatile double sink = 0.0;
+
+	/// @brief Print best time of call of f in us and number of allocations per call
+	template <typename F>
+	void run(const char* name, F f)
+	{
+		f();
+		const size_t repeats = 2000;
+		double best = 1e300;
+		allocations = 0;
+		for (size_t r = 0; r < repeats; ++r)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			f();
+			best = std::min(best, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::printf("  %-28s %9.3f us  %6.1f allocs\n", name, best,
+			static_cast<double>(allocations) / static_cast<double>(repeats));
+	}
+
+	/// @brief Unlinear system of 3 equations
+	std::vector<std::function<double(const math::Matrix<double>&)>> system()
+	{
+		return {
+			[](const math::Matrix<double>& x) { return x(0, 0) * x(0, 0) + x(1, 0) - 2.0; },
+			[](const math::Matrix<double>& x) { return x(1, 0) * x(1, 0) * x(1, 0) + 2.0 * x(2, 0) - 3.0; },
+			[](const math::Matrix<double>& x) { return x(0, 0) + x(1, 0) * x(2, 0) + 4.0 * x(2, 0) - 6.0; },
+		};
+	}
+}
+
+void* operator new(size_t bytes)
+{
+	return allocate(bytes, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t bytes)
+{
+	return allocate(bytes, alignof(std::max_align_t));
+}
+
+void* operator new(size_t bytes, std::align_val_t alignment)
+{
+	return allocate(bytes, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t bytes, std::align_val_t alignment)
+{
+	return allocate(bytes, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+int main()
+{
+	std::printf("inline size %zu, sizeof(Matrix<double>) = %zu\n", math::settings::matrixInlineSize,
+		sizeof(math::Matrix<double>));
+
+	const auto F = system();
+	math::Matrix<double> x(3, 1);
+	run("Secant::solve 3x3, new", [&]()
+		{
+			math::Secant<double> secant;
+			x.fill(1.0);
+			secant.solve(F, x);
+		});
+	math::Secant<double> secant;
+	run("Secant::solve 3x3, kept", [&]()
+		{
+			x.fill(1.0);
+			secant.solve(F, x);
+		});
+
+	math::Matrix<double> A = { {4.0, 1.0, 0.5}, {1.0, 3.0, 0.2}, {0.5, 0.2, 2.0} };
+	math::Matrix<double> b = { {1.0}, {2.0}, {3.0} };
+	math::Matrix<double> r;
+	run("3x3 r = A * b - b", [&]()
+		{
+			r = A * b - b;
+			sink = sink + r(0, 0);
+		});
+
+	math::Matrix<double> B = { {4.0, 1.0, 0.5, 0.1}, {1.0, 3.0, 0.2, 0.3}, {0.5, 0.2, 2.0, 0.4}, {0.1, 0.3, 0.4, 1.0} };
+	math::Matrix<double> C;
+	run("4x4 C = B * B + B", [&]()
+		{
+			C = B * B + B;
+			sink = sink + C(0, 0);
+		});
+	run("4x4 C = B.inverse()", [&]()
+		{
+			C = B.inverse();
+			sink = sink + C(0, 0);
+		});
+	return 0;
+}
@@ -0,0 +1,85 @@
+/**
+* @brief Speedup of task-parallel blas::getrf over sequential one
+* @details Random matrices n*n in both layouts, time is the best of 3 factorizations. Thread counts
+* above the number of cores measure only overhead of tasks. Speedup on the target host decides
+* settings::Settings::luParallelThreshold (parallel LU is disabled by default).
+*
+* Build and run on multi-core host:
+* @code
+* g++ -std=gnu++17 -O2 -march=native -fopenmp -I src benchmark/lu_parallel.cpp -o lu_parallel && ./lu_parallel
+* @endcode
+*/
+
+#include <libmath/blas/lu.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+	/// @brief Best time of 3 factorizations in ms, factors and pivots of the last one
+	template <typename L>
+	double factorize(size_t n, const std::vector<double>& a0, int threads, std::vector<double>& a, std::vector<size_t>& ipiv)
+	{
+		double best = 1e300;
+		for (int r = 0; r < 3; ++r)
+		{
+			a = a0;
+			const auto start = std::chrono::steady_clock::now();
+			math::blas::getrf<L>(n, a.data(), n, ipiv.data(), threads);
+			best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		return best;
+	}
+
+	template <typename L>
+	void run(const char* layout, size_t n)
+	{
+		std::mt19937 generator(static_cast<unsigned>(n));
+		std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+		std::vector<double> a0(n * n);
+		for (double& v : a0)
+		{
+			v = uniform(generator);
+		}
+
+		std::vector<double> a1, a;
+		std::vector<size_t> ipiv1(n), ipiv(n);
+		const double t1 = factorize<L>(n, a0, 1, a1, ipiv1);
+		std::printf("%s n = %4zu  1 thread %9.2f ms", layout, n, t1);
+		for (int threads : { 2, 4, 8, 16 })
+		{
+			const double t = factorize<L>(n, a0, threads, a, ipiv);
+			double diff = 0.0;
+			for (size_t i = 0; i < n * n; ++i)
+			{
+				diff = std::max(diff, std::abs(a[i] - a1[i]));
+			}
+			std::printf("  %2d: x%5.2f%s", threads, t1 / t, ipiv == ipiv1 && diff < 1e-10 ? "" : " (mismatch)");
+		}
+		std::printf("\n");
+	}
+}
+
+int main()
+{
+#ifdef _OPENMP
+	std::printf("cores: %d\n", omp_get_num_procs());
+#else
+	std::printf("built without OpenMP: all runs are sequential\n");
+#endif
+	for (size_t n : { 256, 512, 1000, 2000 })
+	{
+		run<math::blas::RowMajor>("row", n);
+		run<math::blas::ColMajor>("col", n);
+	}
+	return 0;
+}
@@ -0,0 +1,264 @@
+/**
+* @brief Crossover of determinant and inverse algorithms for small matrices
+* @details For n = 2..8 compares time per call (ns) of
+* - cofactor expansion (recursion over first row, as Matrix::det(0) for n > 4),
+* - LU<T>(A).det() and LU<T>(A).inverse(),
+* - closed form blas::smallDet<N> and blas::smallInverse<N> (n <= 4), which Matrix::det() and
+*   Matrix::inverse() use for every method,
+* and SMatrix<3>::det(), SMatrix<4>::inverse() against Gauss elimination with partial pivoting.
+*
+* Build and run on host:
+* @code
+* g++ -std=gnu++17 -O2 -I src benchmark/small_det_inverse.cpp -o small_det_inverse && ./small_det_inverse
+* @endcode
+*/
+
+#include <libmath/blas/small.h>
+#include <libmath/lu.h>
+#include <libmath/smatrix.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	/// @brief Result sink, so that compiler doesn't remove measured calls
+	volatile double sink = 0.0;
+
+	/// @brief Compiler barrier: memory may change, so calls with the same operands aren't hoisted out of loops
+	inline void clobber()
+	{
+		asm volatile("" : : : "memory");
+	}
+
+	/// @brief Make local object p visible to clobber()
+	inline void escape(const void* p)
+	{
+		asm volatile("" : : "g"(p) : "memory");
+	}
+
+	/// @brief Average time of call of f in ns
+	template <typename F>
+	double timeOf(F f)
+	{
+		size_t repeats = 1;
+		for (;;)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t r = 0; r < repeats; ++r)
+			{
+				f();
+				clobber();
+			}
+			const double t = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			if (t > 2e7)
+			{
+				return t / static_cast<double>(repeats);
+			}
+			repeats *= 2;
+		}
+	}
+
+	/// @brief Determinant by cofactor expansion over first row of remaining columns
+	double cofactor(const math::Matrix<double>& A, size_t row, std::vector<bool>& used)
+	{
+		const size_t n = A.rows();
+		if (row + 1 == n)
+		{
+			for (size_t j = 0; j < n; ++j)
+			{
+				if (!used[j])
+				{
+					return A(row, j);
+				}
+			}
+		}
+		double d = 0.0;
+		double sign = 1.0;
+		for (size_t j = 0; j < n; ++j)
+		{
+			if (used[j])
+			{
+				continue;
+			}
+			used[j] = true;
+			d += sign * A(row, j) * cofactor(A, row + 1, used);
+			used[j] = false;
+			sign = -sign;
+		}
+		return d;
+	}
+
+	/// @brief Determinant by Gauss elimination with partial pivoting on copy of a
+	template <size_t N>
+	double gaussDet(math::SMatrix<double, N, N> a)
+	{
+		double d = 1.0;
+		for (size_t k = 0; k < N; ++k)
+		{
+			size_t p = k;
+			for (size_t i = k + 1; i < N; ++i)
+			{
+				if (std::abs(a(i, k)) > std::abs(a(p, k)))
+				{
+					p = i;
+				}
+			}
+			if (p != k)
+			{
+				for (size_t j = 0; j < N; ++j)
+				{
+					std::swap(a(k, j), a(p, j));
+				}
+				d = -d;
+			}
+			d *= a(k, k);
+			for (size_t i = k + 1; i < N; ++i)
+			{
+				const double l = a(i, k) / a(k, k);
+				for (size_t j = k; j < N; ++j)
+				{
+					a(i, j) -= l * a(k, j);
+				}
+			}
+		}
+		return d;
+	}
+
+	/// @brief Inverse by Gauss-Jordan elimination with partial pivoting
+	template <size_t N>
+	math::SMatrix<double, N, N> gaussInverse(math::SMatrix<double, N, N> a)
+	{
+		math::SMatrix<double, N, N> x;
+		for (size_t i = 0; i < N; ++i)
+		{
+			for (size_t j = 0; j < N; ++j)
+			{
+				x(i, j) = i == j ? 1.0 : 0.0;
+			}
+		}
+		for (size_t k = 0; k < N; ++k)
+		{
+			size_t p = k;
+			for (size_t i = k + 1; i < N; ++i)
+			{
+				if (std::abs(a(i, k)) > std::abs(a(p, k)))
+				{
+					p = i;
+				}
+			}
+			for (size_t j = 0; j < N; ++j)
+			{
+				std::swap(a(k, j), a(p, j));
+				std::swap(x(k, j), x(p, j));
+			}
+			const double r = 1.0 / a(k, k);
+			for (size_t j = 0; j < N; ++j)
+			{
+				a(k, j) *= r;
+				x(k, j) *= r;
+			}
+			for (size_t i = 0; i < N; ++i)
+			{
+				if (i == k)
+				{
+					continue;
+				}
+				const double l = a(i, k);
+				for (size_t j = 0; j < N; ++j)
+				{
+					a(i, j) -= l * a(k, j);
+					x(i, j) -= l * x(k, j);
+				}
+			}
+		}
+		return x;
+	}
+
+	template <size_t N>
+	double closedDet(const math::Matrix<double>& A)
+	{
+		return math::blas::smallDet<N>(A.data());
+	}
+
+	template <size_t N>
+	double closedInverse(const math::Matrix<double>& A, math::Matrix<double>& X)
+	{
+		return math::blas::smallInverse<N>(A.data(), X.data());
+	}
+
+	void run(size_t n)
+	{
+		std::mt19937 generator(static_cast<unsigned>(n));
+		std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+		math::Matrix<double> A(n, n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t j = 0; j < n; ++j)
+			{
+				A(i, j) = uniform(generator) + (i == j ? 2.0 : 0.0);
+			}
+		}
+
+		escape(&A);
+		std::vector<bool> used(n, false);
+		const double tc = timeOf([&]() { sink = sink + cofactor(A, 0, used); });
+		const double tl = timeOf([&]() { sink = sink + math::LU<double>(A).det(); });
+		const double tli = timeOf([&]() { sink = sink + math::LU<double>(A).inverse()(0, 0); });
+		std::printf("%2zu  %12.1f  %9.1f", n, tc, tl);
+
+		math::Matrix<double> X(n, n);
+		escape(&X);
+		double tcd = 0.0, tci = 0.0;
+		switch (n)
+		{
+		case 2:
+			tcd = timeOf([&]() { sink = sink + closedDet<2>(A); });
+			tci = timeOf([&]() { sink = sink + closedInverse<2>(A, X); });
+			break;
+		case 3:
+			tcd = timeOf([&]() { sink = sink + closedDet<3>(A); });
+			tci = timeOf([&]() { sink = sink + closedInverse<3>(A, X); });
+			break;
+		case 4:
+			tcd = timeOf([&]() { sink = sink + closedDet<4>(A); });
+			tci = timeOf([&]() { sink = sink + closedInverse<4>(A, X); });
+			break;
+		default:
+			break;
+		}
+		if (tcd > 0.0)
+		{
+			std::printf("  %10.1f  |  %10.1f  %14.1f\n", tcd, tli, tci);
+		}
+		else
+		{
+			std::printf("  %10s  |  %10.1f  %14s\n", "-", tli, "-");
+		}
+	}
+}
+
+int main()
+{
+	std::printf("ns per call\n");
+	std::printf(" n      cofactor     LU det  closed det  |  LU inverse  closed inverse\n");
+	for (size_t n = 2; n <= 8; ++n)
+	{
+		run(n);
+	}
+
+	math::SMatrix<double, 3, 3> S3 = { {2.0, 1.0, 0.5}, {0.3, 3.0, 1.0}, {1.0, -0.5, 4.0} };
+	math::SMatrix<double, 4, 4> S4 = { {2.0, 1.0, 0.5, 0.1}, {0.3, 3.0, 1.0, 0.2}, {1.0, -0.5, 4.0, 0.3},
+		{0.2, 0.1, -1.0, 5.0} };
+	escape(&S3);
+	escape(&S4);
+	std::printf("SMatrix<3>::det      %6.1f ns, Gauss %6.1f ns\n",
+		timeOf([&]() { sink = sink + S3.det(); }), timeOf([&]() { sink = sink + gaussDet(S3); }));
+	std::printf("SMatrix<4>::inverse  %6.1f ns, Gauss %6.1f ns\n",
+		timeOf([&]() { sink = sink + S4.inverse()(0, 0); }), timeOf([&]() { sink = sink + gaussInverse(S4)(0, 0); }));
+	return 0;
+}
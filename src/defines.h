@@ -1,14 +1,13 @@
 #pragma once
 
-#define ROBO_DOUBLE_PREC
+#include <libmath/math_settings.h>
 
 namespace robo
 {
     /// @brief Precision
+    /// @details The same as math::real: precision policy is defined by MATH_SINGLE_PRECISION (see math_settings.h)
+#ifdef MATH_DOUBLE_PRECISION_DEFINE
 #define ROBO_DOUBLE_PREC
-#ifdef ROBO_DOUBLE_PREC
-    typedef double real;
-#else
-    typedef float real;
 #endif
+    typedef math::real real;
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <libmath/blas/level1.h>
+#include <libmath/blas/level2.h>
+#include <libmath/blas/gemm.h>
+
+#include <string>
+#include <type_traits>
+#include <cmath>
+
+namespace math
+{
+	/**
+	* @defgroup Blas BLAS-style operations on matrices
+	* @{
+	* @brief Vector operations and matrix-vector products, which work in place and don't allocate.
+	* @details Vectors are column (N*1) or row (1*N) matrices. Level 1 operations also accept
+	* matrices of the same dimensions and representation, which are treated as vectors of numel() elements.
+	* Every operation also accepts strided views (MatrixView: blocks, rows, columns, external buffers).
+	*
+	* Example of using in C++:
+	* @code
+	* #include <libmath/blas.h>
+	*
+	* int main()
+	* {
+	*	math::Matrix<double> A = { {4.0, 1.0}, {1.0, 3.0} };
+	*	math::Matrix<double> x = { {1.0}, {2.0} };
+	*	math::Matrix<double> y(2, 1);
+	*
+	*	// y = A * x
+	*	math::gemv(1.0, A, x, 0.0, y);
+	*
+	*	// y = y - 2 * x
+	*	math::axpy(-2.0, x, y);
+	*
+	*	double r = math::nrm2(y);
+	* }
+	* @endcode
+	*/
+
+	namespace detail
+	{
+		/// @brief Check, that x and y can be processed as vectors of the same length
+		template <typename T>
+		void checkLevel1(const Matrix<T>& x, const Matrix<T>& y, const char* method)
+		{
+			bool vectors = (x.rows() == 1 || x.cols() == 1) && (y.rows() == 1 || y.cols() == 1);
+			if (x.numel() != y.numel() ||
+				(!vectors && (x.rows() != y.rows() || x.representation() != y.representation())))
+			{
+				throw(math::ExceptionIncorrectMatrix(std::string(method) + ": dimensions of arguments x and y didn't agree!"));
+			}
+		}
+	}
+
+	/**
+	* @brief Inner product @f$ \mathbf{x}^T \mathbf{y} @f$
+	* @throws math::ExceptionIncorrectMatrix
+	*/
+	template <typename T>
+	T dot(const Matrix<T>& x, const Matrix<T>& y)
+	{
+		detail::checkLevel1(x, y, "dot");
+		return blas::dot(x.numel(), x.data(), 1, y.data(), 1);
+	}
+
+	/**
+	* @brief @f$ \mathbf{y} = \alpha \mathbf{x} + \mathbf{y} @f$
+	* @throws math::ExceptionIncorrectMatrix
+	*/
+	template <typename T>
+	void axpy(T alpha, const Matrix<T>& x, Matrix<T>& y)
+	{
+		detail::checkLevel1(x, y, "axpy");
+		blas::axpy(x.numel(), alpha, x.data(), 1, y.data(), 1);
+	}
+
+	/**
+	* @brief @f$ \mathbf{x} = \alpha \mathbf{x} @f$
+	*/
+	template <typename T>
+	void scal(T alpha, Matrix<T>& x)
+	{
+		blas::scal(x.numel(), alpha, x.data(), 1);
+	}
+
+	/**
+	* @brief Euclidean (Frobenius for matrices) norm @f$ \|\mathbf{x}\|_2 @f$
+	*/
+	template <typename T>
+	T nrm2(const Matrix<T>& x)
+	{
+		return blas::nrm2(x.numel(), x.data(), 1);
+	}
+
+	/**
+	* @brief Sum of absolute values @f$ \|\mathbf{x}\|_1 @f$
+	*/
+	template <typename T>
+	T nrm1(const Matrix<T>& x)
+	{
+		return blas::nrm1(x.numel(), x.data(), 1);
+	}
+
+	/**
+	* @brief Maximum absolute value @f$ \|\mathbf{x}\|_\infty @f$
+	*/
+	template <typename T>
+	T nrmInf(const Matrix<T>& x)
+	{
+		return blas::nrmInf(x.numel(), x.data(), 1);
+	}
+
+	namespace detail
+	{
+		/// @brief gemv for strided matrix A (Matrix or TransposeView)
+		template <typename T, typename A_t>
+		void gemvStrided(T alpha, const A_t& A, const Matrix<T>& x, T beta, Matrix<T>& y)
+		{
+			if (x.numel() != A.cols() || (x.rows() != 1 && x.cols() != 1))
+			{
+				throw(math::ExceptionIncorrectMatrix("gemv: dimensions of arguments A and x didn't agree!"));
+			}
+			if (y.numel() != A.rows() || (y.rows() != 1 && y.cols() != 1))
+			{
+				throw(math::ExceptionIncorrectMatrix("gemv: dimensions of arguments A and y didn't agree!"));
+			}
+			blas::gemv(A.rows(), A.cols(), alpha,
+				A.data(), A.rowStride(), A.colStride(),
+				x.data(), 1,
+				beta,
+				y.data(), 1);
+		}
+	}
+
+	/**
+	* @brief Matrix-vector product @f$ \mathbf{y} = \alpha \mathbf{A} \mathbf{x} + \beta \mathbf{y} @f$
+	* @param A: Matrix M*N of any representation
+	* @param x: Vector of N elements
+	* @param y[in,out]: Vector of M elements
+	* @throws math::ExceptionIncorrectMatrix
+	*/
+	template <typename T>
+	void gemv(T alpha, const Matrix<T>& A, const Matrix<T>& x, T beta, Matrix<T>& y)
+	{
+		detail::gemvStrided(alpha, A, x, beta, y);
+	}
+
+	/**
+	* @brief Product with transposed matrix @f$ \mathbf{y} = \alpha \mathbf{A}^T \mathbf{x} + \beta \mathbf{y} @f$
+	* @details A.t() is used directly, without transposed copy
+	* @param A: Transpose view of matrix N*M
+	* @throws math::ExceptionIncorrectMatrix
+	*/
+	template <typename T>
+	void gemv(T alpha, const TransposeView<T>& A, const Matrix<T>& x, T beta, Matrix<T>& y)
+	{
+		detail::gemvStrided(alpha, A, x, beta, y);
+	}
+
+	namespace detail
+	{
+		/// @brief Distance between consecutive elements of vector view
+		template <typename V>
+		size_t vectorInc(const V& v)
+		{
+			return v.rows() == 1 ? v.colStride() : v.rowStride();
+		}
+
+		/// @brief Overload is used, when at least one of operands is a MatrixView
+		template <typename X, typename Y>
+		using EnableForViews = std::enable_if_t<
+			IsMatrixView<std::decay_t<X>>::value || IsMatrixView<std::decay_t<Y>>::value>;
+
+		/**
+		* @brief Call f(n, x, incx, y, incy) for strided vectors of views x and y
+		* @details Vectors are processed by one call, matrices of the same dimensions - by rows
+		* or columns (the one with unit stride in x)
+		*/
+		template <typename X, typename Y, typename F>
+		void forVectors(const X& x, const Y& y, const char* method, F f)
+		{
+			const bool vectors = (x.rows() == 1 || x.cols() == 1) && (y.rows() == 1 || y.cols() == 1);
+			if (vectors && x.numel() == y.numel())
+			{
+				f(x.numel(), x.data(), vectorInc(x), y.data(), vectorInc(y));
+				return;
+			}
+			if (x.rows() != y.rows() || x.cols() != y.cols())
+			{
+				throw(math::ExceptionIncorrectMatrix(std::string(method) + ": dimensions of arguments x and y didn't agree!"));
+			}
+			if (x.representation() == MatRep::Row)
+			{
+				for (size_t i = 0; i < x.rows(); ++i)
+				{
+					f(x.cols(), x.data() + i * x.rowStride(), x.colStride(), y.data() + i * y.rowStride(), y.colStride());
+				}
+			}
+			else
+			{
+				for (size_t j = 0; j < x.cols(); ++j)
+				{
+					f(x.rows(), x.data() + j * x.colStride(), x.rowStride(), y.data() + j * y.colStride(), y.rowStride());
+				}
+			}
+		}
+	}
+
+	/**
+	* @brief Inner product of strided operands, at least one of them is a MatrixView
+	* @details Operands are vectors of the same length or matrices of the same dimensions
+	* @throws math::ExceptionIncorrectMatrix
+	*/
+	template <typename X, typename Y, typename = detail::EnableForViews<X, Y>>
+	typename X::value_type dot(const X& x, const Y& y)
+	{
+		typedef typename X::value_type T;
+		T s = static_cast<T>(0);
+		detail::forVectors(x.view(), y.view(), "dot",
+			[&s](size_t n, const T* a, size_t inca, const T* b, size_t incb) { s += blas::dot(n, a, inca, b, incb); });
+		return s;
+	}
+
+	/**
+	* @brief @f$ \mathbf{y} = \alpha \mathbf{x} + \mathbf{y} @f$ for strided operands, at least one of them is a MatrixView
+	* @throws math::ExceptionIncorrectMatrix
+	*/
+	template <typename T, typename X, typename Y, typename = detail::EnableForViews<X, Y>>
+	void axpy(T alpha, const X& x, Y&& y)
+	{
+		detail::forVectors(x.view(), y.view(), "axpy",
+			[alpha](size_t n, const T* a, size_t inca, T* b, size_t incb) { blas::axpy(n, alpha, a, inca, b, incb); });
+	}
+
+	/**
+	* @brief @f$ \mathbf{x} = \alpha \mathbf{x} @f$ for MatrixView
+	*/
+	template <typename T>
+	void scal(T alpha, const MatrixView<T>& x)
+	{
+		detail::forVectors(x, x, "scal",
+			[alpha](size_t n, const T*, size_t, T* b, size_t incb) { blas::scal(n, alpha, b, incb); });
+	}
+
+	/**
+	* @brief Euclidean (Frobenius for matrices) norm of MatrixView
+	*/
+	template <typename T>
+	std::remove_const_t<T> nrm2(const MatrixView<T>& x)
+	{
+		return std::sqrt(dot(x, x));
+	}
+
+	/**
+	* @brief Matrix-vector product @f$ \mathbf{y} = \alpha \mathbf{A} \mathbf{x} + \beta \mathbf{y} @f$ for strided operands
+	* @details A is Matrix, TransposeView or MatrixView, x and y are vectors (Matrix or MatrixView, e.g. column of matrix),
+	* at least one of x and y is a MatrixView
+	* @throws math::ExceptionIncorrectMatrix
+	*/
+	template <typename T, typename A_t, typename X, typename Y, typename = detail::EnableForViews<X, Y>>
+	void gemv(T alpha, const A_t& A, const X& x, T beta, Y&& y)
+	{
+		const auto a = A.view();
+		const auto xv = x.view();
+		const auto yv = y.view();
+		if (xv.numel() != a.cols() || (xv.rows() != 1 && xv.cols() != 1))
+		{
+			throw(math::ExceptionIncorrectMatrix("gemv: dimensions of arguments A and x didn't agree!"));
+		}
+		if (yv.numel() != a.rows() || (yv.rows() != 1 && yv.cols() != 1))
+		{
+			throw(math::ExceptionIncorrectMatrix("gemv: dimensions of arguments A and y didn't agree!"));
+		}
+		blas::gemv(a.rows(), a.cols(), alpha,
+			a.data(), a.rowStride(), a.colStride(),
+			xv.data(), detail::vectorInc(xv),
+			beta,
+			yv.data(), detail::vectorInc(yv));
+	}
+
+	/**
+	* @brief Matrix product @f$ \mathbf{C} = \alpha \mathbf{A} \mathbf{B} + \beta \mathbf{C} @f$ in place
+	* @details Operands are Matrix, TransposeView or MatrixView, C is Matrix or MatrixView (e.g. block of
+	* matrix for panel updates). C isn't resized. Computed by blas::gemm without copies of operands.
+	* @throws math::ExceptionIncorrectMatrix
+	*/
+	template <typename T, typename A_t, typename B_t, typename C_t>
+	void gemm(T alpha, const A_t& A, const B_t& B, T beta, C_t&& C)
+	{
+		const auto a = A.view();
+		const auto b = B.view();
+		const auto c = C.view();
+		if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols())
+		{
+			throw(math::ExceptionIncorrectMatrix("gemm: dimensions of arguments A, B and C didn't agree!"));
+		}
+		blas::gemm(a.rows(), b.cols(), a.cols(), alpha,
+			a.data(), a.rowStride(), a.colStride(),
+			b.data(), b.rowStride(), b.colStride(),
+			beta,
+			c.data(), c.rowStride(), c.colStride());
+	}
+
+	/**
+	* @}
+	*/
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <libmath/blas/level1.h>
+#include <libmath/blas/gemm.h>
+#include <libmath/blas/packed.h>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace math::blas
+{
+	namespace detail
+	{
+		/// @brief Copy rows i0:i1 of packed triangle to row-major buffer w with leading dimension ld
+		template <typename T>
+		void unpackRows(size_t i0, size_t i1, const T* ap, T* w, size_t ld)
+		{
+			for (size_t i = i0; i < i1; ++i)
+			{
+				std::copy(ap + packedRow(i), ap + packedRow(i) + i + 1, w + (i - i0) * ld);
+			}
+		}
+
+		/// @brief Copy rows i0:i1 of row-major buffer w back to packed triangle
+		template <typename T>
+		void packRows(size_t i0, size_t i1, const T* w, size_t ld, T* ap)
+		{
+			for (size_t i = i0; i < i1; ++i)
+			{
+				std::copy(w + (i - i0) * ld, w + (i - i0) * ld + i + 1, ap + packedRow(i));
+			}
+		}
+	}
+
+	/**
+	* @brief Cholesky factorization @f$ \mathbf{A} = \mathbf{L} \mathbf{L}^T @f$ in packed storage
+	* @details Blocked left-looking algorithm by row panels of packedBlock rows. Panel I is unpacked
+	* to contiguous buffer, every block L(I,J) is updated by gemm with already computed rows J
+	* (L(I,J) -= L(I,0:j0) * L(J,0:j0)^T) and finished by substitution inside the block.
+	* Only two buffers of packedBlock rows are used in addition to packed storage.
+	* @param ap[in,out]: Lower triangle of A, replaced by L
+	* @return 0 on success, k + 1 if A isn't positive definite (pivot k isn't positive)
+	*/
+	template <typename T>
+	size_t pptrf(size_t n, T* ap)
+	{
+		const size_t nb = std::min(n, packedBlock);
+		std::vector<T> W(nb * n);
+		std::vector<T> G(nb * n);
+		for (size_t i0 = 0; i0 < n; i0 += packedBlock)
+		{
+			const size_t i1 = std::min(n, i0 + packedBlock);
+			const size_t mi = i1 - i0;
+			const size_t ld = i1;
+			T* w = W.data();
+			detail::unpackRows(i0, i1, ap, w, ld);
+
+			// blocks left of diagonal
+			for (size_t j0 = 0; j0 < i0; j0 += packedBlock)
+			{
+				const size_t j1 = std::min(i0, j0 + packedBlock);
+				const size_t mj = j1 - j0;
+				T* g = G.data();
+				detail::unpackRows(j0, j1, ap, g, j1);
+				gemm(mi, mj, j0, T(-1),
+					w, ld, static_cast<size_t>(1),
+					g, static_cast<size_t>(1), j1,
+					T(1),
+					w + j0, ld, static_cast<size_t>(1));
+				for (size_t ii = 0; ii < mi; ++ii)
+				{
+					T* wi = w + ii * ld;
+					for (size_t jj = 0; jj < mj; ++jj)
+					{
+						const T* gj = g + jj * j1;
+						wi[j0 + jj] = (wi[j0 + jj] - dot(jj, wi + j0, 1, gj + j0, 1)) / gj[j0 + jj];
+					}
+				}
+			}
+
+			// diagonal block
+			gemm(mi, mi, i0, T(-1),
+				w, ld, static_cast<size_t>(1),
+				w, static_cast<size_t>(1), ld,
+				T(1),
+				w + i0, ld, static_cast<size_t>(1));
+			for (size_t ii = 0; ii < mi; ++ii)
+			{
+				T* wi = w + ii * ld;
+				for (size_t jj = 0; jj < ii; ++jj)
+				{
+					const T* wj = w + jj * ld;
+					wi[i0 + jj] = (wi[i0 + jj] - dot(jj, wi + i0, 1, wj + i0, 1)) / wj[i0 + jj];
+				}
+				const T d = wi[i0 + ii] - dot(ii, wi + i0, 1, wi + i0, 1);
+				if (!(d > T(0)))
+				{
+					return i0 + ii + 1;
+				}
+				wi[i0 + ii] = std::sqrt(d);
+			}
+			detail::packRows(i0, i1, w, ld, ap);
+		}
+		return 0;
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{L} \mathbf{L}^T \mathbf{X} = \mathbf{B} @f$ in place using factorization from pptrf
+	* @details B of size n*nrhs is described by pointer and strides
+	*/
+	template <typename T>
+	void pptrs(size_t n, const T* ap, size_t nrhs, T* b, size_t b_rs, size_t b_cs)
+	{
+		for (size_t c = 0; c < nrhs; ++c)
+		{
+			T* x = b + c * b_cs;
+			// L * y = b
+			for (size_t i = 0; i < n; ++i)
+			{
+				const T* li = ap + packedRow(i);
+				x[i * b_rs] = (x[i * b_rs] - dot(i, li, 1, x, b_rs)) / li[i];
+			}
+			// L^T * x = y, column i of L^T is row i of L
+			for (size_t i = n; i-- > 0;)
+			{
+				const T* li = ap + packedRow(i);
+				x[i * b_rs] /= li[i];
+				axpy(i, -x[i * b_rs], li, 1, x, b_rs);
+			}
+		}
+	}
+
+	/**
+	* @brief Factorization @f$ \mathbf{A} = \mathbf{L} \mathbf{D} \mathbf{L}^T @f$ without pivoting in packed storage
+	* @details L has unit diagonal, D is stored on diagonal of packed storage. Blocked left-looking
+	* algorithm as in pptrf: panel I holds C(I,:) = L(I,:) * D, which is updated by gemm
+	* (C(I,J) -= C(I,0:j0) * L(J,0:j0)^T), then D(I) is computed and panel is scaled to L.
+	* Square roots aren't needed, so symmetric indefinite (quasi-definite) matrices
+	* with non-zero leading minors can be factorized too.
+	* @param ap[in,out]: Lower triangle of A, replaced by L and D
+	* @return 0 on success, k + 1 if D(k) is zero
+	*/
+	template <typename T>
+	size_t pptrfLDLT(size_t n, T* ap)
+	{
+		const size_t nb = std::min(n, packedBlock);
+		std::vector<T> W(nb * n);
+		std::vector<T> G(nb * n);
+		for (size_t i0 = 0; i0 < n; i0 += packedBlock)
+		{
+			const size_t i1 = std::min(n, i0 + packedBlock);
+			const size_t mi = i1 - i0;
+			const size_t ld = i1;
+			T* w = W.data();
+			T* g = G.data();
+			detail::unpackRows(i0, i1, ap, w, ld);
+
+			// blocks left of diagonal
+			for (size_t j0 = 0; j0 < i0; j0 += packedBlock)
+			{
+				const size_t j1 = std::min(i0, j0 + packedBlock);
+				const size_t mj = j1 - j0;
+				detail::unpackRows(j0, j1, ap, g, j1);
+				gemm(mi, mj, j0, T(-1),
+					w, ld, static_cast<size_t>(1),
+					g, static_cast<size_t>(1), j1,
+					T(1),
+					w + j0, ld, static_cast<size_t>(1));
+				for (size_t ii = 0; ii < mi; ++ii)
+				{
+					T* wi = w + ii * ld;
+					for (size_t jj = 0; jj < mj; ++jj)
+					{
+						wi[j0 + jj] -= dot(jj, wi + j0, 1, g + jj * j1 + j0, 1);
+					}
+				}
+			}
+
+			// diagonal block: L(I,0:i0) = C(I,0:i0) / D is needed for update
+			for (size_t ii = 0; ii < mi; ++ii)
+			{
+				for (size_t k = 0; k < i0; ++k)
+				{
+					g[ii * ld + k] = w[ii * ld + k] / ap[packedRow(k) + k];
+				}
+			}
+			gemm(mi, mi, i0, T(-1),
+				w, ld, static_cast<size_t>(1),
+				g, static_cast<size_t>(1), ld,
+				T(1),
+				w + i0, ld, static_cast<size_t>(1));
+			for (size_t ii = 0; ii < mi; ++ii)
+			{
+				T* wi = w + ii * ld;
+				for (size_t jj = 0; jj < ii; ++jj)
+				{
+					wi[i0 + jj] -= dot(jj, wi + i0, 1, w + jj * ld + i0, 1);
+				}
+				// convert row to L and compute D(i)
+				T d = wi[i0 + ii];
+				for (size_t kk = 0; kk < ii; ++kk)
+				{
+					const T l = wi[i0 + kk] / w[kk * ld + i0 + kk];
+					d -= l * wi[i0 + kk];
+					wi[i0 + kk] = l;
+				}
+				if (d == T(0))
+				{
+					return i0 + ii + 1;
+				}
+				wi[i0 + ii] = d;
+				std::copy(g + ii * ld, g + ii * ld + i0, wi);
+			}
+			detail::packRows(i0, i1, w, ld, ap);
+		}
+		return 0;
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{L} \mathbf{D} \mathbf{L}^T \mathbf{X} = \mathbf{B} @f$ in place using factorization from pptrfLDLT
+	* @details B of size n*nrhs is described by pointer and strides
+	*/
+	template <typename T>
+	void pptrsLDLT(size_t n, const T* ap, size_t nrhs, T* b, size_t b_rs, size_t b_cs)
+	{
+		for (size_t c = 0; c < nrhs; ++c)
+		{
+			T* x = b + c * b_cs;
+			// L * y = b
+			for (size_t i = 0; i < n; ++i)
+			{
+				x[i * b_rs] -= dot(i, ap + packedRow(i), 1, x, b_rs);
+			}
+			// D * z = y
+			for (size_t i = 0; i < n; ++i)
+			{
+				x[i * b_rs] /= ap[packedRow(i) + i];
+			}
+			// L^T * x = z
+			for (size_t i = n; i-- > 0;)
+			{
+				axpy(i, -x[i * b_rs], ap + packedRow(i), 1, x, b_rs);
+			}
+		}
+	}
+}
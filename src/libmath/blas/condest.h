@@ -0,0 +1,156 @@
+#pragma once
+
+#include <libmath/blas/level1.h>
+#include <libmath/memory_resource.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace math::blas
+{
+	/// @brief Maximal number of iterations of invNorm1Estimate (Higham's limit)
+	constexpr size_t condestIterations = 5;
+
+	namespace detail
+	{
+		/// @brief Index of element of maximal absolute value
+		template <typename T>
+		size_t iamax(size_t n, const T* x)
+		{
+			size_t j = 0;
+			for (size_t i = 1; i < n; ++i)
+			{
+				if (std::abs(x[i]) > std::abs(x[j]))
+				{
+					j = i;
+				}
+			}
+			return j;
+		}
+
+		/// @brief s = sign(x) (1 for zero), returns true if s didn't change
+		template <typename T>
+		bool signs(size_t n, const T* x, T* s)
+		{
+			bool same = true;
+			for (size_t i = 0; i < n; ++i)
+			{
+				const T si = x[i] >= T(0) ? T(1) : T(-1);
+				same = same && si == s[i];
+				s[i] = si;
+			}
+			return same;
+		}
+	}
+
+	/**
+	* @brief Estimate of @f$ \|\mathbf{A}^{-1}\|_1 @f$ by Hager's method with Higham's refinements
+	* @details A isn't formed: solve(x) replaces vector x of n elements by A^-1 x, solveT(x) - by A^-T x
+	* (by existing factorization, so estimate costs O(n^2)). Usually 2-3 pairs of solves are made,
+	* at most condestIterations. Estimate is a lower bound, which is almost always within factor 3 of the
+	* true norm; alternative estimate with vector (-1)^i (1 + i/(n-1)) protects against bad cases.
+	* @see N.J. Higham, FORTRAN codes for estimating the one-norm of a real or complex matrix,
+	* with applications to condition estimation, ACM TOMS 14(4), 1988
+	* @param work: Workspace of 2n elements, nullptr - allocated by the function
+	*/
+	template <typename T, typename Solve, typename SolveT>
+	T invNorm1Estimate(size_t n, Solve solve, SolveT solveT, T* work = nullptr)
+	{
+		if (n == 0)
+		{
+			return T(0);
+		}
+		if (work == nullptr)
+		{
+			AlignedBuffer<T> buffer(2 * n);
+			return invNorm1Estimate<T>(n, solve, solveT, buffer.data());
+		}
+		T* x = work;
+		T* s = work + n;
+
+		std::fill(x, x + n, T(1) / static_cast<T>(n));
+		solve(x);
+		if (n == 1)
+		{
+			return std::abs(x[0]);
+		}
+		T est = nrm1(n, x, 1);
+		std::fill(s, s + n, T(0));
+		detail::signs(n, x, s);
+		std::copy(s, s + n, x);
+		solveT(x);
+		size_t j = detail::iamax(n, x);
+
+		for (size_t iter = 1; iter < condestIterations; ++iter)
+		{
+			// x = A^-1 * e_j
+			std::fill(x, x + n, T(0));
+			x[j] = T(1);
+			solve(x);
+			const T previous = est;
+			est = nrm1(n, x, 1);
+			if (detail::signs(n, x, s) || est <= previous)
+			{
+				est = std::max(est, previous);
+				break;
+			}
+			std::copy(s, s + n, x);
+			solveT(x);
+			const size_t jlast = j;
+			j = detail::iamax(n, x);
+			if (std::abs(x[jlast]) == std::abs(x[j]))
+			{
+				break;
+			}
+		}
+
+		// alternative estimate
+		for (size_t i = 0; i < n; ++i)
+		{
+			const T v = T(1) + static_cast<T>(i) / static_cast<T>(n - 1);
+			x[i] = (i % 2 == 0) ? v : -v;
+		}
+		solve(x);
+		return std::max(est, T(2) * nrm1(n, x, 1) / (T(3) * static_cast<T>(n)));
+	}
+
+	/**
+	* @brief 1-norm (maximal column sum of absolute values) of matrix m*n, element (i,j) is a[i * rs + j * cs]
+	* @param work: Workspace of n elements for matrix with contiguous rows, nullptr - allocated by the function
+	*/
+	template <typename T>
+	T norm1(size_t m, size_t n, const T* a, size_t rs, size_t cs, T* work = nullptr)
+	{
+		if (n == 0)
+		{
+			return T(0);
+		}
+		if (cs >= rs)
+		{
+			T r = T(0);
+			for (size_t j = 0; j < n; ++j)
+			{
+				r = std::max(r, nrm1(m, a + j * cs, rs));
+			}
+			return r;
+		}
+		// rows are contiguous: sums of columns are accumulated along rows
+		if (work == nullptr)
+		{
+			AlignedBuffer<T> sums(n);
+			return norm1(m, n, a, rs, cs, sums.data());
+		}
+		T* c = work;
+		std::fill(c, c + n, T(0));
+		for (size_t i = 0; i < m; ++i)
+		{
+			const T* ai = a + i * rs;
+			for (size_t j = 0; j < n; ++j)
+			{
+				c[j] += std::abs(ai[j * cs]);
+			}
+		}
+		return *std::max_element(c, c + n);
+	}
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <libmath/memory_resource.h>
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define MATH_GEMM_AVX2
+#endif
+
+namespace math::blas
+{
+	/**
+	* @brief Blocking parameters of GEMM kernel for type T
+	* @details
+	*	- MR, NR: size of register block computed by micro-kernel
+	*	- KC: depth of packed panels (panel of B KC*NR fits L1 cache)
+	*	- MC: rows of packed block of A (block MC*KC fits L2 cache)
+	*	- NC: columns of packed block of B (block KC*NC fits L3 cache)
+	*	- tiny: products with M*N*K not greater than tiny are computed without packing
+	*/
+	template <typename T>
+	struct GemmBlocking
+	{
+		static constexpr size_t MR = 4;
+		static constexpr size_t NR = 4;
+		static constexpr size_t KC = 256;
+		static constexpr size_t MC = 64;
+		static constexpr size_t NC = 1024;
+		static constexpr size_t tiny = 16 * 16 * 16;
+	};
+
+	template <>
+	struct GemmBlocking<double>
+	{
+		static constexpr size_t MR = 4;
+		static constexpr size_t NR = 8;
+		static constexpr size_t KC = 256;
+		static constexpr size_t MC = 96;
+		static constexpr size_t NC = 2048;
+		static constexpr size_t tiny = 16 * 16 * 16;
+	};
+
+	template <>
+	struct GemmBlocking<float>
+	{
+		static constexpr size_t MR = 4;
+		static constexpr size_t NR = 16;
+		static constexpr size_t KC = 256;
+		static constexpr size_t MC = 128;
+		static constexpr size_t NC = 2048;
+		static constexpr size_t tiny = 16 * 16 * 16;
+	};
+
+	namespace detail
+	{
+		/**
+		* @brief Pack block mc*kc of A into row panels of height MR (k-major inside panel)
+		* @details Incomplete panels are padded with zeros
+		*/
+		template <typename T, size_t MR>
+		void packA(size_t mc, size_t kc, const T* A, size_t rs, size_t cs, T* Ap)
+		{
+			for (size_t i0 = 0; i0 < mc; i0 += MR)
+			{
+				const size_t mr = std::min(MR, mc - i0);
+				for (size_t k = 0; k < kc; ++k)
+				{
+					const T* a = A + i0 * rs + k * cs;
+					size_t i = 0;
+					for (; i < mr; ++i)
+					{
+						Ap[i] = a[i * rs];
+					}
+					for (; i < MR; ++i)
+					{
+						Ap[i] = T(0);
+					}
+					Ap += MR;
+				}
+			}
+		}
+
+		/**
+		* @brief Pack block kc*nc of B into column panels of width NR (k-major inside panel)
+		* @details Incomplete panels are padded with zeros
+		*/
+		template <typename T, size_t NR>
+		void packB(size_t kc, size_t nc, const T* B, size_t rs, size_t cs, T* Bp)
+		{
+			for (size_t j0 = 0; j0 < nc; j0 += NR)
+			{
+				const size_t nr = std::min(NR, nc - j0);
+				for (size_t k = 0; k < kc; ++k)
+				{
+					const T* b = B + k * rs + j0 * cs;
+					size_t j = 0;
+					if (cs == 1)
+					{
+						for (; j < nr; ++j)
+						{
+							Bp[j] = b[j];
+						}
+					}
+					else
+					{
+						for (; j < nr; ++j)
+						{
+							Bp[j] = b[j * cs];
+						}
+					}
+					for (; j < NR; ++j)
+					{
+						Bp[j] = T(0);
+					}
+					Bp += NR;
+				}
+			}
+		}
+
+		/**
+		* @brief Scalar micro-kernel: acc(MR*NR) = Ap(MR*kc) * Bp(kc*NR)
+		*/
+		template <typename T, size_t MR, size_t NR>
+		struct MicroKernel
+		{
+			static void run(size_t kc, const T* Ap, const T* Bp, T* acc)
+			{
+				T c[MR * NR] = {};
+				for (size_t k = 0; k < kc; ++k)
+				{
+					for (size_t i = 0; i < MR; ++i)
+					{
+						const T a = Ap[i];
+						for (size_t j = 0; j < NR; ++j)
+						{
+							c[i * NR + j] += a * Bp[j];
+						}
+					}
+					Ap += MR;
+					Bp += NR;
+				}
+				std::copy(c, c + MR * NR, acc);
+			}
+		};
+
+#ifdef MATH_GEMM_AVX2
+		static_assert(settings::alignment >= 32, "AVX2 micro-kernels need MATH_ALIGNMENT >= 32");
+
+		/**
+		* @brief AVX2/FMA micro-kernel 4x8 for double
+		* @details Panels of B and acc must be aligned to 32 bytes
+		*/
+		template <>
+		struct MicroKernel<double, 4, 8>
+		{
+			static void run(size_t kc, const double* Ap, const double* Bp, double* acc)
+			{
+				__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+				__m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+				__m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+				__m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+				for (size_t k = 0; k < kc; ++k)
+				{
+					const __m256d b0 = _mm256_load_pd(Bp);
+					const __m256d b1 = _mm256_load_pd(Bp + 4);
+					__m256d a = _mm256_broadcast_sd(Ap);
+					c00 = _mm256_fmadd_pd(a, b0, c00);
+					c01 = _mm256_fmadd_pd(a, b1, c01);
+					a = _mm256_broadcast_sd(Ap + 1);
+					c10 = _mm256_fmadd_pd(a, b0, c10);
+					c11 = _mm256_fmadd_pd(a, b1, c11);
+					a = _mm256_broadcast_sd(Ap + 2);
+					c20 = _mm256_fmadd_pd(a, b0, c20);
+					c21 = _mm256_fmadd_pd(a, b1, c21);
+					a = _mm256_broadcast_sd(Ap + 3);
+					c30 = _mm256_fmadd_pd(a, b0, c30);
+					c31 = _mm256_fmadd_pd(a, b1, c31);
+					Ap += 4;
+					Bp += 8;
+				}
+				_mm256_store_pd(acc, c00);
+				_mm256_store_pd(acc + 4, c01);
+				_mm256_store_pd(acc + 8, c10);
+				_mm256_store_pd(acc + 12, c11);
+				_mm256_store_pd(acc + 16, c20);
+				_mm256_store_pd(acc + 20, c21);
+				_mm256_store_pd(acc + 24, c30);
+				_mm256_store_pd(acc + 28, c31);
+			}
+		};
+
+		/**
+		* @brief AVX2/FMA micro-kernel 4x16 for float
+		* @details Panels of B and acc must be aligned to 32 bytes
+		*/
+		template <>
+		struct MicroKernel<float, 4, 16>
+		{
+			static void run(size_t kc, const float* Ap, const float* Bp, float* acc)
+			{
+				__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+				__m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+				__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+				__m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+				for (size_t k = 0; k < kc; ++k)
+				{
+					const __m256 b0 = _mm256_load_ps(Bp);
+					const __m256 b1 = _mm256_load_ps(Bp + 8);
+					__m256 a = _mm256_broadcast_ss(Ap);
+					c00 = _mm256_fmadd_ps(a, b0, c00);
+					c01 = _mm256_fmadd_ps(a, b1, c01);
+					a = _mm256_broadcast_ss(Ap + 1);
+					c10 = _mm256_fmadd_ps(a, b0, c10);
+					c11 = _mm256_fmadd_ps(a, b1, c11);
+					a = _mm256_broadcast_ss(Ap + 2);
+					c20 = _mm256_fmadd_ps(a, b0, c20);
+					c21 = _mm256_fmadd_ps(a, b1, c21);
+					a = _mm256_broadcast_ss(Ap + 3);
+					c30 = _mm256_fmadd_ps(a, b0, c30);
+					c31 = _mm256_fmadd_ps(a, b1, c31);
+					Ap += 4;
+					Bp += 16;
+				}
+				_mm256_store_ps(acc, c00);
+				_mm256_store_ps(acc + 8, c01);
+				_mm256_store_ps(acc + 16, c10);
+				_mm256_store_ps(acc + 24, c11);
+				_mm256_store_ps(acc + 32, c20);
+				_mm256_store_ps(acc + 40, c21);
+				_mm256_store_ps(acc + 48, c30);
+				_mm256_store_ps(acc + 56, c31);
+			}
+		};
+#endif
+
+		/**
+		* @brief Direct product for tiny matrices: C += alpha * A * B without packing
+		*/
+		template <typename T>
+		void gemmSmall(size_t M, size_t N, size_t K, T alpha,
+			const T* A, size_t a_rs, size_t a_cs,
+			const T* B, size_t b_rs, size_t b_cs,
+			T* C, size_t c_rs, size_t c_cs)
+		{
+			for (size_t i = 0; i < M; ++i)
+			{
+				T* c_i = C + i * c_rs;
+				for (size_t k = 0; k < K; ++k)
+				{
+					const T a_ik = alpha * A[i * a_rs + k * a_cs];
+					const T* b_k = B + k * b_rs;
+					for (size_t j = 0; j < N; ++j)
+					{
+						c_i[j * c_cs] += a_ik * b_k[j * b_cs];
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	* @brief General matrix multiplication @f$ \mathbf{C} = \alpha \mathbf{A} \mathbf{B} + \beta \mathbf{C} @f$
+	* @details Operands are described by pointer and strides, so any storage order (and transposed
+	* operands) can be passed without copying: element (i,j) of X is X[i * x_rs + j * x_cs].
+	* Products of tiny matrices are computed directly. Larger products are computed with cache
+	* blocking (NC, KC, MC) and packing of operands into contiguous panels, which are consumed by
+	* register-blocked micro-kernel MR*NR (AVX2/FMA when available, scalar otherwise).
+	* Column-oriented C is computed as transposed product, so every kernel works with row-oriented C.
+	* @param M, N, K: Dimensions (A is M*K, B is K*N, C is M*N)
+	*/
+	template <typename T>
+	void gemm(size_t M, size_t N, size_t K, T alpha,
+		const T* A, size_t a_rs, size_t a_cs,
+		const T* B, size_t b_rs, size_t b_cs,
+		T beta,
+		T* C, size_t c_rs, size_t c_cs)
+	{
+		typedef GemmBlocking<T> BS;
+		constexpr size_t MR = BS::MR;
+		constexpr size_t NR = BS::NR;
+
+		// column-oriented C: C^T = B^T * A^T is computed, so kernels write rows of C^T contiguously
+		if (c_rs < c_cs)
+		{
+			std::swap(M, N);
+			std::swap(A, B);
+			std::swap(a_rs, b_cs);
+			std::swap(a_cs, b_rs);
+			std::swap(c_rs, c_cs);
+		}
+
+		// C = beta * C
+		if (beta != T(1))
+		{
+			for (size_t i = 0; i < M; ++i)
+			{
+				for (size_t j = 0; j < N; ++j)
+				{
+					T& c = C[i * c_rs + j * c_cs];
+					c = (beta == T(0)) ? T(0) : beta * c;
+				}
+			}
+		}
+		if (M == 0 || N == 0 || K == 0 || alpha == T(0))
+		{
+			return;
+		}
+
+		if (M * N * K <= BS::tiny)
+		{
+			detail::gemmSmall(M, N, K, alpha, A, a_rs, a_cs, B, b_rs, b_cs, C, c_rs, c_cs);
+			return;
+		}
+
+		const size_t kc_max = std::min(BS::KC, K);
+		const size_t mc_max = std::min(BS::MC, M);
+		const size_t nc_max = std::min(BS::NC, N);
+		// packed panels are aligned, so micro-kernel loads panels of B by aligned loads
+		AlignedBuffer<T> Ap(((mc_max + MR - 1) / MR) * MR * kc_max);
+		AlignedBuffer<T> Bp(((nc_max + NR - 1) / NR) * NR * kc_max);
+		alignas(64) T acc[MR * NR];
+
+		for (size_t jc = 0; jc < N; jc += BS::NC)
+		{
+			const size_t nc = std::min(BS::NC, N - jc);
+			for (size_t pc = 0; pc < K; pc += BS::KC)
+			{
+				const size_t kc = std::min(BS::KC, K - pc);
+				detail::packB<T, NR>(kc, nc, B + pc * b_rs + jc * b_cs, b_rs, b_cs, Bp.data());
+
+				for (size_t ic = 0; ic < M; ic += BS::MC)
+				{
+					const size_t mc = std::min(BS::MC, M - ic);
+					detail::packA<T, MR>(mc, kc, A + ic * a_rs + pc * a_cs, a_rs, a_cs, Ap.data());
+
+					for (size_t jr = 0; jr < nc; jr += NR)
+					{
+						const size_t nr = std::min(NR, nc - jr);
+						const T* bp = Bp.data() + jr * kc;
+						for (size_t ir = 0; ir < mc; ir += MR)
+						{
+							const size_t mr = std::min(MR, mc - ir);
+							detail::MicroKernel<T, MR, NR>::run(kc, Ap.data() + ir * kc, bp, acc);
+
+							T* c = C + (ic + ir) * c_rs + (jc + jr) * c_cs;
+							for (size_t i = 0; i < mr; ++i)
+							{
+								for (size_t j = 0; j < nr; ++j)
+								{
+									c[i * c_rs + j * c_cs] += alpha * acc[i * NR + j];
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
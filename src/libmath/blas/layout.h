@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+
+namespace math::blas
+{
+	/**
+	* @brief Compile-time storage order of dense matrix: row by row
+	* @details Kernels templated on layout tag (RowMajor or ColMajor) have separate loop nests
+	* for both orders, so inner loops always walk contiguous memory and element index
+	* isn't recomputed from linear position. Element (i,j) is a[index(i, j, ld)].
+	*/
+	struct RowMajor
+	{
+		static constexpr bool rowMajor = true;
+
+		static constexpr size_t index(size_t i, size_t j, size_t ld)
+		{
+			return i * ld + j;
+		}
+
+		static constexpr size_t rowStride(size_t ld)
+		{
+			return ld;
+		}
+
+		static constexpr size_t colStride(size_t /*ld*/)
+		{
+			return 1;
+		}
+	};
+
+	/**
+	* @brief Compile-time storage order of dense matrix: column by column
+	* @see RowMajor
+	*/
+	struct ColMajor
+	{
+		static constexpr bool rowMajor = false;
+
+		static constexpr size_t index(size_t i, size_t j, size_t ld)
+		{
+			return i + j * ld;
+		}
+
+		static constexpr size_t rowStride(size_t /*ld*/)
+		{
+			return 1;
+		}
+
+		static constexpr size_t colStride(size_t ld)
+		{
+			return ld;
+		}
+	};
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace math::blas
+{
+	/**
+	* @defgroup Level1 BLAS level 1 kernels
+	* @{
+	* @brief Vector-vector operations on raw storage
+	* @details Vectors are described by pointer and increment: element i of x is x[i * incx].
+	*/
+
+	/**
+	* @brief Inner product @f$ \mathbf{x}^T \mathbf{y} @f$
+	* @param n: Number of elements
+	*/
+	template <typename T>
+	T dot(size_t n, const T* x, size_t incx, const T* y, size_t incy)
+	{
+		T s0 = T(0), s1 = T(0), s2 = T(0), s3 = T(0);
+		size_t i = 0;
+		if (incx == 1 && incy == 1)
+		{
+			for (; i + 4 <= n; i += 4)
+			{
+				s0 += x[i] * y[i];
+				s1 += x[i + 1] * y[i + 1];
+				s2 += x[i + 2] * y[i + 2];
+				s3 += x[i + 3] * y[i + 3];
+			}
+			for (; i < n; ++i)
+			{
+				s0 += x[i] * y[i];
+			}
+		}
+		else
+		{
+			for (; i < n; ++i)
+			{
+				s0 += x[i * incx] * y[i * incy];
+			}
+		}
+		return (s0 + s1) + (s2 + s3);
+	}
+
+	/**
+	* @brief @f$ \mathbf{y} = \alpha \mathbf{x} + \mathbf{y} @f$
+	*/
+	template <typename T>
+	void axpy(size_t n, T alpha, const T* x, size_t incx, T* y, size_t incy)
+	{
+		if (incx == 1 && incy == 1)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				y[i] += alpha * x[i];
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				y[i * incy] += alpha * x[i * incx];
+			}
+		}
+	}
+
+	/**
+	* @brief @f$ \mathbf{x} = \alpha \mathbf{x} @f$
+	*/
+	template <typename T>
+	void scal(size_t n, T alpha, T* x, size_t incx)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			x[i * incx] *= alpha;
+		}
+	}
+
+	/**
+	* @brief @f$ \mathbf{y} = \mathbf{x} @f$
+	*/
+	template <typename T>
+	void copy(size_t n, const T* x, size_t incx, T* y, size_t incy)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			y[i * incy] = x[i * incx];
+		}
+	}
+
+	namespace detail
+	{
+		/// @brief Integer power of 2 in constant expressions
+		template <typename T>
+		constexpr T pow2(int e)
+		{
+			T p = T(1);
+			for (; e > 0; --e)
+			{
+				p *= T(2);
+			}
+			for (; e < 0; ++e)
+			{
+				p /= T(2);
+			}
+			return p;
+		}
+
+		/// @brief floor(a / 2) for negative a too
+		constexpr int halfFloor(int a)
+		{
+			return a >= 0 ? a / 2 : -((1 - a) / 2);
+		}
+
+		/// @brief ceil(a / 2) for negative a too
+		constexpr int halfCeil(int a)
+		{
+			return -halfFloor(-a);
+		}
+	}
+
+	/**
+	* @brief Euclidean norm @f$ \|\mathbf{x}\|_2 @f$ without overflow and underflow
+	* @details If plain sum of squares neither overflows nor underflows (the common case), norm is its root.
+	* Otherwise norm is computed by Blue's algorithm (as in LAPACK dnrm2): squares of big, small and medium
+	* elements are accumulated separately, big and small elements scaled by powers of 2, so the result
+	* is accurate for every x, whose norm is representable.
+	*/
+	template <typename T>
+	T nrm2(size_t n, const T* x, size_t incx)
+	{
+		typedef std::numeric_limits<T> limits;
+		const T ssq = dot(n, x, incx, x, incx);
+		// every square, which underflows, loses less than min(), so their sum is below epsilon of ssq
+		if (ssq <= limits::max() && ssq >= static_cast<T>(n) * (limits::min() / limits::epsilon()))
+		{
+			return std::sqrt(ssq);
+		}
+
+		// Blue's thresholds and scaling constants
+		constexpr T tsml = detail::pow2<T>(detail::halfCeil(limits::min_exponent - 1));
+		constexpr T tbig = detail::pow2<T>(detail::halfFloor(limits::max_exponent - limits::digits + 1));
+		constexpr T ssml = detail::pow2<T>(-detail::halfFloor(limits::min_exponent - limits::digits));
+		constexpr T sbig = detail::pow2<T>(-detail::halfCeil(limits::max_exponent + limits::digits - 1));
+
+		T asml = T(0), amed = T(0), abig = T(0);
+		for (size_t i = 0; i < n; ++i)
+		{
+			const T a = std::abs(x[i * incx]);
+			if (a > tbig)
+			{
+				abig += (a * sbig) * (a * sbig);
+			}
+			else if (a < tsml)
+			{
+				// small elements don't matter, if there are big ones
+				if (abig == T(0))
+				{
+					asml += (a * ssml) * (a * ssml);
+				}
+			}
+			else
+			{
+				// NaN goes here and propagates to the result
+				amed += a * a;
+			}
+		}
+
+		if (abig > T(0))
+		{
+			// medium elements are scaled down to big ones, small ones are negligible
+			if (amed > T(0) || amed != amed)
+			{
+				abig += (amed * sbig) * sbig;
+			}
+			return std::sqrt(abig) / sbig;
+		}
+		if (asml > T(0))
+		{
+			if (amed > T(0) || amed != amed)
+			{
+				const T ymed = std::sqrt(amed);
+				const T ysml = std::sqrt(asml) / ssml;
+				const T ymax = std::max(ymed, ysml);
+				const T ymin = std::min(ymed, ysml);
+				const T ratio = ymin / ymax;
+				return ymax * std::sqrt(T(1) + ratio * ratio);
+			}
+			return std::sqrt(asml) / ssml;
+		}
+		return std::sqrt(amed);
+	}
+
+	/**
+	* @brief Sum of absolute values @f$ \|\mathbf{x}\|_1 @f$
+	*/
+	template <typename T>
+	T nrm1(size_t n, const T* x, size_t incx)
+	{
+		T s = T(0);
+		for (size_t i = 0; i < n; ++i)
+		{
+			s += std::abs(x[i * incx]);
+		}
+		return s;
+	}
+
+	/**
+	* @brief Maximum absolute value @f$ \|\mathbf{x}\|_\infty @f$
+	*/
+	template <typename T>
+	T nrmInf(size_t n, const T* x, size_t incx)
+	{
+		T s = T(0);
+		for (size_t i = 0; i < n; ++i)
+		{
+			const T a = std::abs(x[i * incx]);
+			if (a > s)
+			{
+				s = a;
+			}
+		}
+		return s;
+	}
+
+	/**
+	* @}
+	*/
+}
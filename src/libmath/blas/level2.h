@@ -0,0 +1,49 @@
+#pragma once
+
+#include <libmath/blas/level1.h>
+
+#include <cstddef>
+
+namespace math::blas
+{
+	/**
+	* @brief Matrix-vector product @f$ \mathbf{y} = \alpha \mathbf{A} \mathbf{x} + \beta \mathbf{y} @f$
+	* @details Matrix A of size M*N is described by pointer and strides: element (i,j) is A[i * rs + j * cs].
+	* Rows of row-oriented matrices are processed by dot products, columns of column-oriented
+	* matrices - by axpy, so A is always read with unit stride.
+	*/
+	template <typename T>
+	void gemv(size_t M, size_t N, T alpha,
+		const T* A, size_t rs, size_t cs,
+		const T* x, size_t incx,
+		T beta,
+		T* y, size_t incy)
+	{
+		if (beta != T(1))
+		{
+			for (size_t i = 0; i < M; ++i)
+			{
+				T& yi = y[i * incy];
+				yi = (beta == T(0)) ? T(0) : beta * yi;
+			}
+		}
+		if (alpha == T(0))
+		{
+			return;
+		}
+		if (cs == 1 || rs != 1)
+		{
+			for (size_t i = 0; i < M; ++i)
+			{
+				y[i * incy] += alpha * dot(N, A + i * rs, cs, x, incx);
+			}
+		}
+		else
+		{
+			for (size_t j = 0; j < N; ++j)
+			{
+				axpy(M, alpha * x[j * incx], A + j * cs, rs, y, incy);
+			}
+		}
+	}
+}
@@ -0,0 +1,402 @@
+#pragma once
+
+#include <libmath/blas/level1.h>
+#include <libmath/blas/gemm.h>
+#include <libmath/blas/layout.h>
+#include <libmath/math_settings.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace math::blas
+{
+	/// @brief Width of panels of blocked LU factorization
+	constexpr size_t luBlock = 32;
+
+	/// @brief Width of block columns of trailing matrix updated by one task in parallel LU (multiple of luBlock)
+	constexpr size_t luTaskColumns = 4 * luBlock;
+
+	namespace detail
+	{
+		/**
+		* @brief Factorize panel a(k0:n, k0:k1) of getrf, pivot rows are swapped in columns [s0, s1)
+		* @details Rows are updated by axpy along rows (RowMajor) or columns along columns (ColMajor).
+		*/
+		template <typename L, typename T>
+		void luPanel(size_t n, T* a, size_t lda, size_t k0, size_t k1, size_t* ipiv, size_t& info, size_t s0, size_t s1)
+		{
+			const size_t rs = L::rowStride(lda);
+			const size_t cs = L::colStride(lda);
+			for (size_t k = k0; k < k1; ++k)
+			{
+				size_t p = k;
+				T pmax = std::abs(a[k * rs + k * cs]);
+				for (size_t i = k + 1; i < n; ++i)
+				{
+					T v = std::abs(a[i * rs + k * cs]);
+					if (v > pmax)
+					{
+						pmax = v;
+						p = i;
+					}
+				}
+				ipiv[k] = p;
+				if (pmax == T(0))
+				{
+					if (info == 0)
+					{
+						info = k + 1;
+					}
+					continue;
+				}
+				if constexpr (L::rowMajor)
+				{
+					if (p != k)
+					{
+						std::swap_ranges(a + k * lda + s0, a + k * lda + s1, a + p * lda + s0);
+					}
+					const T inv = T(1) / a[k * lda + k];
+					for (size_t i = k + 1; i < n; ++i)
+					{
+						T& lik = a[i * lda + k];
+						lik *= inv;
+						axpy(k1 - k - 1, -lik, a + k * lda + k + 1, 1, a + i * lda + k + 1, 1);
+					}
+				}
+				else
+				{
+					if (p != k)
+					{
+						for (size_t j = s0; j < s1; ++j)
+						{
+							std::swap(a[k + j * lda], a[p + j * lda]);
+						}
+					}
+					T* l = a + k * lda + k + 1;
+					scal(n - k - 1, T(1) / a[k * lda + k], l, 1);
+					for (size_t j = k + 1; j < k1; ++j)
+					{
+						axpy(n - k - 1, -a[k + j * lda], l, 1, a + j * lda + k + 1, 1);
+					}
+				}
+			}
+		}
+
+		/**
+		* @brief Apply row swaps ipiv[k0:k1] of panel to columns [j0, j1)
+		*/
+		template <typename L, typename T>
+		void luSwap(T* a, size_t lda, size_t k0, size_t k1, const size_t* ipiv, size_t j0, size_t j1)
+		{
+			for (size_t k = k0; k < k1; ++k)
+			{
+				const size_t p = ipiv[k];
+				if (p == k)
+				{
+					continue;
+				}
+				if constexpr (L::rowMajor)
+				{
+					std::swap_ranges(a + k * lda + j0, a + k * lda + j1, a + p * lda + j0);
+				}
+				else
+				{
+					for (size_t j = j0; j < j1; ++j)
+					{
+						std::swap(a[k + j * lda], a[p + j * lda]);
+					}
+				}
+			}
+		}
+
+		/**
+		* @brief Block row of U of getrf: U12 = L11^-1 * A12 in columns [j0, j1), L11 = a(k0:k1, k0:k1)
+		*/
+		template <typename L, typename T>
+		void luRowU(T* a, size_t lda, size_t k0, size_t k1, size_t j0, size_t j1)
+		{
+			if constexpr (L::rowMajor)
+			{
+				for (size_t k = k0; k < k1; ++k)
+				{
+					for (size_t i = k + 1; i < k1; ++i)
+					{
+						axpy(j1 - j0, -a[i * lda + k], a + k * lda + j0, 1, a + i * lda + j0, 1);
+					}
+				}
+			}
+			else
+			{
+				for (size_t j = j0; j < j1; ++j)
+				{
+					for (size_t k = k0; k < k1; ++k)
+					{
+						axpy(k1 - k - 1, -a[k + j * lda], a + k * lda + k + 1, 1, a + j * lda + k + 1, 1);
+					}
+				}
+			}
+		}
+
+		/**
+		* @brief Update of columns [j0, j1) of trailing matrix of getrf after panel a(k0:n, k0:k1)
+		* @details Pivot rows of panel are swapped, block row of U is computed and A22 = A22 - L21 * U12 by gemm.
+		*/
+		template <typename L, typename T>
+		void luUpdate(size_t n, T* a, size_t lda, size_t k0, size_t k1, const size_t* ipiv, size_t j0, size_t j1)
+		{
+			const size_t rs = L::rowStride(lda);
+			const size_t cs = L::colStride(lda);
+			luSwap<L>(a, lda, k0, k1, ipiv, j0, j1);
+			luRowU<L>(a, lda, k0, k1, j0, j1);
+			gemm(n - k1, j1 - j0, k1 - k0, T(-1),
+				a + k1 * rs + k0 * cs, rs, cs,
+				a + k0 * rs + j0 * cs, rs, cs,
+				T(1),
+				a + k1 * rs + j0 * cs, rs, cs);
+		}
+
+		/**
+		* @brief Task-parallel getrf on threads (see getrf)
+		* @details Panel factorization and updates of trailing matrix are OpenMP tasks with dependencies on
+		* block columns of luBlock width. Update of the next panel's block column by panel k is a separate task
+		* (look-ahead), so the next panel waits only for it and for panel k, while the rest of trailing matrix
+		* is updated by tasks of up to luTaskColumns columns (aligned to luTaskColumns). Pivot rows are swapped
+		* only in the panel and in trailing columns, swaps in already factorized columns are applied at the end.
+		*/
+		template <typename L, typename T>
+		size_t getrfTasks(size_t n, T* a, size_t lda, size_t* ipiv, int threads)
+		{
+			static_assert(luTaskColumns == 4 * luBlock, "getrfTasks: update task lists dependencies of 4 block columns");
+			size_t info = 0;
+			const std::ptrdiff_t panels = static_cast<std::ptrdiff_t>((n + luBlock - 1) / luBlock);
+			// dependency objects of block columns
+			std::vector<char> columns(panels);
+			char* dep = columns.data();
+			const size_t group = luTaskColumns / luBlock;
+
+			MATH_OMP(parallel num_threads(threads))
+			{
+				MATH_OMP(single)
+				{
+					for (std::ptrdiff_t kb = 0; kb < panels; ++kb)
+					{
+						const size_t k0 = kb * luBlock;
+						const size_t k1 = std::min(n, k0 + luBlock);
+						MATH_OMP(task depend(inout: dep[kb]) shared(info))
+						luPanel<L>(n, a, lda, k0, k1, ipiv, info, k0, k1);
+
+						// look-ahead: block column of the next panel, then the rest by groups of block columns
+						for (size_t b0 = kb + 1; b0 < static_cast<size_t>(panels);)
+						{
+							const size_t b1 = b0 == static_cast<size_t>(kb) + 1 ?
+								b0 + 1 : std::min(static_cast<size_t>(panels), (b0 / group + 1) * group);
+							const size_t j0 = b0 * luBlock;
+							const size_t j1 = std::min(n, b1 * luBlock);
+							// dependencies of block columns [b0, b1), repeated for narrower tasks
+							MATH_OMP(task depend(in: dep[kb]) depend(inout: dep[b0], dep[std::min(b0 + 1, b1 - 1)], \
+								dep[std::min(b0 + 2, b1 - 1)], dep[std::min(b0 + 3, b1 - 1)]))
+							luUpdate<L>(n, a, lda, k0, k1, ipiv, j0, j1);
+							b0 = b1;
+						}
+					}
+				}
+
+				// swaps of later panels in factorized columns
+				MATH_OMP(for schedule(static))
+				for (std::ptrdiff_t jb = 0; jb < panels; ++jb)
+				{
+					const size_t j0 = jb * luBlock;
+					const size_t j1 = std::min(n, j0 + luBlock);
+					luSwap<L>(a, lda, j1, n, ipiv, j0, j1);
+				}
+			}
+			return info;
+		}
+	}
+
+	/**
+	* @brief LU factorization with partial pivoting @f$ \mathbf{P} \mathbf{A} = \mathbf{L} \mathbf{U} @f$
+	* @details Blocked right-looking algorithm for matrix n*n with leading dimension lda, stored in order L
+	* (RowMajor by default or ColMajor). Panel of luBlock columns is factorized, block row of U is computed by
+	* forward substitution and trailing matrix is updated by gemm. Panel and block row loops are specialized
+	* for the layout: rows are updated by axpy along rows (RowMajor) or columns along columns (ColMajor).
+	* On exit a contains U in upper triangle and L (without unit diagonal) in lower triangle.
+	* In OpenMP builds with threads > 1 panels and updates of trailing block columns run as tasks
+	* (see detail::getrfTasks): pivots and factors agree with sequential algorithm up to rounding (trailing
+	* matrix is updated by block columns, so sums are accumulated in different order).
+	* @param ipiv[out]: n pivot indices, row k was swapped with row ipiv[k] on step k
+	* @param threads: Number of threads (OpenMP builds)
+	* @return 0 on success, k + 1 if U(k,k) is exactly zero (factorization is completed anyway)
+	*/
+	template <typename L = RowMajor, typename T>
+	size_t getrf(size_t n, T* a, size_t lda, size_t* ipiv, int threads = 1)
+	{
+#ifdef _OPENMP
+		if (threads > 1 && n > 2 * luBlock)
+		{
+			return detail::getrfTasks<L>(n, a, lda, ipiv, threads);
+		}
+#else
+		(void)threads;
+#endif
+		const size_t rs = L::rowStride(lda);
+		const size_t cs = L::colStride(lda);
+		size_t info = 0;
+		for (size_t k0 = 0; k0 < n; k0 += luBlock)
+		{
+			const size_t k1 = std::min(n, k0 + luBlock);
+			detail::luPanel<L>(n, a, lda, k0, k1, ipiv, info, 0, n);
+			if (k1 == n)
+			{
+				break;
+			}
+			detail::luRowU<L>(a, lda, k0, k1, k1, n);
+			// A22 = A22 - L21 * U12
+			gemm(n - k1, n - k1, k1 - k0, T(-1),
+				a + k1 * rs + k0 * cs, rs, cs,
+				a + k0 * rs + k1 * cs, rs, cs,
+				T(1),
+				a + k1 * rs + k1 * cs, rs, cs);
+		}
+		return info;
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{A}^T \mathbf{x} = \mathbf{b} @f$ in place using factorization from getrf
+	* @details @f$ \mathbf{A}^T = \mathbf{U}^T \mathbf{L}^T \mathbf{P} @f$: substitutions with U^T and unit L^T,
+	* then pivots are applied in reverse order. Rows of factors are used by axpy (RowMajor) or columns by dot
+	* products (ColMajor), so factors are read contiguously in both layouts.
+	*/
+	template <typename L = RowMajor, typename T>
+	void getrsT(size_t n, const T* a, size_t lda, const size_t* ipiv, T* b, size_t incb)
+	{
+		if constexpr (L::rowMajor)
+		{
+			// U^T * y = b: row k of U is column k of U^T
+			for (size_t k = 0; k < n; ++k)
+			{
+				b[k * incb] /= a[k * lda + k];
+				axpy(n - k - 1, -b[k * incb], a + k * lda + k + 1, 1, b + (k + 1) * incb, incb);
+			}
+			// L^T * x = y
+			for (size_t k = n; k-- > 0;)
+			{
+				axpy(k, -b[k * incb], a + k * lda, 1, b, incb);
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				b[i * incb] = (b[i * incb] - dot(i, a + i * lda, 1, b, incb)) / a[i * lda + i];
+			}
+			for (size_t i = n; i-- > 0;)
+			{
+				b[i * incb] -= dot(n - i - 1, a + i * lda + i + 1, 1, b + (i + 1) * incb, incb);
+			}
+		}
+		// x = P^T * x
+		for (size_t k = n; k-- > 0;)
+		{
+			if (ipiv[k] != k)
+			{
+				std::swap(b[k * incb], b[ipiv[k] * incb]);
+			}
+		}
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$ in place using factorization from getrf
+	* @details Factorization is stored in order L (the same as in getrf). B of size n*nrhs is described by
+	* pointer and strides. Single right-hand side is processed with dot products along rows of factors
+	* (RowMajor) or with axpy along columns (ColMajor). Several right-hand sides are processed by blocks of
+	* luBlock rows: contribution of already solved rows is subtracted by gemm.
+	*/
+	template <typename L = RowMajor, typename T>
+	void getrs(size_t n, const T* a, size_t lda, const size_t* ipiv,
+		size_t nrhs, T* b, size_t b_rs, size_t b_cs)
+	{
+		const size_t rs = L::rowStride(lda);
+		const size_t cs = L::colStride(lda);
+
+		// B = P * B
+		for (size_t k = 0; k < n; ++k)
+		{
+			if (ipiv[k] != k)
+			{
+				for (size_t j = 0; j < nrhs; ++j)
+				{
+					std::swap(b[k * b_rs + j * b_cs], b[ipiv[k] * b_rs + j * b_cs]);
+				}
+			}
+		}
+
+		if (nrhs == 1)
+		{
+			if constexpr (L::rowMajor)
+			{
+				for (size_t i = 0; i < n; ++i)
+				{
+					b[i * b_rs] -= dot(i, a + i * lda, 1, b, b_rs);
+				}
+				for (size_t i = n; i-- > 0;)
+				{
+					b[i * b_rs] = (b[i * b_rs] - dot(n - i - 1, a + i * lda + i + 1, 1, b + (i + 1) * b_rs, b_rs)) /
+						a[i * lda + i];
+				}
+			}
+			else
+			{
+				for (size_t k = 0; k + 1 < n; ++k)
+				{
+					axpy(n - k - 1, -b[k * b_rs], a + k * lda + k + 1, 1, b + (k + 1) * b_rs, b_rs);
+				}
+				for (size_t k = n; k-- > 0;)
+				{
+					b[k * b_rs] /= a[k * lda + k];
+					axpy(k, -b[k * b_rs], a + k * lda, 1, b, b_rs);
+				}
+			}
+			return;
+		}
+
+		// B = L^-1 * B by blocks of rows: off-diagonal blocks by gemm, diagonal blocks by axpy
+		for (size_t i0 = 0; i0 < n; i0 += luBlock)
+		{
+			const size_t i1 = std::min(n, i0 + luBlock);
+			gemm(i1 - i0, nrhs, i0, T(-1),
+				a + i0 * rs, rs, cs,
+				b, b_rs, b_cs,
+				T(1),
+				b + i0 * b_rs, b_rs, b_cs);
+			for (size_t i = i0; i < i1; ++i)
+			{
+				for (size_t k = i0; k < i; ++k)
+				{
+					axpy(nrhs, -a[i * rs + k * cs], b + k * b_rs, b_cs, b + i * b_rs, b_cs);
+				}
+			}
+		}
+		// B = U^-1 * B
+		for (size_t i1 = n; i1 > 0;)
+		{
+			const size_t i0 = (i1 > luBlock) ? i1 - luBlock : 0;
+			gemm(i1 - i0, nrhs, n - i1, T(-1),
+				a + i0 * rs + i1 * cs, rs, cs,
+				b + i1 * b_rs, b_rs, b_cs,
+				T(1),
+				b + i0 * b_rs, b_rs, b_cs);
+			for (size_t i = i1; i-- > i0;)
+			{
+				for (size_t k = i + 1; k < i1; ++k)
+				{
+					axpy(nrhs, -a[i * rs + k * cs], b + k * b_rs, b_cs, b + i * b_rs, b_cs);
+				}
+				scal(nrhs, T(1) / a[i * rs + i * cs], b + i * b_rs, b_cs);
+			}
+			i1 = i0;
+		}
+	}
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <libmath/blas/level1.h>
+
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Stored triangle of triangular or symmetric matrix
+	*/
+	enum class Uplo
+	{
+		Lower = 0,
+		Upper
+	};
+}
+
+namespace math::blas
+{
+	/**
+	* @defgroup PackedStorage Packed storage of triangular matrices
+	* @{
+	* @brief Triangle of matrix n*n is stored row by row in n*(n+1)/2 elements:
+	*	- lower: element (i,j), j <= i, is ap[packedRow(i) + j]
+	*	- upper: element (i,j), j >= i, is ap[packedRowUpper(n, i) + j - i]
+	* Every stored part of a row is contiguous, so kernels read packed storage with unit stride.
+	*/
+
+	/// @brief Height of row panels of blocked kernels on packed storage
+	constexpr size_t packedBlock = 64;
+
+	/// @brief Size of packed storage of triangle n*n
+	constexpr size_t packedSize(size_t n)
+	{
+		return n * (n + 1) / 2;
+	}
+
+	/// @brief Position of row i in packed lower triangle
+	constexpr size_t packedRow(size_t i)
+	{
+		return i * (i + 1) / 2;
+	}
+
+	/// @brief Position of diagonal element of row i in packed upper triangle n*n
+	constexpr size_t packedRowUpper(size_t n, size_t i)
+	{
+		return i * n - i * (i - 1) / 2;
+	}
+
+	/// @brief Position of element (i,j) of stored triangle
+	constexpr size_t packedIndex(Uplo uplo, size_t n, size_t i, size_t j)
+	{
+		return uplo == Uplo::Lower ? packedRow(i) + j : packedRowUpper(n, i) + j - i;
+	}
+
+	/**
+	* @brief Product of symmetric matrix in packed lower storage and vector @f$ \mathbf{y} = \alpha \mathbf{A} \mathbf{x} + \beta \mathbf{y} @f$
+	* @details Row i of lower triangle is used twice: as row i (dot) and as column i of upper triangle (axpy)
+	*/
+	template <typename T>
+	void spmv(size_t n, T alpha, const T* ap, const T* x, size_t incx, T beta, T* y, size_t incy)
+	{
+		if (beta != T(1))
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				T& yi = y[i * incy];
+				yi = (beta == T(0)) ? T(0) : beta * yi;
+			}
+		}
+		if (alpha == T(0))
+		{
+			return;
+		}
+		for (size_t i = 0; i < n; ++i)
+		{
+			const T* ai = ap + packedRow(i);
+			y[i * incy] += alpha * dot(i + 1, ai, 1, x, incx);
+			axpy(i, alpha * x[i * incx], ai, 1, y, incy);
+		}
+	}
+
+	/**
+	* @brief In-place product of triangular matrix in packed storage and vector @f$ \mathbf{x} = \mathbf{A} \mathbf{x} @f$
+	*/
+	template <typename T>
+	void tpmv(Uplo uplo, size_t n, const T* ap, T* x, size_t incx)
+	{
+		if (uplo == Uplo::Lower)
+		{
+			// x(0:i) is still unchanged, when row i is processed
+			for (size_t i = n; i-- > 0;)
+			{
+				x[i * incx] = dot(i + 1, ap + packedRow(i), 1, x, incx);
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				x[i * incx] = dot(n - i, ap + packedRowUpper(n, i), 1, x + i * incx, incx);
+			}
+		}
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{A} \mathbf{x} = \mathbf{b} @f$ in place with triangular matrix in packed storage
+	* @details Diagonal of A must be non-zero
+	*/
+	template <typename T>
+	void tpsv(Uplo uplo, size_t n, const T* ap, T* x, size_t incx)
+	{
+		if (uplo == Uplo::Lower)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				const T* ai = ap + packedRow(i);
+				x[i * incx] = (x[i * incx] - dot(i, ai, 1, x, incx)) / ai[i];
+			}
+		}
+		else
+		{
+			for (size_t i = n; i-- > 0;)
+			{
+				const T* ai = ap + packedRowUpper(n, i);
+				x[i * incx] = (x[i * incx] - dot(n - i - 1, ai + 1, 1, x + (i + 1) * incx, incx)) / ai[0];
+			}
+		}
+	}
+
+	/**
+	* @}
+	*/
+}
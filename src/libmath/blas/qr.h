@@ -0,0 +1,231 @@
+#pragma once
+
+#include <libmath/blas/level1.h>
+#include <libmath/blas/gemm.h>
+#include <libmath/blas/layout.h>
+#include <libmath/memory_resource.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace math::blas
+{
+	/// @brief Width of panels (number of reflectors in block reflector) of blocked QR factorization
+	constexpr size_t qrBlock = 32;
+
+	/// @brief Size of storage of triangular factors of block reflectors of geqrf for k reflectors
+	constexpr size_t qrFactorSize(size_t k)
+	{
+		return qrBlock * k;
+	}
+
+	namespace detail
+	{
+		/**
+		* @brief Copy Householder vectors of block a(j0:m, j0:j0+ib) to v (m-j0)*ib (row by row) with unit diagonal and zeros above it
+		*/
+		template <typename T>
+		void qrCopyV(size_t m, const T* a, size_t rs, size_t cs, size_t j0, size_t ib, T* v)
+		{
+			for (size_t i = j0; i < m; ++i)
+			{
+				T* vi = v + (i - j0) * ib;
+				for (size_t j = 0; j < ib; ++j)
+				{
+					const size_t col = j0 + j;
+					vi[j] = i > col ? a[i * rs + col * cs] : (i == col ? T(1) : T(0));
+				}
+			}
+		}
+
+		/**
+		* @brief Apply block reflector @f$ \mathbf{H} = \mathbf{I} - \mathbf{V} \mathbf{T} \mathbf{V}^T @f$ or its transpose
+		* to C mv*nc from the left
+		* @param v: Vectors mv*ib row by row (see qrCopyV)
+		* @param t: Upper triangular factor ib*ib row by row
+		* @param work: Buffer of 2*ib*nc elements
+		*/
+		template <typename T>
+		void qrApplyBlock(bool transpose, size_t mv, size_t ib, const T* v, const T* t,
+			size_t nc, T* c, size_t c_rs, size_t c_cs, T* work)
+		{
+			if (nc == 0)
+			{
+				return;
+			}
+			T* w = work;
+			T* tw = work + ib * nc;
+			// W = V^T * C
+			gemm(ib, nc, mv, T(1), v, size_t(1), ib, c, c_rs, c_cs, T(0), w, nc, size_t(1));
+			// W = T * W or T^T * W
+			if (transpose)
+			{
+				gemm(ib, nc, ib, T(1), t, size_t(1), ib, w, nc, size_t(1), T(0), tw, nc, size_t(1));
+			}
+			else
+			{
+				gemm(ib, nc, ib, T(1), t, ib, size_t(1), w, nc, size_t(1), T(0), tw, nc, size_t(1));
+			}
+			// C = C - V * W
+			gemm(mv, nc, ib, T(-1), v, ib, size_t(1), tw, nc, size_t(1), T(1), c, c_rs, c_cs);
+		}
+	}
+
+	/**
+	* @brief Householder QR factorization @f$ \mathbf{A} = \mathbf{Q} \mathbf{R} @f$
+	* @details Blocked algorithm for matrix m*n with leading dimension lda, stored in order L (RowMajor by default
+	* or ColMajor). Panel of qrBlock columns is factorized by Householder reflectors
+	* @f$ \mathbf{H}_k = \mathbf{I} - \tau_k \mathbf{v}_k \mathbf{v}_k^T @f$, which are accumulated to block reflector
+	* @f$ \mathbf{I} - \mathbf{V} \mathbf{T} \mathbf{V}^T @f$ (compact WY form), trailing matrix is updated by gemm.
+	* On exit a contains R in upper triangle and vectors v_k (without unit element) below diagonal.
+	* @param t[out]: qrFactorSize(min(m, n)) elements, upper triangular factor T ib*ib (row by row) of block reflector
+	* of columns j0:j0+ib is stored from t + j0 * qrBlock, diagonal of T contains tau
+	*/
+	template <typename L = RowMajor, typename T>
+	void geqrf(size_t m, size_t n, T* a, size_t lda, T* t)
+	{
+		const size_t rs = L::rowStride(lda);
+		const size_t cs = L::colStride(lda);
+		const size_t k = std::min(m, n);
+		if (k == 0)
+		{
+			return;
+		}
+		AlignedBuffer<T> v(m * qrBlock);
+		AlignedBuffer<T> work(2 * qrBlock * n);
+
+		for (size_t j0 = 0; j0 < k; j0 += qrBlock)
+		{
+			const size_t ib = std::min(qrBlock, k - j0);
+			T* tb = t + j0 * qrBlock;
+
+			// panel a(j0:m, j0:j0+ib) by reflectors
+			for (size_t j = j0; j < j0 + ib; ++j)
+			{
+				T* x = a + j * rs + j * cs;
+				const T alpha = *x;
+				const T xnorm = nrm2(m - j - 1, x + rs, rs);
+				T tau = T(0);
+				if (xnorm != T(0))
+				{
+					const T beta = -std::copysign(std::hypot(alpha, xnorm), alpha);
+					tau = (beta - alpha) / beta;
+					scal(m - j - 1, T(1) / (alpha - beta), x + rs, rs);
+					*x = beta;
+
+					// H_j * a(j:m, j+1:j0+ib), w = v^T * a
+					const size_t nc = j0 + ib - j - 1;
+					T* w = work.data();
+					T* c = x + cs;
+					copy(nc, c, cs, w, size_t(1));
+					if constexpr (L::rowMajor)
+					{
+						for (size_t i = 1; i < m - j; ++i)
+						{
+							axpy(nc, x[i * rs], c + i * rs, cs, w, size_t(1));
+						}
+						axpy(nc, -tau, w, size_t(1), c, cs);
+						for (size_t i = 1; i < m - j; ++i)
+						{
+							axpy(nc, -tau * x[i * rs], w, size_t(1), c + i * rs, cs);
+						}
+					}
+					else
+					{
+						for (size_t q = 0; q < nc; ++q)
+						{
+							T* cq = c + q * cs;
+							const T s = tau * (cq[0] + dot(m - j - 1, x + rs, rs, cq + rs, rs));
+							cq[0] -= s;
+							axpy(m - j - 1, -s, x + rs, rs, cq + rs, rs);
+						}
+					}
+				}
+				tb[(j - j0) * ib + (j - j0)] = tau;
+			}
+
+			// T of block reflector: T(0:i,i) = -tau_i * T(0:i,0:i) * V(:,0:i)^T * v_i, products of vectors S = V^T * V by gemm
+			const size_t mv = m - j0;
+			const T* vb = v.data();
+			T* S = work.data();
+			detail::qrCopyV(m, a, rs, cs, j0, ib, v.data());
+			gemm(ib, ib, mv, T(1), vb, size_t(1), ib, vb, ib, size_t(1), T(0), S, ib, size_t(1));
+			for (size_t i = 1; i < ib; ++i)
+			{
+				const T tau = tb[i * ib + i];
+				for (size_t p = 0; p < i; ++p)
+				{
+					tb[p * ib + i] = -tau * dot(i - p, tb + p * ib + p, size_t(1), S + p * ib + i, ib);
+					tb[i * ib + p] = T(0);
+				}
+			}
+
+			// a(j0:m, j0+ib:n) = H^T * a(j0:m, j0+ib:n)
+			const size_t j1 = j0 + ib;
+			detail::qrApplyBlock(true, mv, ib, vb, tb, n - j1, a + j0 * rs + j1 * cs, rs, cs, work.data());
+		}
+	}
+
+	/**
+	* @brief Product of Q from geqrf and matrix B m*nrhs in place: B = Q * B or B = Q^T * B
+	* @details Q is applied by block reflectors, B is described by pointer and strides.
+	* @param k: Number of reflectors (min(m, n) of factorized matrix)
+	*/
+	template <typename L = RowMajor, typename T>
+	void ormqr(bool transpose, size_t m, size_t k, const T* a, size_t lda, const T* t,
+		size_t nrhs, T* b, size_t b_rs, size_t b_cs)
+	{
+		const size_t rs = L::rowStride(lda);
+		const size_t cs = L::colStride(lda);
+		if (k == 0 || nrhs == 0)
+		{
+			return;
+		}
+		AlignedBuffer<T> v(m * qrBlock);
+		AlignedBuffer<T> work(2 * qrBlock * nrhs);
+		const size_t blocks = (k + qrBlock - 1) / qrBlock;
+		for (size_t s = 0; s < blocks; ++s)
+		{
+			// Q^T = H_k...H_1: blocks in direct order, Q = H_1...H_k: in reverse order
+			const size_t j0 = (transpose ? s : blocks - 1 - s) * qrBlock;
+			const size_t ib = std::min(qrBlock, k - j0);
+			detail::qrCopyV(m, a, rs, cs, j0, ib, v.data());
+			detail::qrApplyBlock(transpose, m - j0, ib, v.data(), t + j0 * qrBlock,
+				nrhs, b + j0 * b_rs, b_rs, b_cs, work.data());
+		}
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{R} \mathbf{X} = \mathbf{B} @f$ or @f$ \mathbf{R}^T \mathbf{X} = \mathbf{B} @f$ in place,
+	* R is upper triangle n*n of a (stored in order L)
+	* @details Rows of B n*nrhs are updated by axpy along rows.
+	*/
+	template <typename L = RowMajor, typename T>
+	void trsmUpper(bool transpose, size_t n, const T* a, size_t lda, size_t nrhs, T* b, size_t b_rs, size_t b_cs)
+	{
+		const size_t rs = L::rowStride(lda);
+		const size_t cs = L::colStride(lda);
+		if (!transpose)
+		{
+			for (size_t i = n; i-- > 0;)
+			{
+				for (size_t p = i + 1; p < n; ++p)
+				{
+					axpy(nrhs, -a[i * rs + p * cs], b + p * b_rs, b_cs, b + i * b_rs, b_cs);
+				}
+				scal(nrhs, T(1) / a[i * rs + i * cs], b + i * b_rs, b_cs);
+			}
+			return;
+		}
+		// R^T is lower triangular: forward substitution
+		for (size_t i = 0; i < n; ++i)
+		{
+			scal(nrhs, T(1) / a[i * rs + i * cs], b + i * b_rs, b_cs);
+			for (size_t p = i + 1; p < n; ++p)
+			{
+				axpy(nrhs, -a[i * rs + p * cs], b + i * b_rs, b_cs, b + p * b_rs, b_cs);
+			}
+		}
+	}
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+
+namespace math::blas
+{
+	/**
+	* @brief Largest dimension, for which closed-form determinant and inverse are used
+	*/
+	constexpr size_t smallMaxSize = 4;
+
+	/**
+	* @brief Closed-form determinant of dense matrix N*N, N <= smallMaxSize
+	* @details Storage may be row- or column-oriented, since det(A^T) = det(A)
+	*/
+	template <size_t N, typename T>
+	constexpr T smallDet(const T* a)
+	{
+		static_assert(N >= 1 && N <= smallMaxSize, "blas::smallDet: unsupported size");
+		if constexpr (N == 1)
+		{
+			return a[0];
+		}
+		else if constexpr (N == 2)
+		{
+			return a[0] * a[3] - a[1] * a[2];
+		}
+		else if constexpr (N == 3)
+		{
+			return a[0] * (a[4] * a[8] - a[5] * a[7]) -
+				a[1] * (a[3] * a[8] - a[5] * a[6]) +
+				a[2] * (a[3] * a[7] - a[4] * a[6]);
+		}
+		else
+		{
+			// 2x2 minors of upper (s) and lower (c) halves, Laplace expansion by two rows
+			const T s0 = a[0] * a[5] - a[4] * a[1];
+			const T s1 = a[0] * a[6] - a[4] * a[2];
+			const T s2 = a[0] * a[7] - a[4] * a[3];
+			const T s3 = a[1] * a[6] - a[5] * a[2];
+			const T s4 = a[1] * a[7] - a[5] * a[3];
+			const T s5 = a[2] * a[7] - a[6] * a[3];
+			const T c5 = a[10] * a[15] - a[14] * a[11];
+			const T c4 = a[9] * a[15] - a[13] * a[11];
+			const T c3 = a[9] * a[14] - a[13] * a[10];
+			const T c2 = a[8] * a[15] - a[12] * a[11];
+			const T c1 = a[8] * a[14] - a[12] * a[10];
+			const T c0 = a[8] * a[13] - a[12] * a[9];
+			return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+		}
+	}
+
+	/**
+	* @brief Closed-form inverse of dense matrix N*N, N <= smallMaxSize (adjugate divided by determinant)
+	* @details Inverse is written to x in the same storage order as a, since inv(A^T) = inv(A)^T.
+	* x must not overlap with a.
+	* @return Determinant of a. If it is zero, x is not written.
+	*/
+	template <size_t N, typename T>
+	constexpr T smallInverse(const T* a, T* x)
+	{
+		static_assert(N >= 1 && N <= smallMaxSize, "blas::smallInverse: unsupported size");
+		if constexpr (N == 1)
+		{
+			const T d = a[0];
+			if (d != T(0))
+			{
+				x[0] = T(1) / d;
+			}
+			return d;
+		}
+		else if constexpr (N == 2)
+		{
+			const T d = smallDet<2>(a);
+			if (d != T(0))
+			{
+				const T id = T(1) / d;
+				x[0] = a[3] * id;
+				x[1] = -a[1] * id;
+				x[2] = -a[2] * id;
+				x[3] = a[0] * id;
+			}
+			return d;
+		}
+		else if constexpr (N == 3)
+		{
+			const T c0 = a[4] * a[8] - a[5] * a[7];
+			const T c1 = a[5] * a[6] - a[3] * a[8];
+			const T c2 = a[3] * a[7] - a[4] * a[6];
+			const T d = a[0] * c0 + a[1] * c1 + a[2] * c2;
+			if (d != T(0))
+			{
+				const T id = T(1) / d;
+				x[0] = c0 * id;
+				x[1] = (a[2] * a[7] - a[1] * a[8]) * id;
+				x[2] = (a[1] * a[5] - a[2] * a[4]) * id;
+				x[3] = c1 * id;
+				x[4] = (a[0] * a[8] - a[2] * a[6]) * id;
+				x[5] = (a[2] * a[3] - a[0] * a[5]) * id;
+				x[6] = c2 * id;
+				x[7] = (a[1] * a[6] - a[0] * a[7]) * id;
+				x[8] = (a[0] * a[4] - a[1] * a[3]) * id;
+			}
+			return d;
+		}
+		else
+		{
+			const T s0 = a[0] * a[5] - a[4] * a[1];
+			const T s1 = a[0] * a[6] - a[4] * a[2];
+			const T s2 = a[0] * a[7] - a[4] * a[3];
+			const T s3 = a[1] * a[6] - a[5] * a[2];
+			const T s4 = a[1] * a[7] - a[5] * a[3];
+			const T s5 = a[2] * a[7] - a[6] * a[3];
+			const T c5 = a[10] * a[15] - a[14] * a[11];
+			const T c4 = a[9] * a[15] - a[13] * a[11];
+			const T c3 = a[9] * a[14] - a[13] * a[10];
+			const T c2 = a[8] * a[15] - a[12] * a[11];
+			const T c1 = a[8] * a[14] - a[12] * a[10];
+			const T c0 = a[8] * a[13] - a[12] * a[9];
+			const T d = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+			if (d != T(0))
+			{
+				const T id = T(1) / d;
+				x[0] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * id;
+				x[1] = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * id;
+				x[2] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * id;
+				x[3] = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * id;
+				x[4] = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * id;
+				x[5] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * id;
+				x[6] = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * id;
+				x[7] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * id;
+				x[8] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * id;
+				x[9] = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * id;
+				x[10] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * id;
+				x[11] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * id;
+				x[12] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * id;
+				x[13] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * id;
+				x[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * id;
+				x[15] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * id;
+			}
+			return d;
+		}
+	}
+}
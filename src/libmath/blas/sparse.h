@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+
+namespace math::blas
+{
+	/**
+	* @brief Product of sparse matrix in CSR format and vector @f$ \mathbf{y} = \alpha \mathbf{A} \mathbf{x} + \beta \mathbf{y} @f$
+	* @details Matrix M*N is described by arrays of compressed sparse row format:
+	* non-zeros of row i are val[ptr[i]:ptr[i+1]] in columns ind[ptr[i]:ptr[i+1]].
+	* The kernel is scalar, not SIMD (indexed loads of x don't vectorize on the targets): row products
+	* are accumulated in 4 independent sums, so loads of x and additions of consecutive non-zeros overlap
+	* instead of waiting for one chain of additions. Rounding differs from the sequential sum.
+	* Work is proportional to number of non-zeros.
+	*/
+	template <typename T, typename I>
+	void csrmv(size_t M, T alpha,
+		const I* ptr, const I* ind, const T* val,
+		const T* x, size_t incx,
+		T beta,
+		T* y, size_t incy)
+	{
+		for (size_t i = 0; i < M; ++i)
+		{
+			T s0 = T(0), s1 = T(0), s2 = T(0), s3 = T(0);
+			size_t k = static_cast<size_t>(ptr[i]);
+			const size_t end = static_cast<size_t>(ptr[i + 1]);
+			if (incx == 1)
+			{
+				for (; k + 4 <= end; k += 4)
+				{
+					s0 += val[k] * x[ind[k]];
+					s1 += val[k + 1] * x[ind[k + 1]];
+					s2 += val[k + 2] * x[ind[k + 2]];
+					s3 += val[k + 3] * x[ind[k + 3]];
+				}
+			}
+			for (; k < end; ++k)
+			{
+				s0 += val[k] * x[static_cast<size_t>(ind[k]) * incx];
+			}
+			T& yi = y[i * incy];
+			const T s = alpha * ((s0 + s1) + (s2 + s3));
+			yi = (beta == T(0)) ? s : beta * yi + s;
+		}
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{L} \mathbf{x} = \mathbf{b} @f$ in place, L is lower triangle of n*n matrix in CSR format
+	* @details Columns are sorted inside rows, diagonal of row i is val[diag[i]], elements before it are strictly lower.
+	* @param unit: Diagonal is unit (val[diag[i]] isn't used)
+	*/
+	template <typename T, typename I>
+	void csrsvLower(size_t n, const I* ptr, const I* ind, const T* val, const I* diag, bool unit, T* x)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			T s = x[i];
+			const size_t d = static_cast<size_t>(diag[i]);
+			for (size_t k = static_cast<size_t>(ptr[i]); k < d; ++k)
+			{
+				s -= val[k] * x[ind[k]];
+			}
+			x[i] = unit ? s : s / val[d];
+		}
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{L}^T \mathbf{x} = \mathbf{b} @f$ in place, L is described as in csrsvLower (non-unit)
+	* @details Columns of L^T are rows of L, so x is updated by scatter after each element is found.
+	*/
+	template <typename T, typename I>
+	void csrsvLowerT(size_t n, const I* ptr, const I* ind, const T* val, const I* diag, T* x)
+	{
+		for (size_t i = n; i-- > 0;)
+		{
+			const size_t d = static_cast<size_t>(diag[i]);
+			const T xi = x[i] / val[d];
+			x[i] = xi;
+			for (size_t k = static_cast<size_t>(ptr[i]); k < d; ++k)
+			{
+				x[ind[k]] -= val[k] * xi;
+			}
+		}
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{U} \mathbf{x} = \mathbf{b} @f$ in place, U is upper triangle of n*n matrix in CSR format
+	* @details Columns are sorted inside rows, diagonal of row i is val[diag[i]], elements after it are strictly upper.
+	*/
+	template <typename T, typename I>
+	void csrsvUpper(size_t n, const I* ptr, const I* ind, const T* val, const I* diag, T* x)
+	{
+		for (size_t i = n; i-- > 0;)
+		{
+			T s = x[i];
+			const size_t d = static_cast<size_t>(diag[i]);
+			const size_t end = static_cast<size_t>(ptr[i + 1]);
+			for (size_t k = d + 1; k < end; ++k)
+			{
+				s -= val[k] * x[ind[k]];
+			}
+			x[i] = s / val[d];
+		}
+	}
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+namespace math::blas
+{
+	namespace detail
+	{
+		/// @brief Size of blocks, which are transposed directly (fits L1 cache)
+		constexpr size_t transposeBlock = 32;
+
+		/**
+		* @brief Swap block a(r0:r0+m, c0:c0+n) with transposed block a(c0:c0+n, r0:r0+m)
+		* @details Recursive (cache-oblivious) halving of the larger dimension
+		*/
+		template <typename T>
+		void swapTransposed(T* a, size_t ld, size_t r0, size_t c0, size_t m, size_t n)
+		{
+			if (m <= transposeBlock && n <= transposeBlock)
+			{
+				for (size_t i = r0; i < r0 + m; ++i)
+				{
+					for (size_t j = c0; j < c0 + n; ++j)
+					{
+						std::swap(a[i * ld + j], a[j * ld + i]);
+					}
+				}
+				return;
+			}
+			if (m >= n)
+			{
+				size_t h = m / 2;
+				swapTransposed(a, ld, r0, c0, h, n);
+				swapTransposed(a, ld, r0 + h, c0, m - h, n);
+			}
+			else
+			{
+				size_t h = n / 2;
+				swapTransposed(a, ld, r0, c0, m, h);
+				swapTransposed(a, ld, r0, c0 + h, m, n - h);
+			}
+		}
+
+		/**
+		* @brief Transpose diagonal block a(d0:d0+n, d0:d0+n) in place
+		*/
+		template <typename T>
+		void transposeDiagonal(T* a, size_t ld, size_t d0, size_t n)
+		{
+			if (n <= transposeBlock)
+			{
+				for (size_t i = d0; i < d0 + n; ++i)
+				{
+					for (size_t j = i + 1; j < d0 + n; ++j)
+					{
+						std::swap(a[i * ld + j], a[j * ld + i]);
+					}
+				}
+				return;
+			}
+			size_t h = n / 2;
+			transposeDiagonal(a, ld, d0, h);
+			transposeDiagonal(a, ld, d0 + h, n - h);
+			swapTransposed(a, ld, d0, d0 + h, h, n - h);
+		}
+	}
+
+	/**
+	* @brief Out-of-place transpose: dst(j,i) = src(i,j)
+	* @details Matrices are described by pointer and strides. Copy is done by tiles, so
+	* both source and destination are walked with good locality.
+	* @param rows, cols: Dimensions of src
+	*/
+	template <typename T>
+	void transposeCopy(size_t rows, size_t cols,
+		const T* src, size_t s_rs, size_t s_cs,
+		T* dst, size_t d_rs, size_t d_cs)
+	{
+		constexpr size_t B = detail::transposeBlock;
+		for (size_t i0 = 0; i0 < rows; i0 += B)
+		{
+			const size_t i1 = std::min(rows, i0 + B);
+			for (size_t j0 = 0; j0 < cols; j0 += B)
+			{
+				const size_t j1 = std::min(cols, j0 + B);
+				for (size_t i = i0; i < i1; ++i)
+				{
+					for (size_t j = j0; j < j1; ++j)
+					{
+						dst[j * d_rs + i * d_cs] = src[i * s_rs + j * s_cs];
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	* @brief In-place transpose of square matrix n*n
+	* @details Cache-oblivious recursive algorithm: diagonal blocks are transposed recursively,
+	* off-diagonal blocks are swapped with recursive halving.
+	*/
+	template <typename T>
+	void transposeSquare(size_t n, T* a)
+	{
+		detail::transposeDiagonal(a, n, 0, n);
+	}
+
+	/**
+	* @brief In-place transpose of dense storage, which consists of outer lines of inner elements
+	* @details Cycle-following algorithm: element at position p moves to position
+	* p * outer mod (N - 1). Visited elements are marked in bit vector of N bits.
+	* @param outer: Number of lines (rows for row-oriented matrix)
+	* @param inner: Length of lines (columns for row-oriented matrix)
+	*/
+	template <typename T>
+	void transposeCycles(size_t outer, size_t inner, T* a)
+	{
+		const size_t N = outer * inner;
+		if (N < 3)
+		{
+			return;
+		}
+		const size_t last = N - 1;
+		std::vector<bool> visited(N, false);
+		for (size_t start = 1; start < last; ++start)
+		{
+			if (visited[start])
+			{
+				continue;
+			}
+			size_t pos = start;
+			T carried = a[pos];
+			do
+			{
+				size_t next = (pos * outer) % last;
+				std::swap(a[next], carried);
+				visited[pos] = true;
+				pos = next;
+			} while (pos != start);
+		}
+	}
+}
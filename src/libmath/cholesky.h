@@ -0,0 +1,471 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <libmath/boolean.h>
+#include <libmath/symmetric.h>
+#include <libmath/triangular.h>
+#include <libmath/blas/cholesky.h>
+#include <libmath/blas/condest.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace math
+{
+	namespace detail
+	{
+		/**
+		* @brief Copy lower triangle of square matrix A to packed storage (see blas::pptrf)
+		*/
+		template <typename T>
+		void packLower(const Matrix<T>& A, std::vector<T>& ap)
+		{
+			const size_t n = A.rows();
+			ap.resize(blas::packedSize(n));
+			T* a = ap.data();
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t j = 0; j <= i; ++j)
+				{
+					*a++ = A.coeff(i, j);
+				}
+			}
+		}
+
+		/**
+		* @brief Check, that lower triangle of A is equal to packed triangle ap exactly
+		*/
+		template <typename T>
+		bool sameLower(const Matrix<T>& A, const std::vector<T>& ap)
+		{
+			const size_t n = A.rows();
+			if (A.cols() != n || ap.size() != blas::packedSize(n))
+			{
+				return false;
+			}
+			const T* a = ap.data();
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t j = 0; j <= i; ++j)
+				{
+					if (*a++ != A.coeff(i, j))
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		/**
+		* @brief Check symmetry of square matrix A with tolerance of settings (see isEqual)
+		*/
+		template <typename T>
+		bool isSymmetric(const Matrix<T>& A)
+		{
+			const size_t n = A.rows();
+			for (size_t i = 1; i < n; ++i)
+			{
+				for (size_t j = 0; j < i; ++j)
+				{
+					if (!isEqual(A.coeff(i, j), A.coeff(j, i)))
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		/**
+		* @brief 1-norm of symmetric matrix n*n by its lower triangle in packed storage
+		*/
+		template <typename T>
+		T packedNorm1(size_t n, const T* ap)
+		{
+			std::vector<T> sums(n, static_cast<T>(0));
+			for (size_t i = 0; i < n; ++i)
+			{
+				const T* ai = ap + blas::packedRow(i);
+				for (size_t j = 0; j < i; ++j)
+				{
+					const T v = std::abs(ai[j]);
+					sums[i] += v;
+					sums[j] += v;
+				}
+				sums[i] += std::abs(ai[i]);
+			}
+			return n == 0 ? static_cast<T>(0) : *std::max_element(sums.begin(), sums.end());
+		}
+
+		/**
+		* @brief Common part of factorizations of symmetric matrices in packed storage
+		*/
+		template <typename T>
+		class PackedFactorization
+		{
+		public:
+			/// @brief Was factorize() called
+			bool factorized() const
+			{
+				return factorized_;
+			}
+
+			/// @brief Dimension of factorized matrix
+			size_t size() const
+			{
+				return n_;
+			}
+
+			/**
+			* @brief Packed factor (lower triangle row by row, see blas::pptrf)
+			*/
+			const std::vector<T>& packed() const
+			{
+				return ap_;
+			}
+
+		protected:
+			/// @brief Factor in packed storage
+			std::vector<T> ap_;
+			size_t n_ = 0;
+			/// @brief Result of factorization (0 - success)
+			size_t info_ = 0;
+			/// @brief 1-norm of factorized matrix
+			T anorm_ = static_cast<T>(0);
+			bool factorized_ = false;
+
+			void load(const Matrix<T>& A, const char* method)
+			{
+				if (A.rows() != A.cols())
+				{
+					throw(math::ExceptionNonSquareMatrix(std::string(method) + ": matrix must be square!"));
+				}
+				n_ = A.rows();
+				packLower(A, ap_);
+				anorm_ = packedNorm1(n_, ap_.data());
+			}
+
+			void load(const SymmetricMatrix<T>& A)
+			{
+				n_ = A.rows();
+				ap_ = A.packed();
+				anorm_ = packedNorm1(n_, ap_.data());
+			}
+
+			/**
+			* @brief Reciprocal condition number estimate, solve(x) replaces vector x by A^-1 x (A is symmetric, A^-T = A^-1)
+			*/
+			template <typename Solve>
+			T estimateRcond(Solve solve) const
+			{
+				if (anorm_ == static_cast<T>(0))
+				{
+					return static_cast<T>(0);
+				}
+				const T ainvnorm = blas::invNorm1Estimate<T>(n_, solve, solve);
+				return ainvnorm == static_cast<T>(0) ? static_cast<T>(0) : static_cast<T>(1) / (anorm_ * ainvnorm);
+			}
+
+			static T condFromRcond(T r)
+			{
+				return r == static_cast<T>(0) ? std::numeric_limits<T>::infinity() : static_cast<T>(1) / r;
+			}
+
+			void checkRhs(const Matrix<T>& B, const char* method) const
+			{
+				if (!factorized_)
+				{
+					throw(math::Exception(std::string(method) + ": matrix isn't factorized!"));
+				}
+				if (B.rows() != n_)
+				{
+					throw(math::ExceptionIncorrectMatrix(std::string(method) + ": dimensions of factorized matrix and B didn't agree!"));
+				}
+			}
+		};
+	}
+
+	/**
+	* @brief Cholesky factorization @f$ \mathbf{A} = \mathbf{L} \mathbf{L}^T @f$ of symmetric positive-definite matrix
+	* @details Only lower triangle of A is read, L is stored in packed storage of n*(n+1)/2 elements.
+	* Factorization costs n^3/6 multiply-adds, i.e. half of LU.
+	* Factorization stops at the first non-positive pivot, so it is also the cheapest check of positive definiteness.
+	*/
+	template <typename T>
+	class CholeskyFactorization :
+		public detail::PackedFactorization<T>
+	{
+	public:
+		CholeskyFactorization() = default;
+
+		/**
+		* @brief Factorize matrix A
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		explicit CholeskyFactorization(const Matrix<T>& A)
+		{
+			factorize(A);
+		}
+
+		/**
+		* @brief Factorize symmetric matrix A
+		*/
+		explicit CholeskyFactorization(const SymmetricMatrix<T>& A)
+		{
+			factorize(A);
+		}
+
+		/**
+		* @brief Factorize matrix A, previous factorization is replaced
+		* @details Matrix, which isn't positive definite, doesn't throw here, see positiveDefinite()
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		void factorize(const Matrix<T>& A)
+		{
+			this->load(A, "CholeskyFactorization");
+			this->info_ = blas::pptrf(this->n_, this->ap_.data());
+			this->factorized_ = true;
+		}
+
+		/**
+		* @brief Factorize symmetric matrix A, packed storage is copied without conversion
+		*/
+		void factorize(const SymmetricMatrix<T>& A)
+		{
+			this->load(A);
+			this->info_ = blas::pptrf(this->n_, this->ap_.data());
+			this->factorized_ = true;
+		}
+
+		/// @brief Factorized matrix is positive definite
+		bool positiveDefinite() const
+		{
+			return this->factorized_ && this->info_ == 0;
+		}
+
+		/**
+		* @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$ in place: B is replaced by X
+		* @throws math::ExceptionIncorrectMatrix
+		*/
+		void solveInPlace(Matrix<T>& B) const
+		{
+			this->checkRhs(B, "CholeskyFactorization::solveInPlace");
+			if (!positiveDefinite())
+			{
+				throw(math::ExceptionIncorrectMatrix("CholeskyFactorization::solveInPlace: matrix isn't positive definite!"));
+			}
+			blas::pptrs(this->n_, this->ap_.data(), B.cols(), B.data(), B.rowStride(), B.colStride());
+		}
+
+		/**
+		* @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$
+		* @return X with dimensions and representation of B
+		*/
+		Matrix<T> solve(const Matrix<T>& B) const
+		{
+			Matrix<T> X(B);
+			solveInPlace(X);
+			return X;
+		}
+
+		/**
+		* @brief Lower triangular factor L in packed storage
+		* @throws math::ExceptionIncorrectMatrix
+		*/
+		TriangularMatrix<T> lower() const
+		{
+			if (!positiveDefinite())
+			{
+				throw(math::ExceptionIncorrectMatrix("CholeskyFactorization::lower: matrix isn't positive definite!"));
+			}
+			return TriangularMatrix<T>(this->n_, Uplo::Lower, this->ap_);
+		}
+
+		/**
+		* @brief Determinant of factorized matrix
+		* @throws math::ExceptionIncorrectMatrix
+		*/
+		T det() const
+		{
+			if (!positiveDefinite())
+			{
+				throw(math::ExceptionIncorrectMatrix("CholeskyFactorization::det: matrix isn't positive definite!"));
+			}
+			T d = static_cast<T>(1);
+			for (size_t i = 0; i < this->n_; ++i)
+			{
+				const T lii = this->ap_[blas::packedRow(i) + i];
+				d *= lii * lii;
+			}
+			return d;
+		}
+
+		/**
+		* @brief Estimate of reciprocal condition number @f$ 1 / (\|\mathbf{A}\|_1 \|\mathbf{A}^{-1}\|_1) @f$ in O(n^2)
+		* @details See LU::rcond(). 0 for matrix, which isn't positive definite.
+		*/
+		T rcond() const
+		{
+			if (!positiveDefinite())
+			{
+				return static_cast<T>(0);
+			}
+			return this->estimateRcond([this](T* x) { blas::pptrs(this->n_, this->ap_.data(), 1, x, 1, 1); });
+		}
+
+		/**
+		* @brief Estimate of condition number in 1-norm (see rcond()), infinity if matrix isn't positive definite
+		*/
+		T cond() const
+		{
+			return this->condFromRcond(rcond());
+		}
+	};
+
+	/**
+	* @brief Factorization @f$ \mathbf{A} = \mathbf{L} \mathbf{D} \mathbf{L}^T @f$ of symmetric matrix without pivoting
+	* @details Only lower triangle of A is read, unit L and D are stored in packed storage of n*(n+1)/2 elements.
+	* Unlike Cholesky, there are no square roots and A may be indefinite, if its leading minors are non-zero.
+	*/
+	template <typename T>
+	class LDLTFactorization :
+		public detail::PackedFactorization<T>
+	{
+	public:
+		LDLTFactorization() = default;
+
+		/**
+		* @brief Factorize matrix A
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		explicit LDLTFactorization(const Matrix<T>& A)
+		{
+			factorize(A);
+		}
+
+		/**
+		* @brief Factorize symmetric matrix A
+		*/
+		explicit LDLTFactorization(const SymmetricMatrix<T>& A)
+		{
+			factorize(A);
+		}
+
+		/**
+		* @brief Factorize matrix A, previous factorization is replaced
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		void factorize(const Matrix<T>& A)
+		{
+			this->load(A, "LDLTFactorization");
+			this->info_ = blas::pptrfLDLT(this->n_, this->ap_.data());
+			this->factorized_ = true;
+		}
+
+		/**
+		* @brief Factorize symmetric matrix A, packed storage is copied without conversion
+		*/
+		void factorize(const SymmetricMatrix<T>& A)
+		{
+			this->load(A);
+			this->info_ = blas::pptrfLDLT(this->n_, this->ap_.data());
+			this->factorized_ = true;
+		}
+
+		/// @brief Zero element of D was met
+		bool singular() const
+		{
+			return this->info_ != 0;
+		}
+
+		/// @brief Factorized matrix is positive definite (all elements of D are positive)
+		bool positiveDefinite() const
+		{
+			if (!this->factorized_ || singular())
+			{
+				return false;
+			}
+			for (size_t i = 0; i < this->n_; ++i)
+			{
+				if (!(this->ap_[blas::packedRow(i) + i] > static_cast<T>(0)))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		* @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$ in place: B is replaced by X
+		* @throws math::ExceptionIncorrectMatrix
+		* @throws math::ExceptionDegenerateMatrix
+		*/
+		void solveInPlace(Matrix<T>& B) const
+		{
+			this->checkRhs(B, "LDLTFactorization::solveInPlace");
+			if (singular())
+			{
+				throw(math::ExceptionDegenerateMatrix("LDLTFactorization::solveInPlace: zero pivot, matrix can't be factorized without pivoting!"));
+			}
+			blas::pptrsLDLT(this->n_, this->ap_.data(), B.cols(), B.data(), B.rowStride(), B.colStride());
+		}
+
+		/**
+		* @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$
+		* @return X with dimensions and representation of B
+		*/
+		Matrix<T> solve(const Matrix<T>& B) const
+		{
+			Matrix<T> X(B);
+			solveInPlace(X);
+			return X;
+		}
+
+		/**
+		* @brief Determinant of factorized matrix (product of D)
+		*/
+		T det() const
+		{
+			if (!this->factorized_)
+			{
+				throw(math::Exception("LDLTFactorization::det: matrix isn't factorized!"));
+			}
+			if (singular())
+			{
+				return static_cast<T>(0);
+			}
+			T d = static_cast<T>(1);
+			for (size_t i = 0; i < this->n_; ++i)
+			{
+				d *= this->ap_[blas::packedRow(i) + i];
+			}
+			return d;
+		}
+
+		/**
+		* @brief Estimate of reciprocal condition number @f$ 1 / (\|\mathbf{A}\|_1 \|\mathbf{A}^{-1}\|_1) @f$ in O(n^2)
+		* @details See LU::rcond(). 0 for singular factorization.
+		*/
+		T rcond() const
+		{
+			if (!this->factorized_ || singular())
+			{
+				return static_cast<T>(0);
+			}
+			return this->estimateRcond([this](T* x) { blas::pptrsLDLT(this->n_, this->ap_.data(), 1, x, 1, 1); });
+		}
+
+		/**
+		* @brief Estimate of condition number in 1-norm (see rcond()), infinity for singular factorization
+		*/
+		T cond() const
+		{
+			return this->condFromRcond(rcond());
+		}
+	};
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <libmath/math_settings.h>
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Diagonal matrix, only n diagonal elements are stored
+	* @details Products with dense matrices scale rows or columns, solution divides rows.
+	* DiagonalMatrix is a matrix expression, so it can be used in elementwise expressions
+	* with Matrix (e.g. A + lambda * D) and assigned to Matrix.
+	*/
+	template <typename T>
+	class DiagonalMatrix :
+		public MatExpr<DiagonalMatrix<T>>
+	{
+	public:
+		typedef T value_type;
+
+		DiagonalMatrix() = default;
+
+		/**
+		 * @brief Diagonal matrix n*n with value on diagonal (e.g. lambda * E)
+		 */
+		explicit DiagonalMatrix(size_t n, T value = static_cast<T>(0))
+			: d_(n, value)
+		{
+		}
+
+		/**
+		 * @brief Diagonal matrix from vector of diagonal elements
+		 */
+		explicit DiagonalMatrix(std::vector<T> diagonal)
+			: d_(std::move(diagonal))
+		{
+		}
+
+		/**
+		 * @brief Diagonal of square matrix A
+		 * @throws math::ExceptionNonSquareMatrix
+		 */
+		explicit DiagonalMatrix(const Matrix<T>& A)
+			: d_(A.rows())
+		{
+			if (A.rows() != A.cols())
+			{
+				throw(math::ExceptionNonSquareMatrix("DiagonalMatrix: matrix must be square!"));
+			}
+			for (size_t i = 0; i < d_.size(); ++i)
+			{
+				d_[i] = A.coeff(i, i);
+			}
+		}
+
+		size_t rows() const
+		{
+			return d_.size();
+		}
+
+		size_t cols() const
+		{
+			return d_.size();
+		}
+
+		/// @brief Elements are enumerated row by row in expressions
+		MatRep representation() const
+		{
+			return MatRep::Row;
+		}
+
+		/// @brief Diagonal elements
+		const std::vector<T>& diagonal() const
+		{
+			return d_;
+		}
+
+		/// @brief Diagonal elements
+		std::vector<T>& diagonal()
+		{
+			return d_;
+		}
+
+		/**
+		 * @brief Element at position (row, col) without check of indices
+		 */
+		T coeff(size_t row, size_t col) const
+		{
+			return row == col ? d_[row] : static_cast<T>(0);
+		}
+
+		/// @brief elem() computes (row, col) from pos, so expressions are evaluated by coeff() (see MatExpr)
+		bool linear() const
+		{
+			return false;
+		}
+
+		/**
+		 * @brief Element of linear position pos in row-by-row order (see MatExpr)
+		 */
+		T elem(size_t pos) const
+		{
+			const size_t n = d_.size();
+			return coeff(pos / n, pos % n);
+		}
+
+		/**
+		 * @brief Reference to diagonal element i
+		 */
+		T& operator[](size_t i)
+		{
+			return d_[i];
+		}
+
+		T operator[](size_t i) const
+		{
+			return d_[i];
+		}
+
+		T operator()(size_t row, size_t col) const
+		{
+			if constexpr (settings::boundsCheck)
+			{
+				if (row >= d_.size() || col >= d_.size())
+				{
+					throw(ExceptionIndexOutOfBounds("DiagonalMatrix::operator(): index out of bounds!"));
+				}
+			}
+			return coeff(row, col);
+		}
+
+		/**
+		 * @brief Determinant (product of diagonal)
+		 */
+		T det() const
+		{
+			T p = static_cast<T>(1);
+			for (const T& di : d_)
+			{
+				p *= di;
+			}
+			return p;
+		}
+
+		/**
+		 * @brief Solve @f$ \mathbf{D} \mathbf{X} = \mathbf{B} @f$ in place: rows of B are divided by diagonal
+		 * @throws math::ExceptionIncorrectMatrix
+		 * @throws math::ExceptionDegenerateMatrix
+		 */
+		void solveInPlace(Matrix<T>& B) const
+		{
+			if (B.rows() != d_.size())
+			{
+				throw(math::ExceptionIncorrectMatrix("DiagonalMatrix::solveInPlace: dimensions of matrix and B didn't agree!"));
+			}
+			checkDiagonal("DiagonalMatrix::solveInPlace");
+			for (size_t i = 0; i < B.rows(); ++i)
+			{
+				blas::scal(B.cols(), static_cast<T>(1) / d_[i], B.data() + i * B.rowStride(), B.colStride());
+			}
+		}
+
+		/**
+		 * @brief Solve @f$ \mathbf{D} \mathbf{X} = \mathbf{B} @f$
+		 * @return X with dimensions and representation of B
+		 */
+		Matrix<T> solve(const Matrix<T>& B) const
+		{
+			Matrix<T> X(B);
+			solveInPlace(X);
+			return X;
+		}
+
+		/**
+		 * @brief Inverse matrix (reciprocals of diagonal)
+		 * @throws math::ExceptionDegenerateMatrix
+		 */
+		DiagonalMatrix<T> inverse() const
+		{
+			checkDiagonal("DiagonalMatrix::inverse");
+			DiagonalMatrix<T> X(d_.size());
+			for (size_t i = 0; i < d_.size(); ++i)
+			{
+				X.d_[i] = static_cast<T>(1) / d_[i];
+			}
+			return X;
+		}
+
+	private:
+		//! Diagonal elements
+		std::vector<T> d_;
+
+		void checkDiagonal(const char* method) const
+		{
+			for (const T& di : d_)
+			{
+				if (di == static_cast<T>(0))
+				{
+					throw(math::ExceptionDegenerateMatrix(std::string(method) + ": zero on diagonal!"));
+				}
+			}
+		}
+	};
+
+	namespace expr
+	{
+		template <typename T>
+		struct Storage<DiagonalMatrix<T>>
+		{
+			typedef const DiagonalMatrix<T>& type;
+		};
+	}
+
+	/**
+	* @brief Product of diagonal and dense matrices: rows of B are scaled
+	* @throws math::ExceptionInvalidValue
+	*/
+	template <typename T>
+	Matrix<T> operator*(const DiagonalMatrix<T>& D, const Matrix<T>& B)
+	{
+		if (D.cols() != B.rows())
+		{
+			throw(math::ExceptionInvalidValue("DiagonalMatrix<T>::operator*: Matrices can't be multiplied!"));
+		}
+		Matrix<T> C(B);
+		for (size_t i = 0; i < C.rows(); ++i)
+		{
+			blas::scal(C.cols(), D[i], C.data() + i * C.rowStride(), C.colStride());
+		}
+		return C;
+	}
+
+	/**
+	* @brief Product of dense and diagonal matrices: columns of A are scaled
+	* @throws math::ExceptionInvalidValue
+	*/
+	template <typename T>
+	Matrix<T> operator*(const Matrix<T>& A, const DiagonalMatrix<T>& D)
+	{
+		if (A.cols() != D.rows())
+		{
+			throw(math::ExceptionInvalidValue("DiagonalMatrix<T>::operator*: Matrices can't be multiplied!"));
+		}
+		Matrix<T> C(A);
+		for (size_t j = 0; j < C.cols(); ++j)
+		{
+			blas::scal(C.rows(), D[j], C.data() + j * C.colStride(), C.rowStride());
+		}
+		return C;
+	}
+
+	/**
+	* @brief Product of diagonal matrices
+	* @throws math::ExceptionInvalidValue
+	*/
+	template <typename T>
+	DiagonalMatrix<T> operator*(const DiagonalMatrix<T>& A, const DiagonalMatrix<T>& B)
+	{
+		if (A.cols() != B.rows())
+		{
+			throw(math::ExceptionInvalidValue("DiagonalMatrix<T>::operator*: Matrices can't be multiplied!"));
+		}
+		DiagonalMatrix<T> C(A);
+		for (size_t i = 0; i < C.rows(); ++i)
+		{
+			C[i] *= B[i];
+		}
+		return C;
+	}
+}
@@ -4,6 +4,7 @@
 #include <libmath/math_settings.h>
 #include <libmath/math_exception.h>
 #include <libmath/boolean.h>
+#include <libmath/elementwise.h>
 #include <vector>
 #include <functional>
 #include <chrono>
@@ -12,6 +13,43 @@
 namespace math
 {
 
+	namespace detail
+	{
+		/**
+		* @brief Partial derivate of F by argument xId (see partialDerivate), argument is perturbed in place
+		* @details xp is equal to x on entry and on exit, so copies of x aren't made for every derivate.
+		* @param fx: Value F(x)
+		*/
+		template<typename T, typename T1>
+		T partialDerivateInPlace(const std::function<T(const Matrix<T1>&)>& F_,
+			math::Matrix<T1>& xp,
+			const size_t xId,
+			const T fx,
+			const int scheme,
+			const T1 stepX
+		)
+		{
+			T1& xi = xp.data()[xId];
+			const T1 x0 = xi;
+			T dFdX = static_cast<T>(0.0);
+			if (scheme == 1)
+			{
+				xi = x0 - stepX;
+				dFdX = (fx - F_(xp)) / static_cast<T>(stepX);
+			}
+			else
+			{
+				xi = x0 + stepX;
+				const T next = F_(xp);
+				xi = x0 - stepX;
+				const T previous = F_(xp);
+				dFdX = (static_cast<T>(1.5) * next - static_cast<T>(2.0) * fx + static_cast<T>(0.5) * previous) / static_cast<T>(stepX);
+			}
+			xi = x0;
+			return dFdX;
+		}
+	}
+
 	/**
 	* @brief Partial derivate of function @f$ f @f$
 	* @details Calculate @f$ \frac{\partial f}{\partial x} @f$.
@@ -70,27 +108,13 @@ namespace math
 			throw(math::ExceptionIndexOutOfBounds("partialDerivate: Incorrect xId argument!"));
 		}
 
-		T dFdX = static_cast<T>(0.0);
-
-		math::Matrix<T1> previous_x = x;
-		previous_x(xId, 0) = x(xId, 0) - stepX;
-		math::Matrix<T1> next_x = x;
-		next_x(xId, 0) = x(xId, 0) + stepX;
-
-		switch (scheme)
+		if (scheme != 1 && scheme != 2)
 		{
-		case 1:
-			dFdX = (F_(x) - F_(previous_x)) / static_cast<T>(stepX);
-			break;
-		case 2:
-			dFdX = ((3.0 / 2.0) * F_(next_x) - 2.0 * F_(x) + 0.5 * F_(previous_x)) / static_cast<T>(stepX);
-			break;
-		default:
 			throw(math::ExceptionInvalidValue("partialDerivate: Incorrect scheme argument!"));
 		}
 
-		return dFdX;
-
+		math::Matrix<T1> xp = x;
+		return detail::partialDerivateInPlace(F_, xp, xId, F_(x), scheme, stepX);
 	}
 
 	/**
@@ -144,6 +168,75 @@ namespace math
 		return math::partialDerivate<T, T1>(f, args, 0, scheme, stepX);
 	}
 
+	namespace detail
+	{
+		/**
+		* @brief Fill line of J (row or column of layout L), xp is a copy of x for perturbations
+		*/
+		template <typename L, typename T, typename T1>
+		void jacobiLine(
+			const std::vector<std::function<T(const Matrix<T1>&)>>& F,
+			const math::Matrix<T1>& x,
+			math::Matrix<T1>& xp,
+			T* out,
+			const size_t line,
+			const size_t length,
+			const int scheme,
+			T1 stepX
+		)
+		{
+			// F(x) of row is computed once per row-major line
+			const T fline = L::rowMajor ? F[line](x) : static_cast<T>(0.0);
+			for (size_t k = 0; k < length; ++k)
+			{
+				const size_t row = L::rowMajor ? line : k;
+				const size_t col = L::rowMajor ? k : line;
+				out[k] = partialDerivateInPlace<T, T1>(F[row], xp, col, L::rowMajor ? fline : F[row](x), scheme, stepX);
+			}
+		}
+
+		/**
+		* @brief Fill J(i,j) = dF_i/dx_j line by line of storage layout L (see blas::RowMajor)
+		* @details Lines (rows or columns) are distributed between threads, elements of a line
+		* are written contiguously, so position of element isn't computed from linear index.
+		* Arguments are perturbed in copy xw of x (each thread makes its own copy in parallel builds).
+		*/
+		template <typename L, typename T, typename T1>
+		void jacobiLines(
+			const std::vector<std::function<T(const Matrix<T1>&)>>& F,
+			const math::Matrix<T1>& x,
+			math::Matrix<T>& J,
+			math::Matrix<T1>& xw,
+			const int scheme,
+			T1 stepX
+		)
+		{
+			const int lines = static_cast<int>(L::rowMajor ? J.rows() : J.cols());
+			const size_t length = L::rowMajor ? J.cols() : J.rows();
+			T* j = J.data();
+
+			const int threads = lines > 1 ? std::min(parallelThreads(), lines) : 1;
+			if (threads > 1)
+			{
+				MATH_OMP(parallel num_threads(threads))
+				{
+					math::Matrix<T1> xp = x;
+					MATH_OMP(for schedule(static))
+					for (int line = 0; line < lines; ++line)
+					{
+						jacobiLine<L>(F, x, xp, j + static_cast<size_t>(line) * length, static_cast<size_t>(line), length, scheme, stepX);
+					}
+				}
+				return;
+			}
+			xw = x;
+			for (int line = 0; line < lines; ++line)
+			{
+				jacobiLine<L>(F, x, xw, j + static_cast<size_t>(line) * length, static_cast<size_t>(line), length, scheme, stepX);
+			}
+		}
+	}
+
 	/**
 	* @brief Jacobi matrix of vector function @f$ \mathbf{u} @f$ with arguments @f$ \mathbf{x} @f$
 	* @details Calculate Matrix of size MxN, where M - number of functions F, N - number of functions arguments x.
@@ -238,9 +331,6 @@ namespace math
 			//throw exc;
 		}
 
-		math::Matrix<T1> previous_x = x;
-		math::Matrix<T1> next_x = x;
-
 		size_t m = F.size();
 		size_t n = x.rows();
 
@@ -252,29 +342,42 @@ namespace math
 			//throw exc;
 		}
 
-		size_t n_els = J.numel();
-
-		//auto start = std::chrono::steady_clock::now();
-		#pragma omp parallel for shared(J, n_els) schedule(static)
-		for (int pos = 0; pos < n_els; ++pos)
+		if (scheme != 1 && scheme != 2)
 		{
-			size_t row = 0;
-			size_t col = 0;
-			if (J.representation() == math::MatRep::Row) // row repr
-			{
-				row = (size_t)std::floor(pos / J.cols());
-				col = pos - row * J.cols();
-			}
-			else if (J.representation() == math::MatRep::Column) // column repr
+			throw(math::ExceptionInvalidValue("jacobi: Incorrect scheme argument!"));
+		}
+
+		math::Matrix<T1> xw;
+		detail::withLayout(J.representation(), [&](auto layout)
 			{
-				col = (size_t)std::floor(pos / J.rows());
-				row = pos - J.rows() * col;
-			}
-			J(col, row) = math::partialDerivate<T, T1>(F[col], x, row, scheme, stepX);
+				detail::jacobiLines<decltype(layout)>(F, x, J, xw, scheme, stepX);
+			});
+	}
 
+	/**
+	* @brief Jacobi matrix of vector function (see jacobi above) with work copy of arguments
+	* @details Arguments are perturbed in place in xw, which is resized on the first call and reused after that,
+	* so repeated calculation of Jacobian of the same size doesn't allocate memory (in builds without OpenMP
+	* or with one thread; in parallel builds each thread makes its own copy of x).
+	* @param[in,out] xw: Work copy of x
+	*/
+	template<typename T, typename T1, class = std::enable_if<isNumeric<T>&& isNumeric<T1>>>
+	void jacobi(
+		const std::vector<std::function<T(const Matrix<T1>&)>>& F,
+		const math::Matrix<T1>& x,
+		math::Matrix<T>& J,
+		math::Matrix<T1>& xw,
+		const int scheme = 1,
+		T1 stepX = static_cast<T1>(0.001 * math::settings::CurrentSettings.targetTolerance)
+	)
+	{
+		if (scheme != 1 && scheme != 2)
+		{
+			throw(math::ExceptionInvalidValue("jacobi: Incorrect scheme argument!"));
 		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
-
+		detail::withLayout(J.representation(), [&](auto layout)
+			{
+				detail::jacobiLines<decltype(layout)>(F, x, J, xw, scheme, stepX);
+			});
 	}
 }
\ No newline at end of file
@@ -0,0 +1,676 @@
+#pragma once
+
+#include <libmath/matrix_expr.h>
+#include <libmath/math_exception.h>
+#include <libmath/math_settings.h>
+#include <libmath/blas/layout.h>
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace math
+{
+	/**
+	* @brief Direction of reduction
+	*	- Rows: over rows of every column, result is row vector 1*cols
+	*	- Cols: over columns of every row, result is column vector rows*1
+	*/
+	enum class Axis
+	{
+		Rows = 0,
+		Cols
+	};
+
+	namespace detail
+	{
+		/// @brief Number of independent partial results of reductions (chains, which are vectorized by compiler)
+		constexpr size_t reductionLanes = 8;
+
+		/**
+		* @brief Number of threads of parallel kernels: Settings::numThreads (all cores if 0)
+		* @details 1 in builds without OpenMP and inside parallel region (nested parallelism isn't used)
+		*/
+		inline int parallelThreads()
+		{
+#ifdef _OPENMP
+			if (!omp_in_parallel())
+			{
+				const int threads = settings::CurrentSettings.numThreads;
+				return threads > 0 ? threads : omp_get_max_threads();
+			}
+#endif
+			return 1;
+		}
+
+		/**
+		* @brief Number of threads for kernel of n elements, 1 - serial execution
+		* @see settings::Settings::parallelThreshold
+		*/
+		inline int elementwiseThreads(size_t n)
+		{
+			const settings::Settings& s = settings::CurrentSettings;
+			if (s.parallelThreshold != 0 && n >= s.parallelThreshold)
+			{
+				return static_cast<int>(std::min<size_t>(static_cast<size_t>(parallelThreads()), n));
+			}
+			return 1;
+		}
+
+		/**
+		* @brief Call f(pos) for pos in [0, n)
+		* @details SIMD loop (scalar tail is generated by compiler), parallel loop for large n (see elementwiseThreads).
+		* Iterations must be independent.
+		*/
+		template <typename F>
+		void forEachPos(size_t n, F f)
+		{
+			const int threads = elementwiseThreads(n);
+			if (threads > 1)
+			{
+				const std::ptrdiff_t count = static_cast<std::ptrdiff_t>(n);
+				MATH_OMP(parallel for simd schedule(static) num_threads(threads))
+				for (std::ptrdiff_t pos = 0; pos < count; ++pos)
+				{
+					f(static_cast<size_t>(pos));
+				}
+				return;
+			}
+			MATH_OMP(simd)
+			for (size_t pos = 0; pos < n; ++pos)
+			{
+				f(pos);
+			}
+		}
+
+		/**
+		* @brief Call f(i, j) for all elements of rows*cols, inner loop goes along lines of layout L (see blas::RowMajor)
+		*/
+		template <typename L, typename F>
+		void forEachIndex(size_t rows, size_t cols, F f)
+		{
+			const std::ptrdiff_t lines = static_cast<std::ptrdiff_t>(L::rowMajor ? rows : cols);
+			const size_t length = L::rowMajor ? cols : rows;
+			[[maybe_unused]] const int threads = elementwiseThreads(rows * cols);
+			MATH_OMP(parallel for schedule(static) num_threads(threads) if(threads > 1))
+			for (std::ptrdiff_t line = 0; line < lines; ++line)
+			{
+				MATH_OMP(simd)
+				for (size_t k = 0; k < length; ++k)
+				{
+					if constexpr (L::rowMajor)
+					{
+						f(static_cast<size_t>(line), k);
+					}
+					else
+					{
+						f(k, static_cast<size_t>(line));
+					}
+				}
+			}
+		}
+
+		/**
+		* @brief Call f(out(i,j), i, j) for strided storage rows*cols, out(i,j) = out[i * rs + j * cs]
+		* @details Inner loop goes along the smaller stride (along vector for vectors)
+		*/
+		template <typename T, typename F>
+		void forEachElement(T* out, size_t rows, size_t cols, size_t rs, size_t cs, F f)
+		{
+			const bool rowOrder = rows == 1 || (cols != 1 && cs <= rs);
+			withLayout(rowOrder ? MatRep::Row : MatRep::Column, [&](auto layout)
+				{
+					typedef decltype(layout) L;
+					// unit inner stride is known at compile time, so the inner loop walks memory contiguously
+					if (L::rowMajor ? cs == 1 : rs == 1)
+					{
+						forEachIndex<L>(rows, cols, [out, rs, cs, &f](size_t i, size_t j)
+							{
+								f(out[L::rowMajor ? i * rs + j : i + j * cs], i, j);
+							});
+						return;
+					}
+					forEachIndex<L>(rows, cols, [out, rs, cs, &f](size_t i, size_t j)
+						{
+							f(out[i * rs + j * cs], i, j);
+						});
+				});
+		}
+
+		/// @brief Operations of evaluate()
+		struct Assign
+		{
+			template <typename T, typename V>
+			void operator()(T& d, V v) const { d = static_cast<T>(v); }
+		};
+
+		struct AddAssign
+		{
+			template <typename T, typename V>
+			void operator()(T& d, V v) const { d += static_cast<T>(v); }
+		};
+
+		struct SubAssign
+		{
+			template <typename T, typename V>
+			void operator()(T& d, V v) const { d -= static_cast<T>(v); }
+		};
+
+		/**
+		* @brief Evaluate expression to strided destination: op(out(i,j), e(i,j)), out(i,j) = out[i * rs + j * cs]
+		* @details Linear expression (see MatExpr) is evaluated by linear position, if destination is dense
+		* in order of e.representation(). Other expressions are evaluated by (row, col), inner loop goes along
+		* the smaller stride of destination.
+		*/
+		template <typename T, typename E, typename Op>
+		void evaluate(const E& e, T* out, size_t rs, size_t cs, Op op)
+		{
+			const size_t m = e.rows();
+			const size_t n = e.cols();
+			const bool dense = e.representation() == MatRep::Row ?
+				(m == 1 || rs == n) && (n == 1 || cs == 1) :
+				(n == 1 || cs == m) && (m == 1 || rs == 1);
+			if (dense && expr::linear(e))
+			{
+				forEachPos(m * n, [&e, out, op](size_t pos) { op(out[pos], e.elem(pos)); });
+				return;
+			}
+			forEachElement(out, m, n, rs, cs, [&e, op](T& d, size_t i, size_t j) { op(d, e.coeff(i, j)); });
+		}
+
+		/**
+		* @brief Call f(layout, get) with storage order of expression, get(line, k) is element k of line
+		* @details Line is a row (blas::RowMajor) or a column (blas::ColMajor). Elements of linear expression
+		* are read by elem(), of others - by coeff().
+		*/
+		template <typename E, typename F>
+		decltype(auto) withLines(const E& e, F&& f)
+		{
+			return withLayout(e.representation(), [&](auto layout) -> decltype(auto)
+				{
+					typedef decltype(layout) L;
+					const size_t length = L::rowMajor ? e.cols() : e.rows();
+					if (expr::linear(e))
+					{
+						return f(layout, [&e, length](size_t line, size_t k) { return e.elem(line * length + k); });
+					}
+					return f(layout, [&e](size_t line, size_t k) { return L::rowMajor ? e.coeff(line, k) : e.coeff(k, line); });
+				});
+		}
+
+		/**
+		* @brief Reduction Op (expr::Add, expr::Min, expr::Max) of init and get(k) for k in [begin, end)
+		* @details reductionLanes partial results are accumulated (vectorized), remaining elements are added to the first one
+		*/
+		template <typename Op, typename T, typename Get>
+		T reduceRange(size_t begin, size_t end, T init, Get get)
+		{
+			if (end - begin < reductionLanes)
+			{
+				for (size_t k = begin; k < end; ++k)
+				{
+					init = Op::apply(init, static_cast<T>(get(k)));
+				}
+				return init;
+			}
+			T acc[reductionLanes];
+			for (size_t l = 0; l < reductionLanes; ++l)
+			{
+				acc[l] = static_cast<T>(get(begin + l));
+			}
+			size_t k = begin + reductionLanes;
+			for (; k + reductionLanes <= end; k += reductionLanes)
+			{
+				for (size_t l = 0; l < reductionLanes; ++l)
+				{
+					acc[l] = Op::apply(acc[l], static_cast<T>(get(k + l)));
+				}
+			}
+			for (; k < end; ++k)
+			{
+				acc[0] = Op::apply(acc[0], static_cast<T>(get(k)));
+			}
+			for (size_t w = reductionLanes / 2; w > 0; w /= 2)
+			{
+				for (size_t l = 0; l < w; ++l)
+				{
+					acc[l] = Op::apply(acc[l], acc[l + w]);
+				}
+			}
+			return Op::apply(init, acc[0]);
+		}
+
+		/**
+		* @brief Reduction Op of all elements of non-empty expression
+		*/
+		template <typename Op, typename E>
+		typename E::value_type reduceAll(const E& e)
+		{
+			typedef typename E::value_type T;
+			const size_t count = e.rows() * e.cols();
+			if (expr::linear(e))
+			{
+				auto get = [&e](size_t pos) { return e.elem(pos); };
+				int threads = elementwiseThreads(count);
+				if (threads > 1)
+				{
+					// contiguous non-empty chunks of threads (an empty chunk has no neutral value for Op)
+					const size_t chunk = (count + threads - 1) / threads;
+					threads = static_cast<int>((count + chunk - 1) / chunk);
+					std::vector<T> partial(threads);
+					MATH_OMP(parallel for schedule(static) num_threads(threads))
+					for (int t = 0; t < threads; ++t)
+					{
+						const size_t begin = static_cast<size_t>(t) * chunk;
+						const size_t end = std::min(count, begin + chunk);
+						partial[t] = reduceRange<Op>(begin + 1, end, get(begin), get);
+					}
+					return reduceRange<Op>(1, partial.size(), partial[0], [&partial](size_t t) { return partial[t]; });
+				}
+				return reduceRange<Op>(1, count, get(0), get);
+			}
+			return withLines(e, [&e](auto layout, auto get)
+				{
+					typedef decltype(layout) L;
+					const size_t lines = L::rowMajor ? e.rows() : e.cols();
+					const size_t length = L::rowMajor ? e.cols() : e.rows();
+					T r = get(0, 0);
+					for (size_t line = 0; line < lines; ++line)
+					{
+						r = reduceRange<Op>(line == 0 ? 1 : 0, length, r, [&get, line](size_t k) { return get(line, k); });
+					}
+					return r;
+				});
+		}
+
+		/**
+		* @brief Reduction Op of non-empty expression along axis
+		*/
+		template <typename Op, typename E>
+		Matrix<typename E::value_type> reduceAxis(const E& e, Axis axis)
+		{
+			typedef typename E::value_type T;
+			Matrix<T> R = axis == Axis::Rows ? Matrix<T>(1, e.cols()) : Matrix<T>(e.rows(), 1);
+			T* r = R.data();
+			withLines(e, [&e, axis, r](auto layout, auto get)
+				{
+					typedef decltype(layout) L;
+					const size_t lines = L::rowMajor ? e.rows() : e.cols();
+					const size_t length = L::rowMajor ? e.cols() : e.rows();
+					if ((axis == Axis::Cols) == L::rowMajor)
+					{
+						// every line is reduced to one element
+						for (size_t line = 0; line < lines; ++line)
+						{
+							r[line] = reduceRange<Op>(1, length, static_cast<T>(get(line, 0)), [&get, line](size_t k) { return get(line, k); });
+						}
+					}
+					else
+					{
+						// lines are combined elementwise
+						for (size_t k = 0; k < length; ++k)
+						{
+							r[k] = get(0, k);
+						}
+						for (size_t line = 1; line < lines; ++line)
+						{
+							MATH_OMP(simd)
+							for (size_t k = 0; k < length; ++k)
+							{
+								r[k] = Op::apply(r[k], static_cast<T>(get(line, k)));
+							}
+						}
+					}
+				});
+			return R;
+		}
+
+		/// @brief Reductions of empty expressions aren't defined
+		template <typename E>
+		void checkNotEmpty(const E& e, const char* method)
+		{
+			if (e.rows() == 0 || e.cols() == 0)
+			{
+				throw(math::ExceptionInvalidValue(std::string(method) + ": reduction of empty matrix!"));
+			}
+		}
+	}
+
+	namespace expr
+	{
+		/**
+		 * @brief Node for unary function of elements (see math::map)
+		 */
+		template <typename E, typename F>
+		class Map :
+			public MatExpr<Map<E, F>>
+		{
+		public:
+			typedef std::decay_t<decltype(std::declval<const F&>()(std::declval<typename E::value_type>()))> value_type;
+
+			Map(const E& e, F f)
+				: e_(e), f_(std::move(f))
+			{
+			}
+
+			size_t rows() const
+			{
+				return e_.rows();
+			}
+
+			size_t cols() const
+			{
+				return e_.cols();
+			}
+
+			MatRep representation() const
+			{
+				return e_.representation();
+			}
+
+			bool linear() const
+			{
+				return expr::linear(e_);
+			}
+
+			bool aliases(const void* begin, const void* end) const
+			{
+				return expr::aliases(e_, begin, end);
+			}
+
+			value_type elem(size_t pos) const
+			{
+				return f_(e_.elem(pos));
+			}
+
+			value_type coeff(size_t row, size_t col) const
+			{
+				return f_(e_.coeff(row, col));
+			}
+
+		private:
+			typename Storage<E>::type e_;
+			F f_;
+		};
+
+		/**
+		 * @brief Node for binary function of elements with broadcasting (see math::zip)
+		 */
+		template <typename L, typename R, typename F>
+		class Zip :
+			public MatExpr<Zip<L, R, F>>
+		{
+		public:
+			typedef std::decay_t<decltype(std::declval<const F&>()(
+				std::declval<typename L::value_type>(), std::declval<typename R::value_type>()))> value_type;
+
+			Zip(const L& lhs, const R& rhs, F f)
+				: lhs_(lhs), rhs_(rhs), f_(std::move(f)),
+				rows_{ broadcast(lhs.rows(), rhs.rows()) }, cols_{ broadcast(lhs.cols(), rhs.cols()) },
+				// index of broadcast dimension is always 0
+				lr_{ lhs.rows() == rows_ }, lc_{ lhs.cols() == cols_ },
+				rr_{ rhs.rows() == rows_ }, rc_{ rhs.cols() == cols_ }
+			{
+				linear_ = lhs.rows() == rhs.rows() && lhs.cols() == rhs.cols() &&
+					(lhs.representation() == rhs.representation() || rows_ == 1 || cols_ == 1) &&
+					expr::linear(lhs) && expr::linear(rhs);
+			}
+
+			size_t rows() const
+			{
+				return rows_;
+			}
+
+			size_t cols() const
+			{
+				return cols_;
+			}
+
+			MatRep representation() const
+			{
+				return lhs_.representation();
+			}
+
+			bool linear() const
+			{
+				return linear_;
+			}
+
+			bool aliases(const void* begin, const void* end) const
+			{
+				return expr::aliases(lhs_, begin, end) || expr::aliases(rhs_, begin, end);
+			}
+
+			/// @brief Element at linear position, only for linear() expression
+			value_type elem(size_t pos) const
+			{
+				return f_(lhs_.elem(pos), rhs_.elem(pos));
+			}
+
+			value_type coeff(size_t row, size_t col) const
+			{
+				return f_(lhs_.coeff(row * lr_, col * lc_), rhs_.coeff(row * rr_, col * rc_));
+			}
+
+		private:
+			typename Storage<L>::type lhs_;
+			typename Storage<R>::type rhs_;
+			F f_;
+			size_t rows_;
+			size_t cols_;
+			size_t lr_, lc_, rr_, rc_;
+			bool linear_ = true;
+
+			/// @brief Dimension of result: dimensions must be equal or one of them must be 1
+			static size_t broadcast(size_t a, size_t b)
+			{
+				if (a != b && a != 1 && b != 1)
+				{
+					throw(math::ExceptionInvalidValue("zip: dimensions of matrices can't be broadcast!"));
+				}
+				return a == 1 ? b : a;
+			}
+		};
+	}
+
+	/**
+	* @brief Elementwise function of expression: result(i,j) = f(e(i,j))
+	* @details Lazy expression, evaluated on assignment to Matrix in one vectorized loop
+	* @code
+	* math::Matrix<double> S = math::map(A, [](double v) { return std::abs(v); });
+	* @endcode
+	*/
+	template <typename E, typename F>
+	expr::Map<E, F> map(const MatExpr<E>& e, F f)
+	{
+		return expr::Map<E, F>(e.self(), std::move(f));
+	}
+
+	/**
+	* @brief Elementwise function of two expressions with broadcasting: result(i,j) = f(a(i,j), b(i,j))
+	* @details Dimension of size 1 is broadcast to dimension of other operand, e.g. matrix m*n and
+	* row vector 1*n (the same row for every row of matrix) or column vector m*1. Representation of result
+	* is representation of a.
+	* @code
+	* // subtract mean of every column
+	* math::Matrix<double> C = math::zip(A, math::sum(A, math::Axis::Rows) * (1.0 / A.rows()),
+	*	[](double a, double m) { return a - m; });
+	* @endcode
+	* @throws math::ExceptionInvalidValue if dimensions can't be broadcast
+	*/
+	template <typename E1, typename E2, typename F>
+	expr::Zip<E1, E2, F> zip(const MatExpr<E1>& a, const MatExpr<E2>& b, F f)
+	{
+		return expr::Zip<E1, E2, F>(a.self(), b.self(), std::move(f));
+	}
+
+	/**
+	* @brief Sum of all elements (0 for empty expression)
+	*/
+	template <typename E>
+	typename E::value_type sum(const MatExpr<E>& e)
+	{
+		if (e.self().rows() == 0 || e.self().cols() == 0)
+		{
+			return static_cast<typename E::value_type>(0);
+		}
+		return detail::reduceAll<expr::Add>(e.self());
+	}
+
+	/**
+	* @brief Sums along axis
+	* @throws math::ExceptionInvalidValue for empty expression
+	*/
+	template <typename E>
+	Matrix<typename E::value_type> sum(const MatExpr<E>& e, Axis axis)
+	{
+		detail::checkNotEmpty(e.self(), "sum");
+		return detail::reduceAxis<expr::Add>(e.self(), axis);
+	}
+
+	/**
+	* @brief Minimal element
+	* @throws math::ExceptionInvalidValue for empty expression
+	*/
+	template <typename E>
+	typename E::value_type min(const MatExpr<E>& e)
+	{
+		detail::checkNotEmpty(e.self(), "min");
+		return detail::reduceAll<expr::Min>(e.self());
+	}
+
+	/**
+	* @brief Minimal elements along axis
+	* @throws math::ExceptionInvalidValue for empty expression
+	*/
+	template <typename E>
+	Matrix<typename E::value_type> min(const MatExpr<E>& e, Axis axis)
+	{
+		detail::checkNotEmpty(e.self(), "min");
+		return detail::reduceAxis<expr::Min>(e.self(), axis);
+	}
+
+	/**
+	* @brief Maximal element
+	* @throws math::ExceptionInvalidValue for empty expression
+	*/
+	template <typename E>
+	typename E::value_type max(const MatExpr<E>& e)
+	{
+		detail::checkNotEmpty(e.self(), "max");
+		return detail::reduceAll<expr::Max>(e.self());
+	}
+
+	/**
+	* @brief Maximal elements along axis
+	* @throws math::ExceptionInvalidValue for empty expression
+	*/
+	template <typename E>
+	Matrix<typename E::value_type> max(const MatExpr<E>& e, Axis axis)
+	{
+		detail::checkNotEmpty(e.self(), "max");
+		return detail::reduceAxis<expr::Max>(e.self(), axis);
+	}
+
+	/**
+	* @brief Position (row, col) of maximal element
+	* @details For equal elements the first one in order of representation() is returned
+	* @throws math::ExceptionInvalidValue for empty expression
+	*/
+	template <typename E>
+	std::pair<size_t, size_t> argmax(const MatExpr<E>& e)
+	{
+		detail::checkNotEmpty(e.self(), "argmax");
+		return detail::withLines(e.self(), [&e](auto layout, auto get)
+			{
+				typedef decltype(layout) L;
+				const size_t lines = L::rowMajor ? e.self().rows() : e.self().cols();
+				const size_t length = L::rowMajor ? e.self().cols() : e.self().rows();
+				auto best = get(0, 0);
+				size_t bestLine = 0;
+				size_t bestK = 0;
+				for (size_t line = 0; line < lines; ++line)
+				{
+					for (size_t k = 0; k < length; ++k)
+					{
+						const auto v = get(line, k);
+						if (best < v)
+						{
+							best = v;
+							bestLine = line;
+							bestK = k;
+						}
+					}
+				}
+				return L::rowMajor ? std::make_pair(bestLine, bestK) : std::make_pair(bestK, bestLine);
+			});
+	}
+
+	/**
+	* @brief Indices of maximal elements along axis
+	* @return For Axis::Rows - row index of maximum of every column, for Axis::Cols - column index of maximum of every row.
+	* For equal elements the smallest index is returned.
+	* @throws math::ExceptionInvalidValue for empty expression
+	*/
+	template <typename E>
+	std::vector<size_t> argmax(const MatExpr<E>& e, Axis axis)
+	{
+		typedef typename E::value_type T;
+		detail::checkNotEmpty(e.self(), "argmax");
+		const size_t m = e.self().rows();
+		const size_t n = e.self().cols();
+		std::vector<size_t> index(axis == Axis::Rows ? n : m, 0);
+		std::vector<T> best(index.size());
+		detail::withLines(e.self(), [&](auto layout, auto get)
+			{
+				typedef decltype(layout) L;
+				const size_t lines = L::rowMajor ? m : n;
+				const size_t length = L::rowMajor ? n : m;
+				// result is indexed by k (lines are combined) or by line (every line is reduced)
+				const bool byLine = (axis == Axis::Cols) == L::rowMajor;
+				for (size_t line = 0; line < lines; ++line)
+				{
+					for (size_t k = 0; k < length; ++k)
+					{
+						const T v = get(line, k);
+						const size_t q = byLine ? line : k;
+						const size_t idx = byLine ? k : line;
+						if (idx == 0 || best[q] < v)
+						{
+							best[q] = v;
+							index[q] = idx;
+						}
+					}
+				}
+			});
+		return index;
+	}
+
+	template <typename E>
+	auto MatExpr<E>::pnorm(const int p) const
+	{
+		typedef typename E::value_type T;
+		// T for floating point elements (float builds don't compute in double), double for integers
+		typedef decltype(std::pow(T(), T())) norm_type;
+		const E& e = self();
+		// common norms without std::pow
+		if (p == 1)
+		{
+			return static_cast<norm_type>(sum(map(e, [](T v) { return std::abs(v); })));
+		}
+		if (p == 2)
+		{
+			return static_cast<norm_type>(std::sqrt(sum(map(e, [](T v) { return v * v; }))));
+		}
+		return static_cast<norm_type>(std::pow(sum(map(e, [p](T v) { return std::pow(static_cast<norm_type>(std::abs(v)), static_cast<norm_type>(p)); })),
+			static_cast<norm_type>(1) / static_cast<norm_type>(p)));
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/blas.h>
+
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Interface of linear operator @f$ \mathbf{A} @f$, which is known only by its action on vectors
+	* @details Iterative (Krylov) solvers need nothing but products @f$ \mathbf{A} \mathbf{x} @f$, so
+	* sparse matrices and matrix-free operators can be passed to them without densifying.
+	* @see SparseMatrix, DenseOperator
+	*/
+	template <typename T>
+	class LinearOperator
+	{
+	public:
+		virtual ~LinearOperator() = default;
+
+		/// @brief Number of rows
+		virtual size_t rows() const = 0;
+
+		/// @brief Number of columns
+		virtual size_t cols() const = 0;
+
+		/**
+		* @brief Product @f$ \mathbf{y} = \alpha \mathbf{A} \mathbf{x} + \beta \mathbf{y} @f$
+		* @param x: Vector of cols() elements
+		* @param y[in,out]: Vector of rows() elements
+		*/
+		virtual void apply(T alpha, const Matrix<T>& x, T beta, Matrix<T>& y) const = 0;
+	};
+
+	/**
+	* @brief Dense matrix as LinearOperator
+	* @details Matrix is held by reference and must outlive the operator
+	*/
+	template <typename T>
+	class DenseOperator :
+		public LinearOperator<T>
+	{
+	public:
+		explicit DenseOperator(const Matrix<T>& A)
+			: A_(A)
+		{
+		}
+
+		virtual size_t rows() const override
+		{
+			return A_.rows();
+		}
+
+		virtual size_t cols() const override
+		{
+			return A_.cols();
+		}
+
+		/// @brief LinearOperator::apply
+		virtual void apply(T alpha, const Matrix<T>& x, T beta, Matrix<T>& y) const override
+		{
+			gemv(alpha, A_, x, beta, y);
+		}
+
+	private:
+		const Matrix<T>& A_;
+	};
+}
@@ -0,0 +1,550 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <libmath/blas/lu.h>
+#include <libmath/blas/condest.h>
+#include <libmath/blas/layout.h>
+#include <libmath/blas/packed.h>
+#include <libmath/triangular.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace math
+{
+	template <typename T>
+	class TriangularMatrix;
+
+	/**
+	* @brief LU factorization with partial pivoting @f$ \mathbf{P} \mathbf{A} = \mathbf{L} \mathbf{U} @f$
+	* @details Matrix is factorized once (blocked algorithm, see blas::getrf), after that any number of
+	* right-hand sides can be solved in place by forward and back substitution.
+	* Determinant and inverse matrix are computed from the same factorization.
+	*
+	* Example of using in C++:
+	* @code
+	* #include <libmath/lu.h>
+	*
+	* int main()
+	* {
+	*	math::Matrix<double> A = { {4.0, 3.0}, {6.0, 3.0} };
+	*	math::LU<double> lu(A);
+	*
+	*	math::Matrix<double> B = { {1.0, 0.0}, {0.0, 1.0} };
+	*	lu.solveInPlace(B); // B = A^-1 * B
+	*
+	*	double d = lu.det();
+	* }
+	* @endcode
+	*/
+	template <typename T>
+	class LU
+	{
+	public:
+		/**
+		* @brief Empty factorization, factorize() must be called before use
+		*/
+		LU() = default;
+
+		/**
+		* @brief Factorize matrix A
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		explicit LU(const Matrix<T>& A)
+		{
+			factorize(A);
+		}
+
+		/**
+		* @brief Factorize matrix A, previous factorization is replaced
+		* @details Storage of previous factorization of the same size is reused. In OpenMP builds matrices
+		* from settings::Settings::luParallelThreshold (disabled by default) are factorized on
+		* settings::Settings::numThreads threads.
+		* Singular matrix is factorized too (see singular()), but can't be used for solving.
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		void factorize(const Matrix<T>& A)
+		{
+			if (A.rows() != A.cols())
+			{
+				throw(math::ExceptionNonSquareMatrix("LU: matrix must be square!"));
+			}
+			const size_t n = A.rows();
+			// factors are stored in representation of A, kernels are specialized for the layout
+			lu_ = A;
+			piv_.resize(n);
+			work_.resize(2 * n);
+			anorm_ = blas::norm1(n, n, A.data(), A.rowStride(), A.colStride(), work_.data());
+			const size_t threshold = settings::CurrentSettings.luParallelThreshold;
+			const int threads = threshold != 0 && n >= threshold ? detail::parallelThreads() : 1;
+			info_ = detail::withLayout(lu_.representation(), [this, n, threads](auto layout)
+				{
+					return blas::getrf<decltype(layout)>(n, lu_.data(), n, piv_.data(), threads);
+				});
+			factorized_ = true;
+		}
+
+		/// @brief Was factorize() called
+		bool factorized() const
+		{
+			return factorized_;
+		}
+
+		/// @brief Factorized matrix is singular (U has zero on diagonal)
+		bool singular() const
+		{
+			return info_ != 0;
+		}
+
+		/// @brief Dimension of factorized matrix
+		size_t size() const
+		{
+			return lu_.rows();
+		}
+
+		/**
+		* @brief Combined matrix L+U-E of P*A (in representation of factorized matrix)
+		*/
+		const Matrix<T>& matrix() const
+		{
+			return lu_;
+		}
+
+		/**
+		* @brief Unit lower triangular factor L of P*A in packed storage
+		*/
+		TriangularMatrix<T> lower() const
+		{
+			const size_t n = size();
+			TriangularMatrix<T> L(n, Uplo::Lower);
+			T* l = L.packed().data();
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t j = 0; j < i; ++j)
+				{
+					*l++ = lu_.coeff(i, j);
+				}
+				*l++ = static_cast<T>(1);
+			}
+			return L;
+		}
+
+		/**
+		* @brief Upper triangular factor U of P*A in packed storage
+		*/
+		TriangularMatrix<T> upper() const
+		{
+			const size_t n = size();
+			TriangularMatrix<T> U(n, Uplo::Upper);
+			T* u = U.packed().data();
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t j = i; j < n; ++j)
+				{
+					*u++ = lu_.coeff(i, j);
+				}
+			}
+			return U;
+		}
+
+		/**
+		* @brief Pivot indices: row k was swapped with row pivots()[k] on step k
+		*/
+		const std::vector<size_t>& pivots() const
+		{
+			return piv_;
+		}
+
+		/**
+		* @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$ in place: B is replaced by X
+		* @param B[in,out]: Matrix n*m of any representation (m right-hand sides)
+		* @throws math::ExceptionIncorrectMatrix
+		* @throws math::ExceptionDegenerateMatrix
+		*/
+		void solveInPlace(Matrix<T>& B) const
+		{
+			check("solveInPlace");
+			if (B.rows() != size())
+			{
+				throw(math::ExceptionIncorrectMatrix("LU::solveInPlace: dimensions of factorized matrix and B didn't agree!"));
+			}
+			detail::withLayout(lu_.representation(), [this, &B](auto layout)
+				{
+					blas::getrs<decltype(layout)>(size(), lu_.data(), size(), piv_.data(),
+						B.cols(), B.data(), B.rowStride(), B.colStride());
+				});
+		}
+
+		/**
+		* @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$
+		* @return X with dimensions and representation of B
+		* @throws math::ExceptionIncorrectMatrix
+		* @throws math::ExceptionDegenerateMatrix
+		*/
+		Matrix<T> solve(const Matrix<T>& B) const
+		{
+			Matrix<T> X(B);
+			solveInPlace(X);
+			return X;
+		}
+
+		/**
+		* @brief Determinant of factorized matrix, 0 for singular matrix
+		*/
+		T det() const
+		{
+			if (!factorized_)
+			{
+				throw(math::Exception("LU::det: matrix isn't factorized!"));
+			}
+			if (singular())
+			{
+				return static_cast<T>(0);
+			}
+			T d = static_cast<T>(1);
+			const size_t n = size();
+			const T* a = lu_.data();
+			for (size_t k = 0; k < n; ++k)
+			{
+				// diagonal has the same position in both layouts
+				d *= a[k * n + k];
+				if (piv_[k] != k)
+				{
+					d = -d;
+				}
+			}
+			return d;
+		}
+
+		/**
+		* @brief Estimate of reciprocal condition number @f$ 1 / (\|\mathbf{A}\|_1 \|\mathbf{A}^{-1}\|_1) @f$
+		* @details O(n^2): norm of A^-1 is estimated by a few solves with the factorization (see blas::invNorm1Estimate),
+		* norm of A is saved by factorize(). Value close to 0 means nearly singular matrix, e.g. compare with
+		* machine epsilon or with 1 / (limit of condition number). 0 for singular matrix.
+		* Uses workspace of the object, so mustn't be called concurrently for the same object.
+		*/
+		T rcond() const
+		{
+			if (!factorized_)
+			{
+				throw(math::Exception("LU::rcond: matrix isn't factorized!"));
+			}
+			if (singular() || anorm_ == static_cast<T>(0))
+			{
+				return static_cast<T>(0);
+			}
+			const size_t n = size();
+			const T ainvnorm = detail::withLayout(lu_.representation(), [this, n](auto layout)
+				{
+					typedef decltype(layout) L;
+					return blas::invNorm1Estimate<T>(n,
+						[this, n](T* x) { blas::getrs<L>(n, lu_.data(), n, piv_.data(), 1, x, 1, 1); },
+						[this, n](T* x) { blas::getrsT<L>(n, lu_.data(), n, piv_.data(), x, 1); },
+						work_.data());
+				});
+			return ainvnorm == static_cast<T>(0) ? static_cast<T>(0) : static_cast<T>(1) / (anorm_ * ainvnorm);
+		}
+
+		/**
+		* @brief Estimate of condition number in 1-norm @f$ \|\mathbf{A}\|_1 \|\mathbf{A}^{-1}\|_1 @f$ (see rcond()),
+		* infinity for singular matrix
+		*/
+		T cond() const
+		{
+			const T r = rcond();
+			return r == static_cast<T>(0) ? std::numeric_limits<T>::infinity() : static_cast<T>(1) / r;
+		}
+
+		/**
+		* @brief Inverse of factorized matrix
+		* @param repr: Representation of the inverse (row-oriented by default)
+		* @throws math::ExceptionDegenerateMatrix
+		*/
+		Matrix<T> inverse(MatRep repr = MatRep::Row) const
+		{
+			const size_t n = size();
+			Matrix<T> X(n, n, repr);
+			T* x = X.data();
+			for (size_t i = 0; i < n; ++i)
+			{
+				x[i * n + i] = static_cast<T>(1);
+			}
+			solveInPlace(X);
+			return X;
+		}
+
+	private:
+		/// @brief Combined matrix L+U-E
+		Matrix<T> lu_;
+		/// @brief Pivot indices
+		std::vector<size_t> piv_;
+		/// @brief Result of blas::getrf (0 - non singular)
+		size_t info_ = 0;
+		/// @brief 1-norm of factorized matrix
+		T anorm_ = static_cast<T>(0);
+		/// @brief Workspace of norm and condition estimates (2n elements), so rcond() doesn't allocate memory
+		mutable std::vector<T> work_;
+		bool factorized_ = false;
+
+		void check(const char* method) const
+		{
+			if (!factorized_)
+			{
+				throw(math::Exception(std::string("LU::") + method + ": matrix isn't factorized!"));
+			}
+			if (singular())
+			{
+				throw(math::ExceptionDegenerateMatrix(std::string("LU::") + method + ": matrix is singular!"));
+			}
+		}
+	};
+
+	/**
+	* @brief LU solve with mixed precision iterative refinement
+	* @details Matrix is factorized in low precision Low (float: FPU of ESP32-S3 accelerates only single
+	* precision), solution is refined in precision T: residual @f$ \mathbf{r} = \mathbf{b} - \mathbf{A} \mathbf{x} @f$
+	* is computed in T, correction @f$ \mathbf{A} \mathbf{d} = \mathbf{r} @f$ - by low precision factors.
+	* For matrices with condition number well below 1/epsilon(Low) solution reaches accuracy of T in a few
+	* iterations. Refinement stops, if for every column
+	* @f$ \|\mathbf{r}\|_\infty \le \|\mathbf{x}\|_\infty \|\mathbf{A}\|_\infty \epsilon_T \sqrt{n} @f$ (as in LAPACK dsgesv).
+	* If it doesn't converge in maxIterations or residual stagnates (ill-conditioned matrix, or elements overflow Low),
+	* matrix is factorized in T and the system is solved directly; this factorization is kept for later solves.
+	*
+	* Example of using in C++ (works in float builds too, see MATH_SINGLE_PRECISION):
+	* @code
+	* #include <libmath/lu.h>
+	*
+	* int main()
+	* {
+	*	math::Matrix<double> A = { {4.0, 3.0}, {6.0, 3.0} };
+	*	math::Matrix<double> b = { {1.0}, {2.0} };
+	*	math::MixedPrecisionLU<double, float> lu(A);
+	*	math::Matrix<double> x = lu.solve(b);
+	*	bool refined = lu.converged(); // false: fallback to factorization in double was used
+	* }
+	* @endcode
+	*/
+	template <typename T = double, typename Low = float>
+	class MixedPrecisionLU
+	{
+	public:
+		/// @brief Default limit of refinement iterations (as in LAPACK dsgesv)
+		static constexpr size_t defaultIterations = 30;
+
+		/**
+		* @brief Empty factorization, factorize() must be called before use
+		*/
+		MixedPrecisionLU() = default;
+
+		/**
+		* @brief Factorize matrix A
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		explicit MixedPrecisionLU(const Matrix<T>& A, size_t maxIterations = defaultIterations) :
+			maxIterations_{ maxIterations }
+		{
+			factorize(A);
+		}
+
+		/**
+		* @brief Factorize matrix A in precision Low, previous factorization is replaced
+		* @details A is kept in precision T for residuals, storage of the previous factorization is reused.
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		void factorize(const Matrix<T>& A)
+		{
+			if (A.rows() != A.cols())
+			{
+				throw(math::ExceptionNonSquareMatrix("MixedPrecisionLU: matrix must be square!"));
+			}
+			a_ = A;
+			const size_t n = A.rows();
+			// infinity norm of A is 1-norm of A^T
+			anorm_ = blas::norm1(n, n, a_.data(), a_.colStride(), a_.rowStride());
+			convert(a_, low_);
+			lowLu_.factorize(low_);
+			fallback_ = lowLu_.singular();
+			if (fallback_)
+			{
+				lu_.factorize(a_);
+			}
+			iterations_ = 0;
+			converged_ = false;
+		}
+
+		/// @brief Was factorize() called
+		bool factorized() const
+		{
+			return lowLu_.factorized();
+		}
+
+		/// @brief Dimension of factorized matrix
+		size_t size() const
+		{
+			return a_.rows();
+		}
+
+		/// @brief Number of refinement iterations of the last solve
+		size_t iterations() const
+		{
+			return iterations_;
+		}
+
+		/// @brief Refinement of the last solve converged (otherwise system was solved by factorization in T)
+		bool converged() const
+		{
+			return converged_;
+		}
+
+		/**
+		* @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$ in place: B is replaced by X
+		* @param B[in,out]: Matrix n*m of any representation (m right-hand sides)
+		* @throws math::ExceptionIncorrectMatrix
+		* @throws math::ExceptionDegenerateMatrix
+		*/
+		void solveInPlace(Matrix<T>& B)
+		{
+			if (!factorized())
+			{
+				throw(math::Exception("MixedPrecisionLU::solveInPlace: matrix isn't factorized!"));
+			}
+			if (B.rows() != size())
+			{
+				throw(math::ExceptionIncorrectMatrix("MixedPrecisionLU::solveInPlace: dimensions of factorized matrix and B didn't agree!"));
+			}
+			iterations_ = 0;
+			converged_ = false;
+			if (!fallback_)
+			{
+				converged_ = refine(B);
+				if (!converged_)
+				{
+					fallback_ = true;
+					lu_.factorize(a_);
+				}
+			}
+			if (!converged_)
+			{
+				lu_.solveInPlace(B);
+			}
+		}
+
+		/**
+		* @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$
+		* @return X with dimensions and representation of B
+		* @throws math::ExceptionIncorrectMatrix
+		* @throws math::ExceptionDegenerateMatrix
+		*/
+		Matrix<T> solve(const Matrix<T>& B)
+		{
+			Matrix<T> X(B);
+			solveInPlace(X);
+			return X;
+		}
+
+	private:
+		/// @brief Factorized matrix in precision T
+		Matrix<T> a_;
+		/// @brief Infinity norm of factorized matrix
+		T anorm_ = static_cast<T>(0);
+		/// @brief Factorization in precision Low
+		LU<Low> lowLu_;
+		/// @brief Storage of matrix (by factorize()) and corrections (by solve()) in precision Low
+		Matrix<Low> low_;
+		/// @brief Residuals in precision T
+		Matrix<T> r_;
+		/// @brief Factorization in precision T (if refinement failed)
+		LU<T> lu_;
+		size_t maxIterations_ = defaultIterations;
+		size_t iterations_ = 0;
+		bool converged_ = false;
+		/// @brief Refinement failed, lu_ is used
+		bool fallback_ = false;
+
+		/// @brief dst = src elementwise with the same dimensions and representation
+		template <typename From, typename To>
+		static void convert(const Matrix<From>& src, Matrix<To>& dst)
+		{
+			if (dst.rows() != src.rows() || dst.cols() != src.cols() || dst.representation() != src.representation())
+			{
+				dst = Matrix<To>(src.rows(), src.cols(), src.representation());
+			}
+			const From* s = src.data();
+			To* d = dst.data();
+			for (size_t i = 0; i < src.numel(); ++i)
+			{
+				d[i] = static_cast<To>(s[i]);
+			}
+		}
+
+		/**
+		* @brief Solve by low precision factors with refinement, B is replaced by X
+		* @return false if refinement didn't converge (B is unchanged then)
+		*/
+		bool refine(Matrix<T>& B)
+		{
+			const size_t n = size();
+			const size_t m = B.cols();
+			const T cte = anorm_ * std::numeric_limits<T>::epsilon() * std::sqrt(static_cast<T>(n));
+
+			// X = A^-1 * B in precision Low
+			convert(B, low_);
+			lowLu_.solveInPlace(low_);
+			Matrix<T> X(n, m, B.representation());
+			convert(low_, X);
+
+			// relative residual of the previous iteration
+			T previous = std::numeric_limits<T>::infinity();
+			for (size_t iter = 0; iter <= maxIterations_; ++iter)
+			{
+				// R = B - A * X
+				r_ = B;
+				blas::gemm(n, m, n, static_cast<T>(-1), a_.data(), a_.rowStride(), a_.colStride(),
+					X.data(), X.rowStride(), X.colStride(), static_cast<T>(1), r_.data(), r_.rowStride(), r_.colStride());
+
+				bool done = true;
+				T ratio = static_cast<T>(0);
+				for (size_t j = 0; j < m; ++j)
+				{
+					const T* r = r_.data() + j * r_.colStride();
+					const T rnorm = blas::nrmInf(n, r, r_.rowStride());
+					const T xnorm = blas::nrmInf(n, X.data() + j * X.colStride(), X.rowStride());
+					// overflow in Low gives NaN, which is skipped by nrmInf, but not by sum
+					if (!std::isfinite(blas::nrm1(n, r, r_.rowStride())))
+					{
+						return false;
+					}
+					done = done && rnorm <= xnorm * cte;
+					ratio = std::max(ratio, rnorm / std::max(xnorm * cte, std::numeric_limits<T>::min()));
+				}
+				if (done)
+				{
+					B = X;
+					return true;
+				}
+				// residual must decrease at least twice per iteration, otherwise matrix is too ill-conditioned for Low
+				if (iter == maxIterations_ || (iter > 0 && ratio > static_cast<T>(0.5) * previous))
+				{
+					break;
+				}
+				previous = ratio;
+
+				// X = X + A^-1 * R in precision Low
+				convert(r_, low_);
+				lowLu_.solveInPlace(low_);
+				const Low* d = low_.data();
+				T* x = X.data();
+				for (size_t i = 0; i < X.numel(); ++i)
+				{
+					x[i] += static_cast<T>(d[i]);
+				}
+				++iterations_;
+			}
+			return false;
+		}
+	};
+}
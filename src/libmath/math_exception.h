@@ -110,4 +110,18 @@ namespace math
 			type_ = "TooManyIterations";
 		}
 	};
+
+	/**
+	* @brief Exception input/output error (file can't be opened, read, written or has wrong format)
+	*/
+	class ExceptionIO :
+		public Exception
+	{
+	public:
+		ExceptionIO(const std::string& m)
+			: Exception(m)
+		{
+			type_ = "IO";
+		}
+	};
 }
\ No newline at end of file
@@ -1,13 +1,53 @@
 #pragma once
 
+#include <cstddef>
+
 namespace math
 {
-	/// @brief Precision
+	/// @brief Precision policy of math::real, shared with robo::real (see defines.h)
+	/// @details Double precision by default. Define MATH_SINGLE_PRECISION (build flag) to build
+	/// everything in float: FPU of ESP32-S3 accelerates only single precision, double is emulated.
+	/// Solvers work in math::real; for double accuracy of linear systems with float factorization
+	/// use MixedPrecisionLU<double, float> explicitly.
+#ifndef MATH_SINGLE_PRECISION
 #define MATH_DOUBLE_PRECISION_DEFINE
+#endif
 #ifdef MATH_DOUBLE_PRECISION_DEFINE
 	typedef double real;
 #else
 	typedef float real;
+#endif
+
+	/// @brief Bounds checking policy of element access
+	/// @details Checks are on in debug builds and off in release builds (NDEBUG defined).
+	/// Define MATH_BOUNDS_CHECK to 0 or 1 to override.
+#ifndef MATH_BOUNDS_CHECK
+#ifdef NDEBUG
+#define MATH_BOUNDS_CHECK 0
+#else
+#define MATH_BOUNDS_CHECK 1
+#endif
+#endif
+
+	/// @brief Number of elements of math::Matrix stored inline without heap allocation
+	/// @details Covers 3x3, 4x4 and smaller matrices. Define MATH_MATRIX_INLINE_SIZE to override, 0 disables inline storage.
+#ifndef MATH_MATRIX_INLINE_SIZE
+#define MATH_MATRIX_INLINE_SIZE 16
+#endif
+
+	/// @brief Alignment of heap storage of math::Matrix and work buffers in bytes (cache line and AVX-512 vector)
+	/// @details Define MATH_ALIGNMENT to override, value must be a power of 2.
+#ifndef MATH_ALIGNMENT
+#define MATH_ALIGNMENT 64
+#endif
+
+	/// @brief OpenMP directive, e.g. MATH_OMP(parallel for schedule(static))
+	/// @details Directive is emitted only in OpenMP builds, so kernels compile without warnings on toolchains without OpenMP (ESP32).
+#define MATH_STRINGIFY(x) #x
+#ifdef _OPENMP
+#define MATH_OMP(directive) _Pragma(MATH_STRINGIFY(omp directive))
+#else
+#define MATH_OMP(directive)
 #endif
 }
 
@@ -22,8 +62,29 @@ namespace math::settings
 		/// @brief Number of threads for parallel executions
 		/// @details If threads = 0 all available cores are used
 		int numThreads = 4;
+
+		/// @brief Minimal number of elements, from which elementwise kernels and reductions run on numThreads threads
+		/// @details 0 disables parallel execution (default). Has effect only in OpenMP builds.
+		size_t parallelThreshold = 0;
+
+		/// @brief Minimal dimension, from which LU factorizes matrices on numThreads threads (see blas::getrf)
+		/// @details 0 disables parallel factorization (default). Has effect only in OpenMP builds.
+		size_t luParallelThreshold = 0;
 	};
 
+	/// @brief Bounds checking of element access is enabled
+	/// @see MATH_BOUNDS_CHECK
+	constexpr bool boundsCheck = MATH_BOUNDS_CHECK;
+
+	/// @brief Number of elements of math::Matrix stored inline
+	/// @see MATH_MATRIX_INLINE_SIZE
+	constexpr size_t matrixInlineSize = MATH_MATRIX_INLINE_SIZE;
+
+	/// @brief Alignment of heap storage in bytes
+	/// @see MATH_ALIGNMENT
+	constexpr size_t alignment = MATH_ALIGNMENT;
+	static_assert((alignment & (alignment - 1)) == 0, "MATH_ALIGNMENT must be a power of 2");
+
 	/// @brief Default properties
 	inline Settings DefaultSettings;
 
@@ -3,8 +3,19 @@
 #include <libmath/math_exception.h>
 #include <libmath/math_settings.h>
 #include <libmath/boolean.h>
+#include <libmath/matrix_expr.h>
+#include <libmath/elementwise.h>
+#include <libmath/stride_iterator.h>
+#include <libmath/span.h>
+#include <libmath/small_vector.h>
+#include <libmath/matrix_view.h>
+#include <libmath/blas/gemm.h>
+#include <libmath/blas/level1.h>
+#include <libmath/blas/transpose.h>
+#include <libmath/blas/small.h>
 
 #include <vector>
+#include <utility>
 #include <iostream>
 #include <iomanip>
 #include <type_traits>
@@ -16,19 +27,24 @@
 
 namespace math
 {
-	//! Enum class for matrix representation definition
-	//! @sa repr_
-	enum class MatRep
-	{
-		Row = 0,
-		Column
-	};
 	//! Class Matrix
-	/* Class representing matrix of type T
+	/* Class representing matrix of type T.
+	 * Elementwise and scalar arithmetic builds lazy expressions (see MatExpr),
+	 * which are evaluated in a single loop on assignment to Matrix.
 	 */
 	template <typename T>
-	class Matrix
+	class TransposeView;
+
+	template <typename T>
+	class LU;
+
+	template <typename T>
+	class Matrix :
+		public MatExpr<Matrix<T>>
 	{
+	public:
+		/// @brief Type of elements
+		typedef T value_type;
 
 	private:
 		//! Number of rows
@@ -36,7 +52,8 @@ namespace math
 		//! Numner of columns
 		size_t cols_;
 		//! Internal serial container for matrix storage
-		std::vector<T> mvec_;
+		/*! Matrices up to settings::matrixInlineSize elements are stored inside the object without heap allocation */
+		SmallVector<T, settings::matrixInlineSize> mvec_;
 		//! Type of matrix representation
 		/*! Representation can be:
 			- row (=0, storage row by row)
@@ -54,7 +71,13 @@ namespace math
 		/**
 		 * @brief The copy constructor
 		 */
-		Matrix(const Matrix<T>& matrix);
+		Matrix(const Matrix<T>& matrix) = default;
+
+		/**
+		 * @brief The move constructor
+		 * @details Storage of matrix is taken without copy, matrix becomes empty
+		 */
+		Matrix(Matrix<T>&& matrix) noexcept;
 
 		/**
 		 * @brief Square matrix constructor
@@ -94,15 +117,39 @@ namespace math
 		template <class T1>
 		Matrix(std::initializer_list<std::initializer_list<T1>> listMatrix);
 
-		~Matrix()
-		{
+		/**
+		 * @brief Construct matrix by evaluation of matrix expression
+		 * @param expr Expression (e.g. A + n * B)
+		 * @return Matrix with dimensions and representation of expression
+		 */
+		template <typename E>
+		Matrix(const MatExpr<E>& expr);
+
+		/**
+		 * @brief Copy assignment
+		 */
+		Matrix<T>& operator=(const Matrix<T>& matrix) = default;
 
-		};
+		/**
+		 * @brief Move assignment
+		 * @details Storage of matrix is taken without copy, matrix becomes empty
+		 */
+		Matrix<T>& operator=(Matrix<T>&& matrix) noexcept;
+
+		/**
+		 * @brief Assign result of matrix expression
+		 * @details Expression is evaluated element by element in a single loop without temporary matrices.
+		 * Matrix of the same size keeps its representation, otherwise representation of expression is taken.
+		 * Aliasing of *this in expression is allowed: elementwise reading of *this is evaluated in place,
+		 * expression with view of *this (e.g. C = C.t() + C) is evaluated to temporary matrix.
+		 */
+		template <typename E>
+		Matrix<T>& operator=(const MatExpr<E>& expr);
 
 		/**
 		* @brief Matrix representation
 		*/
-		MatRep representation()
+		MatRep representation() const
 		{
 			return repr_;
 		}
@@ -132,26 +179,230 @@ namespace math
 		}
 
 		/**
-		 * @brief get internal vector
+		 * @brief non-owning view of internal storage
+		 * @details Elements are not copied, so span is valid until matrix is resized or destroyed
+		 */
+		Span<T> vectorized()
+		{
+			return Span<T>(mvec_.data(), mvec_.size());
+		}
+
+		/**
+		 * @brief const version of vectorized()
+		 */
+		Span<const T> vectorized() const
+		{
+			return Span<const T>(mvec_.data(), mvec_.size());
+		}
+
+
+		/**
+		 * @brief pointer to contiguous internal storage
+		 * @details Elements are stored row by row or column by column, depending on representation()
+		 */
+		T* data()
+		{
+			return mvec_.data();
+		}
+
+		/**
+		 * @brief const version of data()
+		 */
+		const T* data() const
+		{
+			return mvec_.data();
+		}
+
+		/**
+		 * @brief Strided view of the whole matrix
+		 * @details View is valid until matrix is resized or destroyed
 		 */
-		std::vector<T> vectorized()
+		MatrixView<T> view()
 		{
-			return mvec_;
+			return MatrixView<T>(mvec_.data(), rows_, cols_, rowStride(), colStride());
+		}
+
+		MatrixView<const T> view() const
+		{
+			return MatrixView<const T>(mvec_.data(), rows_, cols_, rowStride(), colStride());
+		}
+
+		/**
+		 * @brief View of block rows*cols starting from element (row, col) without copy
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		MatrixView<T> block(size_t row, size_t col, size_t rows, size_t cols)
+		{
+			return view().block(row, col, rows, cols);
+		}
+
+		MatrixView<const T> block(size_t row, size_t col, size_t rows, size_t cols) const
+		{
+			return view().block(row, col, rows, cols);
 		}
 
 		/**
-		 * @brief get internal vector
+		 * @brief View of row as row vector 1*cols() without copy
+		 * @throws math::ExceptionIndexOutOfBounds
 		 */
-		std::vector<T> vectorized() const
+		MatrixView<T> row(size_t row)
 		{
-			return mvec_;
+			return view().row(row);
 		}
 
+		MatrixView<const T> row(size_t row) const
+		{
+			return view().row(row);
+		}
+
+		/**
+		 * @brief View of column as column vector rows()*1 without copy
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		MatrixView<T> col(size_t col)
+		{
+			return view().col(col);
+		}
+
+		MatrixView<const T> col(size_t col) const
+		{
+			return view().col(col);
+		}
+
+		/**
+		 * @brief View of main diagonal as column vector without copy
+		 */
+		MatrixView<T> diag()
+		{
+			return view().diag();
+		}
+
+		MatrixView<const T> diag() const
+		{
+			return view().diag();
+		}
+
+		/**
+		 * @brief iterators over internal storage (in order of representation)
+		 */
+		T* begin()
+		{
+			return mvec_.data();
+		}
+
+		T* end()
+		{
+			return mvec_.data() + mvec_.size();
+		}
+
+		const T* begin() const
+		{
+			return mvec_.data();
+		}
+
+		const T* end() const
+		{
+			return mvec_.data() + mvec_.size();
+		}
+
+		/**
+		 * @brief distance in storage between elements (i,j) and (i+1,j)
+		 */
+		size_t rowStride() const
+		{
+			return repr_ == MatRep::Row ? cols_ : 1;
+		}
+
+		/**
+		 * @brief distance in storage between elements (i,j) and (i,j+1)
+		 */
+		size_t colStride() const
+		{
+			return repr_ == MatRep::Row ? 1 : rows_;
+		}
+
+		/**
+		 * @brief iterators over elements of row
+		 * @param row row number (starting from 0)
+		 */
+		StrideIterator<T> rowBegin(size_t row)
+		{
+			return StrideIterator<T>(mvec_.data() + row * rowStride(), colStride());
+		}
+
+		StrideIterator<T> rowEnd(size_t row)
+		{
+			return StrideIterator<T>(mvec_.data() + row * rowStride(), colStride(), cols_);
+		}
+
+		StrideIterator<const T> rowBegin(size_t row) const
+		{
+			return StrideIterator<const T>(mvec_.data() + row * rowStride(), colStride());
+		}
+
+		StrideIterator<const T> rowEnd(size_t row) const
+		{
+			return StrideIterator<const T>(mvec_.data() + row * rowStride(), colStride(), cols_);
+		}
+
+		/**
+		 * @brief iterators over elements of column
+		 * @param col column number (starting from 0)
+		 */
+		StrideIterator<T> colBegin(size_t col)
+		{
+			return StrideIterator<T>(mvec_.data() + col * colStride(), rowStride());
+		}
+
+		StrideIterator<T> colEnd(size_t col)
+		{
+			return StrideIterator<T>(mvec_.data() + col * colStride(), rowStride(), rows_);
+		}
+
+		StrideIterator<const T> colBegin(size_t col) const
+		{
+			return StrideIterator<const T>(mvec_.data() + col * colStride(), rowStride());
+		}
+
+		StrideIterator<const T> colEnd(size_t col) const
+		{
+			return StrideIterator<const T>(mvec_.data() + col * colStride(), rowStride(), rows_);
+		}
+
+		/**
+		 * @brief element at linear position pos of internal storage (expression interface)
+		 */
+		T elem(size_t pos) const
+		{
+			return mvec_[pos];
+		}
+
+		/**
+		 * @brief element at position (i,j) without bounds checking
+		 * @param row row number (starting from 0)
+		 * @param col column number (starting from 0)
+		 */
+		T coeff(size_t row, size_t col) const
+		{
+			return mvec_[row * rowStride() + col * colStride()];
+		}
+
+		/**
+		 * @brief reference to element at position (i,j) without bounds checking
+		 * @param row row number (starting from 0)
+		 * @param col column number (starting from 0)
+		 */
+		T& coeffRef(size_t row, size_t col)
+		{
+			return mvec_[row * rowStride() + col * colStride()];
+		}
 
 		/**
 		 * @brief get reference to element at specified position (i,j)
+		 * @details Indices are checked only if settings::boundsCheck is enabled (debug builds)
 		 * @param row row number (starting from 0)
 		 * @param col column number (starting from 0)
+		 * @throws math::ExceptionIndexOutOfBounds
 		 */
 		T& operator()(size_t row, size_t col);
 
@@ -163,6 +414,18 @@ namespace math
 		 */
 		T operator()(size_t row, size_t col) const;
 
+		/**
+		 * @brief get reference to element at specified position (i,j) with bounds checking
+		 * @details Indices are checked regardless of settings::boundsCheck
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		T& at(size_t row, size_t col);
+
+		/**
+		 * @brief const version of at()
+		 */
+		T at(size_t row, size_t col) const;
+
 		/**
 		 * @brief element indexation only for row-oriented matrices [deprecated]
 		 *
@@ -197,12 +460,23 @@ namespace math
 
 		/**
 		 * @brief Get transposed matrix
-		 * @return transposed Matrix
+		 * @return transposed Matrix (row-oriented copy)
 		 */
 		Matrix<T> getTr() const;
 
 		/**
-		 * @brief Change matrix to transposed
+		 * @brief Get transpose view of matrix
+		 * @details View flips indexing without moving data. It can be used directly in
+		 * products (operator*, gemv) and in elementwise expressions.
+		 * Matrix must outlive the view.
+		 * @return Transpose view
+		 */
+		TransposeView<T> t() const;
+
+		/**
+		 * @brief Change matrix to transposed in place
+		 * @details Square matrices are transposed by cache-oblivious recursive swapping of blocks,
+		 * non-square matrices - by cycle-following permutation of storage. Representation is kept.
 		 */
 		void tr();
 
@@ -234,12 +508,15 @@ namespace math
 		 * @throws math::Exception(Exception::Type::NonSquareMatrixDecomposition)
 		 * @throws math::Exception(Exception::Type::DecompositionArgumentIncorrectSize)
 		 * TODO: сделать перегрузку для возвращения LU в виде единой матрицы L-E+U (стр. 73 Вержбицкого)
+		 * @note L and U are full dense matrices here, LU::lower() and LU::upper() return packed TriangularMatrix
+		 * @note Sequential algorithm without pivoting, LU factorizes large matrices in parallel (see blas::getrf)
 		 */
 		void decompLU(Matrix<T>& Matrix_L, Matrix<T>& Matrix_U) const;
 
 		/**
 		 * @brief overload of decompLU returning combined matrix L+U-E
 		 * @return combined matrix L+U-E (Вержбицкий стр 73 пример 2.2)
+		 * @note Decomposition is done without pivoting, use LU for solving and reusable factorization
 		 */
 		Matrix<T> decompLU() const;
 
@@ -248,34 +525,15 @@ namespace math
 		 *
 		 * Calculate for matrix determinant
 		 * @param method. If method :
-		 *   = 0 - det() calculated by recursive cofactor algo (default)
-		 *   = 1 - det() calculated by LU-decomposition algo
+		 *   = 0 - det() calculated by recursive cofactor algo
+		 *   = 1 - det() calculated by LU-decomposition algo with partial pivoting (see LU, default)
+		 * Matrices up to 4*4 are calculated in closed form for any method.
 		 *
 		 * @throws math::Exception::Type::NonSquareMatrixDeterminant
 		 * @return matrix determinant of type <T>
 		 * TODO: implement selection of row to make decomposition in cofactor method
 		 */
-		T det(unsigned int method = 0) const;
-
-		/**
-		* @brief multiplication of a matrix by a number
-		* @param M matrix
-		* @param n number
-		* @return multiplied matrix M by number n (M * n)
-		*/
-		template<typename T1>
-		friend Matrix<T1> operator*(const Matrix<T1>& M, T1 n);
-
-		/**
-		* @brief permutation overload of operator*(const Matrix<T>&M, T n)
-		* @param n number
-		* @param M matrix
-		* @return multiplied matrix M by number n (n * M)
-		*/
-		friend Matrix<T> operator*(T n, const Matrix<T>& M)
-		{
-			return (operator*(M, n));
-		}
+		T det(unsigned int method = 1) const;
 
 		/**
 		* @brief overload operator*= for multiplication by a number
@@ -286,8 +544,7 @@ namespace math
 
 		/**
 		* @brief Multiplication of a matrix by a matrix
-		* @detailed The type of matrix returned is the same as the type of a first argument.
-		* (<a href="https://users.cs.utah.edu/~hari/teaching/paralg/tutorial/05_Cannons.html">Cannon's algorithm)</a>) used for multithreaded matrix multiplication.
+		* Result has representation of A. Computed by cache-blocked kernel blas::gemm.
 		* @throw Exception::Type::IncorrectSizeForMatrixMultiplication
 		* @return Multiplication of matrices
 		*/
@@ -301,26 +558,6 @@ namespace math
 		*/
 		Matrix<T>& operator*=(const Matrix<T>& M1);
 
-		/**
-		* @brief Addition of a matrix and a number
-		* @param M matrix
-		* @param n number
-		* @return sum of matrix M with n (M + n) element by element
-		*/
-		template<typename T1>
-		friend Matrix<T1> operator+(const Matrix<T1>& M, T1 n);
-
-		/**
-		* @brief permutation overload of operator+(const Matrix<T>&M, T n)
-		* @param n number
-		* @param M matrix
-		* @return sum of matrix M with n (M + n) element by element
-		*/
-		friend Matrix<T> operator+(T n, const Matrix<T>& M)
-		{
-			return (operator+(M, n));
-		}
-
 		/**
 		* @brief overload operator+= for addition with number
 		* @param n number
@@ -335,41 +572,13 @@ namespace math
 			return *this;
 		}
 
-		/**
-		* @brief Addition of matrices (element by element)
-		* @detailed The type of matrix returned is the same as the type of a first argument
-		* @throw Exception::Type::NonEqualMatrixSizes
-		* @return Addition of matrices
-		*/
-		template<typename T1>
-		friend Matrix<T1> operator+(const Matrix<T1>& A, const Matrix<T1>& B);
-
 		/**
 		* @brief overload operator+= for sum of matrices
-		* @param M1 matrix
+		* @param M1 matrix or matrix expression
 		* @return sum of matrices M and M1
 		*/
-		Matrix<T>& operator+=(const Matrix<T>& M1);
-
-		/**
-		* @brief Subtraction of a matrix and a number
-		* @param M matrix
-		* @param n number
-		* @return subtraction of matrix M with n (M + n) element by element
-		*/
-		template<typename T1>
-		friend Matrix<T1> operator-(const Matrix<T1>& M, T1 n);
-
-		/**
-		* @brief permutation overload of operator-(const Matrix<T>&M, T n)
-		* @param n number
-		* @param M matrix
-		* @return subtraction of matrix M with n (M + n) element by element
-		*/
-		friend Matrix<T> operator-(T n, const Matrix<T>& M)
-		{
-			return (operator-(M, n));
-		}
+		template <typename E>
+		Matrix<T>& operator+=(const MatExpr<E>& M1);
 
 		/**
 		* @brief overload operator-= for subtraction with number
@@ -386,26 +595,23 @@ namespace math
 		}
 
 		/**
-		* @brief Subtraction of matrices (element by element)
-		* @detailed The type of matrix returned is the same as the type of a first argument
-		* @throw Exception::Type::NonEqualMatrixSizes
-		* @return Subtraction of matrices
-		*/
-		template<typename T1>
-		friend Matrix<T1> operator-(const Matrix<T1>& A, const Matrix<T1>& B);
-
-		/**
-		* @brief overload operator-= for sum of matrices
-		* @param M1 matrix
-		* @return sum of matrices M and M1
+		* @brief overload operator-= for subtraction of matrices
+		* @param M1 matrix or matrix expression
+		* @return subtraction of matrices M and M1
 		*/
-		Matrix<T>& operator-=(const Matrix<T>& M1);
+		template <typename E>
+		Matrix<T>& operator-=(const MatExpr<E>& M1);
 
 		/**
 		 * @brief calculate inversed matrix
+		 * @details Matrices up to 4*4 are inverted in closed form, larger - by LU factorization with partial pivoting.
+		 * Inverse has the same representation as the matrix.
+		 * @see LU
+		 * @throws math::ExceptionNonSquareMatrix
+		 * @throws math::ExceptionDegenerateMatrix
 		 * @return inversed matrix
 		 */
-		Matrix<T> inverse();
+		Matrix<T> inverse() const;
 
 		/**
 		 * @brief Compare this matrix with another with defined precision
@@ -432,27 +638,44 @@ namespace math
 
 	template <class T>
 	Matrix<T>::Matrix()
-		: rows_{ 0 }, cols_{ 0 }, mvec_{ std::vector<T>() } {};
+		: rows_{ 0 }, cols_{ 0 }, mvec_{} {};
 
 	template <class T>
-	Matrix<T>::Matrix(const Matrix<T>& matrix)
-		: rows_{ matrix.rows_ },
-		cols_{ matrix.cols_ },
-		mvec_{ matrix.mvec_ },
-		repr_{ matrix.repr_ } {};
+	Matrix<T>::Matrix(Matrix<T>&& matrix) noexcept
+		: rows_{ std::exchange(matrix.rows_, 0) },
+		cols_{ std::exchange(matrix.cols_, 0) },
+		mvec_{ std::move(matrix.mvec_) },
+		repr_{ matrix.repr_ }
+	{
+		matrix.mvec_.clear();
+	};
+
+	template <class T>
+	Matrix<T>& Matrix<T>::operator=(Matrix<T>&& matrix) noexcept
+	{
+		if (this != &matrix)
+		{
+			rows_ = std::exchange(matrix.rows_, 0);
+			cols_ = std::exchange(matrix.cols_, 0);
+			mvec_ = std::move(matrix.mvec_);
+			matrix.mvec_.clear();
+			repr_ = matrix.repr_;
+		}
+		return *this;
+	}
 
 	template <class T>
 	Matrix<T>::Matrix(size_t size, MatRep repr)
 		: rows_{ size },
 		cols_{ size },
-		mvec_{ std::vector<T>(size * size) },
+		mvec_(size * size),
 		repr_{ repr } {};
 
 	template <class T>
 	Matrix<T>::Matrix(size_t rows, size_t cols, MatRep repr)
 		: rows_{ rows },
 		cols_{ cols },
-		mvec_{ std::vector<T>(rows * cols) },
+		mvec_(rows * cols),
 		repr_{ repr } {}
 
 	template <typename T>
@@ -479,7 +702,7 @@ namespace math
 	Matrix<T>::Matrix(std::initializer_list<std::initializer_list<T1>> listMatrix)
 		: rows_{ 0 }, cols_{ 0 }, repr_{ MatRep::Row }
 	{
-		mvec_ = std::vector<T>{};
+		mvec_.reserve(listMatrix.size() * (listMatrix.size() > 0 ? listMatrix.begin()->size() : 0));
 		for (auto row_itr = listMatrix.begin(); row_itr != listMatrix.end(); ++row_itr)
 		{
 			size_t cols_check = 0u;
@@ -498,8 +721,61 @@ namespace math
 		}
 	}
 
+	template <typename T>
+	template <typename E>
+	Matrix<T>::Matrix(const MatExpr<E>& expr)
+		: rows_{ expr.self().rows() },
+		cols_{ expr.self().cols() },
+		mvec_(expr.self().rows() * expr.self().cols()),
+		repr_{ expr.self().representation() }
+	{
+		detail::evaluate(expr.self(), mvec_.data(), rowStride(), colStride(), detail::Assign());
+	}
+
+	template <typename T>
+	template <typename E>
+	Matrix<T>& Matrix<T>::operator=(const MatExpr<E>& expr)
+	{
+		const E& e = expr.self();
+		if (rows_ != e.rows() || cols_ != e.cols())
+		{
+			// expression may read storage of *this (e.g. view of its block), so it is evaluated before resize
+			return (*this) = Matrix<T>(e);
+		}
+		if (expr::aliases(e, mvec_.data(), mvec_.data() + numel()))
+		{
+			// view of *this is read at other positions than written
+			Matrix<T> R(rows_, cols_, repr_);
+			detail::evaluate(e, R.data(), R.rowStride(), R.colStride(), detail::Assign());
+			return (*this) = std::move(R);
+		}
+		// representation of *this is kept: expression may read *this, which must stay in its layout
+		detail::evaluate(e, mvec_.data(), rowStride(), colStride(), detail::Assign());
+		return *this;
+	}
+
 	template <typename T>
 	T& Matrix<T>::operator()(size_t row, size_t col)
+	{
+		if constexpr (settings::boundsCheck)
+		{
+			return at(row, col);
+		}
+		return coeffRef(row, col);
+	}
+
+	template <typename T>
+	T Matrix<T>::operator()(size_t row, size_t col) const
+	{
+		if constexpr (settings::boundsCheck)
+		{
+			return at(row, col);
+		}
+		return coeff(row, col);
+	}
+
+	template <typename T>
+	T& Matrix<T>::at(size_t row, size_t col)
 	{
 		if (row >= this->rows_)
 		{
@@ -509,17 +785,11 @@ namespace math
 		{
 			throw(ExceptionIndexOutOfBounds("Matrix<T>::operator(): col index out of bounds!"));
 		}
-
-		size_t pos{ 0 };
-		if (this->repr_ == math::MatRep::Row) // row repr
-			pos = row * cols_ + col;
-		else if (this->repr_ == math::MatRep::Column) // column repr
-			pos = row + rows_ * col;
-		return this->mvec_.at(pos);
+		return coeffRef(row, col);
 	}
 
 	template <typename T>
-	T Matrix<T>::operator()(size_t row, size_t col) const
+	T Matrix<T>::at(size_t row, size_t col) const
 	{
 		if (row >= this->rows_)
 		{
@@ -529,13 +799,7 @@ namespace math
 		{
 			throw(ExceptionIndexOutOfBounds("Matrix<T>::operator(): col index out of bounds!"));
 		}
-
-		size_t pos{ 0 };
-		if (this->repr_ == math::MatRep::Row) // row repr
-			pos = row * cols_ + col;
-		else if (this->repr_ == math::MatRep::Column) // column repr
-			pos = row + rows_ * col;
-		return this->mvec_.at(pos);
+		return coeff(row, col);
 	}
 
 	template <typename T>
@@ -574,7 +838,7 @@ namespace math
 		{
 			for (size_t col = 0; col < cols_; ++col)
 			{
-				std::cout << std::setw(10) << std::left << (*this)(row, col);
+				std::cout << std::setw(10) << std::left << coeff(row, col);
 			}
 			std::cout << std::endl;
 		}
@@ -590,7 +854,7 @@ namespace math
 			for (size_t col = 0; col < cols_; ++col)
 			{
 				std::cout.setf(std::ios_base::fixed | std::ios_base::left);
-				std::cout << std::setw(prec + 5u) << std::setprecision(prec) << (*this)(row, col);
+				std::cout << std::setw(prec + 5u) << std::setprecision(prec) << coeff(row, col);
 			}
 			std::cout << std::endl;
 		}
@@ -607,7 +871,7 @@ namespace math
 		{
 			for (size_t col = 0; col < cols_; ++col)
 			{
-				buffer << std::setw(10) << std::left << (*this)(row, col);
+				buffer << std::setw(10) << std::left << coeff(row, col);
 			}
 			buffer << std::endl;
 		}
@@ -618,78 +882,62 @@ namespace math
 	Matrix<T> Matrix<T>::getTr() const
 	{
 		Matrix<T> M_T(this->cols_, this->rows_);
-		//int pos = 0;
-		size_t n = this->numel();
 
-		//auto start = std::chrono::steady_clock::now();
-		// #pragma omp parallel for shared(M_T, n) schedule(static)
-		for (int pos = 0; pos < n; ++pos)
+		// M_T is row-oriented: storage of column-oriented matrix is already storage of transposed one
+		if (this->repr_ == MatRep::Column || this->rows_ == 1 || this->cols_ == 1)
 		{
-			size_t row = 0;
-			size_t col = 0;
-			if (this->repr_ == math::MatRep::Row) // row repr
-			{
-				row = (size_t)std::floor(pos / this->cols_);
-				col = pos - row * this->cols_;
-			}
-			else if (this->repr_ == math::MatRep::Column) // column repr
-			{
-				col = (size_t)std::floor(pos / this->rows_);
-				row = pos - this->rows_ * col;
-			}
-			M_T(col, row) = this->mvec_.at(pos);
-			
+			std::copy(this->mvec_.begin(), this->mvec_.end(), M_T.mvec_.begin());
+		}
+		else
+		{
+			blas::transposeCopy(this->rows_, this->cols_,
+				this->data(), this->rowStride(), this->colStride(),
+				M_T.data(), M_T.cols_, static_cast<size_t>(1));
 		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 		return M_T;
 	}
 
 	template <typename T>
 	void Matrix<T>::tr()
 	{
-		Matrix<T> M_T(this->cols_, this->rows_);
-		size_t n = this->numel();
-
-		//auto start = std::chrono::steady_clock::now();
-		// #pragma omp parallel for shared(M_T, n) schedule(static)
-		for (int pos = 0; pos < n; ++pos)
+		if (this->rows_ == this->cols_)
+		{
+			blas::transposeSquare(this->rows_, this->mvec_.data());
+		}
+		else if (this->rows_ > 1 && this->cols_ > 1)
 		{
-			size_t row = 0;
-			size_t col = 0;
-			if (this->repr_ == math::MatRep::Row) // row repr
+			// storage consists of rows (row repr) or columns (column repr)
+			if (this->repr_ == MatRep::Row)
 			{
-				row = (size_t)std::floor(pos / this->cols_);
-				col = pos - row * this->cols_;
+				blas::transposeCycles(this->rows_, this->cols_, this->mvec_.data());
 			}
-			else if (this->repr_ == math::MatRep::Column) // column repr
+			else
 			{
-				col = (size_t)std::floor(pos / this->rows_);
-				row = pos - this->rows_ * col;
+				blas::transposeCycles(this->cols_, this->rows_, this->mvec_.data());
 			}
-			M_T(col, row) = this->mvec_.at(pos);
-
 		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
-
-		this->rows_ = M_T.rows();
-		this->cols_ = M_T.cols();
-		this->mvec_ = M_T.vectorized();
+		// storage of vectors doesn't change
+		std::swap(this->rows_, this->cols_);
 	}
 
 	template <typename T>
 	auto Matrix<T>::pnorm(const int p)
 	{
-		T norm = static_cast<T>(0.0);
+		// T for floating point elements (float builds don't compute in double), double for integers
+		typedef decltype(std::pow(T(), T())) norm_type;
 		size_t n = this->numel();
 
-		// #pragma omp parallel for shared(n, p) reduction(+:norm)
-		for (int pos = 0; pos < n; ++pos)
+		// common norms without std::pow
+		if (p == 1)
 		{
-			norm += std::pow(std::abs(this->mvec_.at(pos)), p);
+			return static_cast<norm_type>(blas::nrm1(n, this->mvec_.data(), 1));
 		}
-		return std::pow(norm, (1.0 / p));
+		if (p == 2)
+		{
+			return static_cast<norm_type>(blas::nrm2(n, this->mvec_.data(), 1));
+		}
+
+		return MatExpr<Matrix<T>>::pnorm(p);
 	}
 	template <typename T>
 	bool operator==(const Matrix<T>& m1, Matrix<T> const& m2)
@@ -702,7 +950,7 @@ namespace math
 	template <typename T>
 	T Matrix<T>::maxElement()
 	{
-		return *std::max_element(mvec_.begin(), mvec_.end());
+		return math::max(*this);
 	}
 
 	template<typename T>
@@ -723,66 +971,9 @@ namespace math
 			throw(math::ExceptionInvalidValue("decompLU: Matrix U argument of incorrect size!"));
 		}
 
-		//omp_set_num_threads(std::max(settings::CurrentSettings.numThreads, 1));
-
-		//auto start = std::chrono::steady_clock::now();
-		//#pragma omp parallel for shared(Matrix_L) schedule(static)
-		//for (int i = 0; i < this->cols_; i++)
-		//{
-		//	Matrix_L(i, i) = static_cast<T>(1);
-		//}
-		//
-		//size_t n = this->cols_ * this->rows_;
-		//
-		//#pragma omp parallel for shared(Matrix_L, Matrix_U, n) schedule(static)
-		//for (int pos = 0; pos < n; ++pos)
-		//{
-		//	size_t row = 0;
-		//	size_t col = 0;
-		//	if (this->repr_ == math::MatRep::Row) // row repr
-		//	{
-		//		row = (size_t)std::floor(pos / this->cols_);
-		//		col = pos - row * this->cols_;
-		//	}
-		//	else if (this->repr_ == math::MatRep::Column) // column repr
-		//	{
-		//		col = (size_t)std::floor(pos / this->rows_);
-		//		row = pos - this->rows_ * col;
-		//	}
-		//
-		//	if (row <= col)
-		//	{
-		//		T sum_u = 0.0;
-		//		for (size_t k = 0; k < row; k++)
-		//		{
-		//			sum_u += Matrix_L(row, k) * Matrix_U(k, col);
-		//		}
-		//		Matrix_U(row, col) = this->mvec_[pos] - sum_u;
-		//	}
-		//	if (row > col)
-		//	{
-		//		T sum_l = 0;
-		//		for (size_t k = 0; k < col; k++)
-		//		{
-		//			sum_l += Matrix_L(row, k) * Matrix_U(k, col);
-		//		}
-		//		if (isEqual(Matrix_U(col, col), 0.0))
-		//		{
-		//			throw(math::ExceptionInvalidValue("decompLU: Incorrect input matrix for this method, U(j,j) = 0"));
-		//		}
-		//		Matrix_L(row, col) = (this->mvec_[pos] - sum_l) / Matrix_U(col, col);
-		//	} // if (i > j)
-		//
-		//}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
-
-
-
-		//auto start = std::chrono::steady_clock::now();
 		for (size_t i = 0; i < cols_; i++)
 		{
-			Matrix_L(i, i) = static_cast<T>(1);
+			Matrix_L.coeffRef(i, i) = static_cast<T>(1);
 		}
 		for (size_t i = 0; i < cols_; i++)
 		{
@@ -793,28 +984,25 @@ namespace math
 					T sum_u = 0;
 					for (size_t k = 0; k < i; k++)
 					{
-						sum_u += Matrix_L(i, k) * Matrix_U(k, j);
+						sum_u += Matrix_L.coeffRef(i, k) * Matrix_U.coeffRef(k, j);
 					}
-					Matrix_U(i, j) = (*this)(i, j) - sum_u;
+					Matrix_U.coeffRef(i, j) = coeff(i, j) - sum_u;
 				}
 				if (i > j)
 				{
 					T sum_l = 0;
 					for (size_t k = 0; k < j; k++)
 					{
-						sum_l += Matrix_L(i, k) * Matrix_U(k, j);
+						sum_l += Matrix_L.coeffRef(i, k) * Matrix_U.coeffRef(k, j);
 					}
-					if (isEqual(Matrix_U(j, j), 0.0))
+					if (isEqual(Matrix_U.coeffRef(j, j), 0.0))
 					{
 						throw(math::ExceptionInvalidValue("decompLU: Incorrect input matrix for this method, U(j,j) = 0"));
 					}
-					Matrix_L(i, j) = ((*this)(i, j) - sum_l) / Matrix_U(j, j);
+					Matrix_L.coeffRef(i, j) = (coeff(i, j) - sum_l) / Matrix_U.coeffRef(j, j);
 				} // if (i > j)
 			} // for (size_t j = 0; j < cols_; j++)
 		} // for (size_t i = 0; i < cols_; i++)
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
-
 	} // Matrix<T>::decompLU
 
 	template<typename T>
@@ -827,7 +1015,7 @@ namespace math
 		Matrix<T> LUE(rows_, cols_);
 		for (size_t i = 0; i < rows_; i++)
 		{
-			LUE(i, i) = static_cast<T>(1);
+			LUE.coeffRef(i, i) = static_cast<T>(1);
 		}
 		for (size_t i = 0; i < cols_; i++)
 		{
@@ -838,18 +1026,18 @@ namespace math
 					T sum_u = 0;
 					for (size_t k = 0; k < i; k++)
 					{
-						sum_u += LUE(i, k) * LUE(k, j);
+						sum_u += LUE.coeffRef(i, k) * LUE.coeffRef(k, j);
 					}
-					LUE(i, j) = (*this)(i, j) - sum_u;
+					LUE.coeffRef(i, j) = coeff(i, j) - sum_u;
 				}
 				if (i > j)
 				{
 					T sum_l = 0;
 					for (size_t k = 0; k < j; k++)
 					{
-						sum_l += LUE(i, k) * LUE(k, j);
+						sum_l += LUE.coeffRef(i, k) * LUE.coeffRef(k, j);
 					}
-					LUE(i, j) = ((*this)(i, j) - sum_l) / LUE(j, j);
+					LUE.coeffRef(i, j) = (coeff(i, j) - sum_l) / LUE.coeffRef(j, j);
 				} // if (i > j)
 			} // for (size_t j = 0; j < cols_; j++)
 		} // for (size_t i = 0; i < cols_; i++)
@@ -868,16 +1056,21 @@ namespace math
 		{
 			throw(math::ExceptionDegenerateMatrix("det: matrix dimensions is equal to 0!"));
 		}
-		if (this->rows_ == 1) // trivial case - single element
+		// closed form for small sizes, storage order doesn't matter since det(A^T) = det(A)
+		switch (this->rows_)
 		{
-			return mvec_.at(0);
+		case 1:
+			return blas::smallDet<1>(mvec_.data());
+		case 2:
+			return blas::smallDet<2>(mvec_.data());
+		case 3:
+			return blas::smallDet<3>(mvec_.data());
+		case 4:
+			return blas::smallDet<4>(mvec_.data());
+		default:
+			break;
 		}
-		if (this->rows_ == 2) // trivial case - 2x2 case
-		{
-			return (*this)(0, 0) * (*this)(1, 1) -
-				(*this)(0, 1) * (*this)(1, 0);
-		}
-		// for sizes > 2
+		// for sizes > 4
 		if (method == 0) // cofactor algo
 		{
 			std::vector<size_t> rowsExcl{}, colsExcl{};
@@ -885,17 +1078,7 @@ namespace math
 		}
 		if (method == 1) // LU algo
 		{
-			auto L = Matrix<T>(this->cols_);
-			auto U = Matrix<T>(this->cols_);
-			T mul_L = static_cast<T>(1.);
-			T mul_U = static_cast<T>(1.);
-			this->decompLU(L, U);
-			for (size_t i = 0; i < this->cols_; ++i)
-			{
-				mul_L *= L(i, i);
-				mul_U *= U(i, i);
-			}
-			return mul_L * mul_U;
+			return LU<T>(*this).det();
 		}
 		return T();
 	}
@@ -927,10 +1110,10 @@ namespace math
 			auto col1Itr = std::find(colsExcl.begin(), colsExcl.end(), 0);
 			auto col1 = col1Itr - colsExcl.begin();
 			auto col2 = std::find(col1Itr + 1, colsExcl.end(), 0) - colsExcl.begin();
-			auto a11 = (*this)(row1, col1);
-			auto a22 = (*this)(row2, col2);
-			auto a21 = (*this)(row2, col1);
-			auto a12 = (*this)(row1, col2);
+			auto a11 = coeff(row1, col1);
+			auto a22 = coeff(row2, col2);
+			auto a21 = coeff(row2, col1);
+			auto a12 = coeff(row1, col2);
 			// auto detrm = ( (*this)(row1, col1) * (*this)(row2, col2) ) -
 			//        ( (*this)(row2, col1) * (*this)(row1, col2) );
 			auto detrm = a11 * a22 - a21 * a12;
@@ -954,7 +1137,7 @@ namespace math
 			col = static_cast<size_t>(colItr - colsExcl.begin());
 			size_t exp = 0 + colCofact; // by 1st row (always) and colCofact
 			++colCofact;
-			if (isEqual((*this)(row, col), 0.))
+			if (isEqual(coeff(row, col), 0.))
 			{
 				++colItr;
 			}
@@ -964,7 +1147,7 @@ namespace math
 				++iteration;
 				/// @bug Inf calling?
 				auto addDtrm = detIterative(iteration, rowsExcl, colsExcl);
-				dtrm += addDtrm * (*this)(row, col) * std::pow(-1., exp);
+				dtrm += addDtrm * coeff(row, col) * std::pow(-1., exp);
 				colsExcl.at(col) = 0;
 				--iteration;
 				++colItr;
@@ -974,36 +1157,11 @@ namespace math
 		return dtrm;
 	};
 
-	template <typename T>
-	Matrix<T> operator*(const Matrix<T>& M, T n)
-	{
-		Matrix<T> mul_M(M.rows(), M.cols());
-		size_t el = M.numel();
-
-		//auto start = std::chrono::steady_clock::now();
-		// #pragma omp parallel for shared(mul_M, el) schedule(static)
-		for (int pos = 0; pos < el; ++pos)
-		{
-			mul_M.mvec_.at(pos) = M.mvec_.at(pos) * n;
-		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
-		return mul_M;
-	};
-
 	template <typename T>
 	Matrix<T>& Matrix<T>::operator*=(T n)
 	{
-		size_t el = this->numel();
-
-		//auto start = std::chrono::steady_clock::now();
-		// #pragma omp parallel for shared(el) schedule(static)
-		for (int pos = 0; pos < el; ++pos)
-		{
-			this->mvec_.at(pos) *= n;
-		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
+		T* a = this->mvec_.data();
+		detail::forEachPos(this->numel(), [a, n](size_t pos) { a[pos] *= n; });
 		return *this;
 	};
 
@@ -1015,23 +1173,14 @@ namespace math
 			throw(math::ExceptionInvalidValue("Matrix<T>::operator*: Matrices can't be multiplied!"));
 		}
 
-		Matrix<T> C(A.rows(), B.cols());
-
-		//auto start = std::chrono::steady_clock::now();		
-		// #pragma omp parallel for shared(A, B, C) schedule(static)
-		for (int pos = 0; pos < C.numel(); ++pos)
-		{
-			// row representation for matrix C by default
-			size_t row = (size_t)std::floor(pos / C.cols_);
-			size_t col = pos - row * C.cols_;
+		// representation of A for matrix C
+		Matrix<T> C(A.rows(), B.cols(), A.repr_);
 
-			for (int k = 0; k < A.cols_; ++k)
-			{
-				C.mvec_[pos] += A(row, k) * B(k, col);
-			}
-		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
+		blas::gemm(A.rows_, B.cols_, A.cols_, static_cast<T>(1),
+			A.data(), A.rowStride(), A.colStride(),
+			B.data(), B.rowStride(), B.colStride(),
+			static_cast<T>(0),
+			C.data(), C.rowStride(), C.colStride());
 
 		return C;
 	};
@@ -1039,164 +1188,297 @@ namespace math
 	template <typename T>
 	Matrix<T>& Matrix<T>::operator*=(const Matrix<T>& M1)
 	{
-		Matrix<T> Mm{ operator*((*this),M1) };
-		(*this) = Mm;
+		// product can't be computed in place, its storage is moved into *this
+		(*this) = (*this) * M1;
 		return *this;
 	}
 
-	template<typename T>
-	Matrix<T> operator+(const Matrix<T>& M, T n)
+	namespace detail
 	{
-		Matrix<T> sum_M(M.rows(), M.cols());
-		size_t el = sum_M.numel();
+		/**
+		 * @brief Product of strided operands A (M*K) and B (K*N) into new matrix
+		 * @details Result has representation of A (like elementwise expressions), so products of
+		 * column-oriented matrices stay column-oriented
+		 */
+		template <typename T, typename A_t, typename B_t>
+		Matrix<T> stridedProduct(const A_t& A, const B_t& B)
+		{
+			if (A.cols() != B.rows())
+			{
+				throw(math::ExceptionInvalidValue("Matrix<T>::operator*: Matrices can't be multiplied!"));
+			}
+			Matrix<T> C(A.rows(), B.cols(), A.representation());
+			blas::gemm(A.rows(), B.cols(), A.cols(), static_cast<T>(1),
+				A.data(), A.rowStride(), A.colStride(),
+				B.data(), B.rowStride(), B.colStride(),
+				static_cast<T>(0),
+				C.data(), C.rowStride(), C.colStride());
+			return C;
+		}
 
-		//auto start = std::chrono::steady_clock::now();		
-		// #pragma omp parallel for shared(sum_M, M, n, el) schedule(static)
-		for (int i = 0; i < el; ++i)
+		/// @brief Matrix operand is used as is
+		template <typename T>
+		const Matrix<T>& evaluated(const Matrix<T>& M)
 		{
-			sum_M.mvec_.at(i) = M.mvec_.at(i) + n;
+			return M;
 		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
-		return sum_M;
-	};
 
-	template<typename T>
-	Matrix<T> operator+(const Matrix<T>& A, const Matrix<T>& B)
-	{
-		if (A.cols() != B.cols() ||
-			A.rows() != B.rows())
+		/// @brief Strided operands are used as is
+		template <typename T>
+		const TransposeView<T>& evaluated(const TransposeView<T>& M)
 		{
-			throw(math::ExceptionInvalidValue("Matrix<T>::operator+: Matrices can't be added!"));
+			return M;
 		}
 
-		Matrix<T> C(A.rows(), A.cols());
-		size_t el = C.numel();
+		template <typename T>
+		const MatrixView<T>& evaluated(const MatrixView<T>& M)
+		{
+			return M;
+		}
 
-		//auto start = std::chrono::steady_clock::now();
-		// #pragma omp parallel for shared(A, B, C, el) schedule(static)
-		for (int i = 0; i < el; ++i)
+		/// @brief Other expressions are evaluated to temporary matrix
+		template <typename E>
+		Matrix<typename E::value_type> evaluated(const MatExpr<E>& e)
 		{
-			C.mvec_.at(i) = A.mvec_.at(i) + B.mvec_.at(i);
+			return Matrix<typename E::value_type>(e.self());
 		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 
-		return C;
-	};
+		/// @brief Check, that result of elementwise operation A op B can be stored in place of B
+		template <typename E, typename T>
+		bool reusable(const E& A, const Matrix<T>& B)
+		{
+			return A.rows() == B.rows() && A.cols() == B.cols() &&
+				(A.representation() == B.representation() || B.rows() == 1 || B.cols() == 1);
+		}
+	}
 
-	template <typename T>
-	Matrix<T>& Matrix<T>::operator+=(const Matrix<T>& M1)
+	/**
+	* @brief Multiplication of matrix expressions
+	* @details Strided operands (Matrix, TransposeView, MatrixView) are multiplied in place,
+	* other expressions are evaluated before multiplication
+	* @see operator*(const Matrix<T1>& A, const Matrix<T1>& B)
+	*/
+	template <typename E1, typename E2>
+	Matrix<typename E1::value_type> operator*(const MatExpr<E1>& A, const MatExpr<E2>& B)
 	{
-		Matrix<T> Mm{ operator+((*this),M1) };
-		(*this) = Mm;
-		return *this;
+		typedef typename E1::value_type T;
+		static_assert(std::is_same<T, typename E2::value_type>::value,
+			"math: element types of matrix expression operands didn't agree");
+		const auto& a = detail::evaluated(A.self());
+		const auto& b = detail::evaluated(B.self());
+		return detail::stridedProduct<T>(a, b);
 	}
 
-
-
-	template<typename T>
-	Matrix<T> operator-(const Matrix<T>& M, T n)
+	/**
+	* @defgroup RvalueOperators Operators on expiring matrices
+	* @{
+	* @brief Elementwise operators, which store result in storage of temporary operand
+	* @details Result of e.g. A * x - b or 2.0 * A.inverse() is computed in place of
+	* temporary matrix and moved out, so no new matrix is allocated.
+	*/
+
+	/**
+	* @brief Addition of expression to temporary matrix
+	* @throw ExceptionInvalidValue for non-equal matrix sizes
+	*/
+	template <typename T, typename E>
+	Matrix<T> operator+(Matrix<T>&& A, const MatExpr<E>& B)
 	{
-		Matrix<T> diff_M(M.rows(), M.cols());
-		size_t el = diff_M.numel();
+		A += B;
+		return std::move(A);
+	}
 
-		//auto start = std::chrono::steady_clock::now();		
-		#pragma omp parallel for shared(diff_M, M, n, el) schedule(static)
-		for (int i = 0; i < el; ++i)
+	/**
+	* @brief Addition of temporary matrix to expression
+	* @details Storage of B is reused, if representation of the result (representation of A) allows it
+	* @throw ExceptionInvalidValue for non-equal matrix sizes
+	*/
+	template <typename T, typename E>
+	Matrix<T> operator+(const MatExpr<E>& A, Matrix<T>&& B)
+	{
+		if (!detail::reusable(A.self(), B))
 		{
-			diff_M.mvec_.at(i) = M.mvec_.at(i) - n;
+			return Matrix<T>(A + B);
 		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
-		return diff_M;
-	};
+		B += A;
+		return std::move(B);
+	}
 
-	template<typename T>
-	Matrix<T> operator-(const Matrix<T>& A, const Matrix<T>& B)
+	template <typename T>
+	Matrix<T> operator+(Matrix<T>&& A, Matrix<T>&& B)
+	{
+		A += B;
+		return std::move(A);
+	}
+
+	/**
+	* @brief Subtraction of expression from temporary matrix
+	* @throw ExceptionInvalidValue for non-equal matrix sizes
+	*/
+	template <typename T, typename E>
+	Matrix<T> operator-(Matrix<T>&& A, const MatExpr<E>& B)
 	{
-		if (A.cols() != B.cols() ||
-			A.rows() != B.rows())
+		A -= B;
+		return std::move(A);
+	}
+
+	/**
+	* @brief Subtraction of temporary matrix from expression
+	* @details Storage of B is reused, if representation of the result (representation of A) allows it
+	* @throw ExceptionInvalidValue for non-equal matrix sizes
+	*/
+	template <typename T, typename E>
+	Matrix<T> operator-(const MatExpr<E>& A, Matrix<T>&& B)
+	{
+		if (!detail::reusable(A.self(), B))
 		{
-			throw(math::ExceptionInvalidValue("Matrix<T>::operator-: Matrices can't be subtracted!"));
+			return Matrix<T>(A - B);
 		}
+		// elementwise, so B may be overwritten while read
+		B = A - B;
+		return std::move(B);
+	}
+
+	template <typename T>
+	Matrix<T> operator-(Matrix<T>&& A, Matrix<T>&& B)
+	{
+		A -= B;
+		return std::move(A);
+	}
+
+	/**
+	* @brief Multiplication of temporary matrix by a number
+	*/
+	template <typename T, typename S, typename = expr::EnableScalar<S>>
+	Matrix<T> operator*(Matrix<T>&& M, S n)
+	{
+		M *= static_cast<T>(n);
+		return std::move(M);
+	}
+
+	template <typename T, typename S, typename = expr::EnableScalar<S>>
+	Matrix<T> operator*(S n, Matrix<T>&& M)
+	{
+		M *= static_cast<T>(n);
+		return std::move(M);
+	}
+
+	/**
+	* @brief Addition of temporary matrix and a number
+	*/
+	template <typename T, typename S, typename = expr::EnableScalar<S>>
+	Matrix<T> operator+(Matrix<T>&& M, S n)
+	{
+		M = M + n;
+		return std::move(M);
+	}
+
+	template <typename T, typename S, typename = expr::EnableScalar<S>>
+	Matrix<T> operator+(S n, Matrix<T>&& M)
+	{
+		M = M + n;
+		return std::move(M);
+	}
+
+	/**
+	* @brief Subtraction of temporary matrix and a number
+	*/
+	template <typename T, typename S, typename = expr::EnableScalar<S>>
+	Matrix<T> operator-(Matrix<T>&& M, S n)
+	{
+		M = M - n;
+		return std::move(M);
+	}
+
+	template <typename T, typename S, typename = expr::EnableScalar<S>>
+	Matrix<T> operator-(S n, Matrix<T>&& M)
+	{
+		M = n - M;
+		return std::move(M);
+	}
 
-		Matrix<T> C(A.rows(), A.cols());
-		size_t el = C.numel();
+	/**
+	* @}
+	*/
 
-		//auto start = std::chrono::steady_clock::now();
-		// #pragma omp parallel for shared(A, B, C, el) schedule(static)
-		for (int i = 0; i < el; ++i)
+	template <typename T>
+	template <typename E>
+	Matrix<T>& Matrix<T>::operator+=(const MatExpr<E>& M1)
+	{
+		const E& e = M1.self();
+		if (rows_ != e.rows() ||
+			cols_ != e.cols())
 		{
-			C.mvec_.at(i) = A.mvec_.at(i) - B.mvec_.at(i);
+			throw(math::ExceptionInvalidValue("Matrix<T>::operator+: Matrices can't be added!"));
 		}
-		//auto end = std::chrono::steady_clock::now();
-		//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
-		return C;
-	};
+		if (expr::aliases(e, mvec_.data(), mvec_.data() + numel()))
+		{
+			// view of *this is read at other positions than written
+			const Matrix<T> R(e);
+			detail::evaluate(R, mvec_.data(), rowStride(), colStride(), detail::AddAssign());
+			return *this;
+		}
+		detail::evaluate(e, mvec_.data(), rowStride(), colStride(), detail::AddAssign());
+		return *this;
+	}
+
+
 
 	template <typename T>
-	Matrix<T>& Matrix<T>::operator-=(const Matrix<T>& M1)
+	template <typename E>
+	Matrix<T>& Matrix<T>::operator-=(const MatExpr<E>& M1)
 	{
-		Matrix<T> Mm{ operator-((*this),M1) };
-		(*this) = Mm;
+		const E& e = M1.self();
+		if (rows_ != e.rows() ||
+			cols_ != e.cols())
+		{
+			throw(math::ExceptionInvalidValue("Matrix<T>::operator-: Matrices can't be subtracted!"));
+		}
+		if (expr::aliases(e, mvec_.data(), mvec_.data() + numel()))
+		{
+			// view of *this is read at other positions than written
+			const Matrix<T> R(e);
+			detail::evaluate(R, mvec_.data(), rowStride(), colStride(), detail::SubAssign());
+			return *this;
+		}
+		detail::evaluate(e, mvec_.data(), rowStride(), colStride(), detail::SubAssign());
 		return *this;
 	}
 
 	template<typename T>
-	Matrix<T> Matrix<T>::inverse()
+	Matrix<T> Matrix<T>::inverse() const
 	{
 		if (this->rows_ != this->cols_)
 		{
 			throw(math::ExceptionNonSquareMatrix("inverse:Inverse of non square matrix!"));
 		}
-		Matrix<T> X(this->rows(), this->cols()), // inverse matrix
-			L(this->rows(), this->cols()),  // L matrix
-			U(this->rows(), this->cols());  // U matrix
-		this->decompLU(L, U);
-		long long n = static_cast<long long>(this->rows_ - 1); // size of matrix
-		long long d = n; // from right lower corner
-		long long i = d;
-		long long j = d;
-		while (true) {
-			i = d;
-			j = d;
-			// diagonal element of X calculation
-			X(d, d) = static_cast<T>(1.);
-			for (long long k = j + 1; k <= n; ++k)
-			{
-				// formula (2.15) p 71
-				X(j, j) -= U(j, k) * X(k, j);
-			}
-			X(j, j) *= static_cast<T>(1.) / U(j, j);
-			// column walk up from jj
-			for (i = d - 1; i >= 0; --i)
+		if (this->rows_ > 0 && this->rows_ <= blas::smallMaxSize)
+		{
+			// closed form, inverse has the same representation, since inv(A^T) = inv(A)^T
+			Matrix<T> X(this->rows_, this->cols_, repr_);
+			T d = static_cast<T>(0);
+			switch (this->rows_)
 			{
-				// formula (2.16) p 71
-				X(i, j) = static_cast<T>(0.);
-				for (long long k = i + 1; k <= n; ++k)
-				{
-					X(i, j) += U(i, k) * X(k, j);
-				}
-				X(i, j) *= -static_cast<T>(1.) / U(i, i);
+			case 1:
+				d = blas::smallInverse<1>(mvec_.data(), X.data());
+				break;
+			case 2:
+				d = blas::smallInverse<2>(mvec_.data(), X.data());
+				break;
+			case 3:
+				d = blas::smallInverse<3>(mvec_.data(), X.data());
+				break;
+			default:
+				d = blas::smallInverse<4>(mvec_.data(), X.data());
+				break;
 			}
-			i = d; // return to diagonal
-			// row walk left from jj
-			for (j = d - 1; j >= 0; --j)
+			if (d == static_cast<T>(0))
 			{
-				// formula (2.17) p 71
-				X(i, j) = static_cast<T>(0.);
-				for (long long k = j + 1; k <= n; ++k)
-				{
-					X(i, j) -= X(i, k) * L(k, j);
-				}
+				throw(math::ExceptionDegenerateMatrix("inverse: matrix is singular!"));
 			}
-			j = d; // return to diagonal
-			--d;
-			if (d < 0)
-				break;  // exit cycle
-		} // while (!end)
-		return X;
+			return X;
+		}
+		return LU<T>(*this).inverse(repr_);
 	} //Matrix<T> Matrix<T>::inverse()
 
 	template<typename T>
@@ -1212,11 +1494,141 @@ namespace math
 		{
 			for (size_t j = 0; j < this->cols_; ++j)
 			{
-				if (!isEqual((*this)(i, j), M(i, j)))
+				if (!isEqual(coeff(i, j), M.coeff(i, j)))
 					return false;
 			}
 		}
 		return true;
 	}
 
+	//! Class TransposeView
+	/* Non-owning view of transposed matrix. Element (i,j) of view is element (j,i) of matrix.
+	 * Data is not moved: view of row-oriented matrix is column-oriented and vice versa.
+	 */
+	template <typename T>
+	class TransposeView :
+		public MatExpr<TransposeView<T>>
+	{
+	public:
+		typedef T value_type;
+
+		explicit TransposeView(const Matrix<T>& M)
+			: M_(M)
+		{
+		}
+
+		/// @brief Transposed matrix
+		const Matrix<T>& matrix() const
+		{
+			return M_;
+		}
+
+		size_t rows() const
+		{
+			return M_.cols();
+		}
+
+		size_t cols() const
+		{
+			return M_.rows();
+		}
+
+		size_t numel() const
+		{
+			return M_.numel();
+		}
+
+		MatRep representation() const
+		{
+			return M_.representation() == MatRep::Row ? MatRep::Column : MatRep::Row;
+		}
+
+		const T* data() const
+		{
+			return M_.data();
+		}
+
+		size_t rowStride() const
+		{
+			return M_.colStride();
+		}
+
+		size_t colStride() const
+		{
+			return M_.rowStride();
+		}
+
+		/// @brief Transposed matrix is read at (col, row), so view aliases its storage (see MatExpr)
+		bool aliases(const void* begin, const void* end) const
+		{
+			return expr::overlaps(M_.data(), M_.data() + M_.numel(), begin, end);
+		}
+
+		T elem(size_t pos) const
+		{
+			return M_.elem(pos);
+		}
+
+		T coeff(size_t row, size_t col) const
+		{
+			return M_.coeff(col, row);
+		}
+
+		T operator()(size_t row, size_t col) const
+		{
+			return M_(col, row);
+		}
+
+		/// @brief Transpose of view is the matrix itself
+		const Matrix<T>& t() const
+		{
+			return M_;
+		}
+
+		/// @brief Strided view of transposed matrix
+		MatrixView<const T> view() const
+		{
+			return M_.view().t();
+		}
+
+	private:
+		const Matrix<T>& M_;
+	};
+
+	template <typename T>
+	TransposeView<T> Matrix<T>::t() const
+	{
+		return TransposeView<T>(*this);
+	}
+
+	/**
+	* @brief Product of transposed matrix and matrix @f$ \mathbf{A}^T \mathbf{B} @f$ without transposed copy
+	*/
+	template <typename T>
+	Matrix<T> operator*(const TransposeView<T>& A, const Matrix<T>& B)
+	{
+		return detail::stridedProduct<T>(A, B);
+	}
+
+	/**
+	* @brief Product of matrix and transposed matrix @f$ \mathbf{A} \mathbf{B}^T @f$ without transposed copy
+	*/
+	template <typename T>
+	Matrix<T> operator*(const Matrix<T>& A, const TransposeView<T>& B)
+	{
+		return detail::stridedProduct<T>(A, B);
+	}
+
+	/**
+	* @brief Product of transposed matrices @f$ \mathbf{A}^T \mathbf{B}^T @f$ without transposed copies
+	*/
+	template <typename T>
+	Matrix<T> operator*(const TransposeView<T>& A, const TransposeView<T>& B)
+	{
+		return detail::stridedProduct<T>(A, B);
+	}
+
 } // namespace math
+
+// LU is used by Matrix::inverse() and Matrix::det()
+#include <libmath/lu.h>
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <libmath/math_exception.h>
+#include <libmath/blas/layout.h>
+
+#include <type_traits>
+#include <utility>
+#include <functional>
+#include <cmath>
+#include <cstddef>
+
+namespace math
+{
+	//! Enum class for matrix representation definition
+	//! @sa Matrix::repr_
+	enum class MatRep
+	{
+		Row = 0,
+		Column
+	};
+
+	namespace detail
+	{
+		/**
+		 * @brief Call f(blas::RowMajor()) or f(blas::ColMajor()) for representation repr
+		 * @details Layout is checked once, after that f works with compile-time layout tag
+		 * (see blas::RowMajor), e.g. @code withLayout(A.representation(), [&](auto L) { blas::getrf<decltype(L)>(...); }) @endcode
+		 */
+		template <typename F>
+		decltype(auto) withLayout(MatRep repr, F&& f)
+		{
+			if (repr == MatRep::Row)
+			{
+				return f(blas::RowMajor());
+			}
+			return f(blas::ColMajor());
+		}
+	}
+
+	template <typename T>
+	class Matrix;
+
+	//! Class MatExpr
+	/* Base class (CRTP) for lazy matrix expressions.
+	 * Elementwise and scalar operators don't compute anything, they build
+	 * a light expression tree which is evaluated in a single loop when assigned to
+	 * Matrix. Every expression provides:
+	 *	- value_type: type of elements
+	 *	- rows(), cols(), representation(): dimensions and layout of the result
+	 *	- elem(pos): element at linear position pos of the internal storage
+	 *	- coeff(row, col): element at position (row, col)
+	 *	- linear() (optional, true if absent): elem(pos) may be used, i.e. all operands have
+	 *	  the same layout and elem() doesn't compute (row, col) from pos
+	 *	- aliases(begin, end) (optional, false if absent): expression reads memory [begin, end)
+	 *	  through a view (TransposeView, MatrixView), i.e. not only at its own (row, col)
+	 * Linear expressions are evaluated by linear position in one vectorized loop, other expressions
+	 * (e.g. row- and column-oriented operands, views, packed matrices) - by (row, col) in loops over
+	 * rows and columns (see elementwise.h).
+	 */
+	template <typename E>
+	class MatExpr
+	{
+	public:
+		/// @brief Cast to actual expression type
+		const E& self() const
+		{
+			return static_cast<const E&>(*this);
+		}
+
+		/**
+		 * @brief Evaluate expression to a new matrix
+		 */
+		auto eval() const
+		{
+			return Matrix<typename E::value_type>(self());
+		}
+
+		/**
+		 * @brief p-norm of expression result, calculated without temporary matrix
+		 * @details Defined in elementwise.h
+		 * @see Matrix::pnorm
+		 */
+		auto pnorm(const int p) const;
+
+		/**
+		 * @brief Print expression result to std out
+		 */
+		void print(int prec = 5) const
+		{
+			eval().print(prec);
+		}
+
+	protected:
+		MatExpr() = default;
+	};
+
+	namespace expr
+	{
+		/// @brief Leaves (matrices) are held by reference, intermediate nodes by value
+		template <typename E>
+		struct Storage
+		{
+			typedef const E type;
+		};
+
+		template <typename T>
+		struct Storage<Matrix<T>>
+		{
+			typedef const Matrix<T>& type;
+		};
+
+		/// @brief Expression type E has member aliases()
+		template <typename E, typename = void>
+		struct HasAliases : std::false_type
+		{
+		};
+
+		template <typename E>
+		struct HasAliases<E, std::void_t<decltype(std::declval<const E&>().aliases(nullptr, nullptr))>> : std::true_type
+		{
+		};
+
+		/**
+		 * @brief Expression reads memory [begin, end) not elementwise (see MatExpr), so it can't be
+		 * evaluated in place of matrix with this storage
+		 */
+		template <typename E>
+		bool aliases(const E& e, const void* begin, const void* end)
+		{
+			if constexpr (HasAliases<E>::value)
+			{
+				return e.aliases(begin, end);
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		/// @brief Memory ranges [begin1, end1) and [begin2, end2) intersect
+		inline bool overlaps(const void* begin1, const void* end1, const void* begin2, const void* end2)
+		{
+			const std::less<const void*> less;
+			return less(begin1, end2) && less(begin2, end1);
+		}
+
+		/// @brief Expression type E has member linear()
+		template <typename E, typename = void>
+		struct HasLinear : std::false_type
+		{
+		};
+
+		template <typename E>
+		struct HasLinear<E, std::void_t<decltype(std::declval<const E&>().linear())>> : std::true_type
+		{
+		};
+
+		/**
+		 * @brief Expression can be evaluated by elem(pos) (see MatExpr)
+		 */
+		template <typename E>
+		bool linear(const E& e)
+		{
+			if constexpr (HasLinear<E>::value)
+			{
+				return e.linear();
+			}
+			else
+			{
+				return true;
+			}
+		}
+
+		/// @brief Elementwise operations
+		struct Add
+		{
+			template <typename T>
+			static T apply(T a, T b) { return a + b; }
+		};
+
+		struct Sub
+		{
+			template <typename T>
+			static T apply(T a, T b) { return a - b; }
+		};
+
+		struct Mul
+		{
+			template <typename T>
+			static T apply(T a, T b) { return a * b; }
+		};
+
+		/// @brief Reversed subtraction (n - a) for scalar expressions
+		struct RSub
+		{
+			template <typename T>
+			static T apply(T a, T b) { return b - a; }
+		};
+
+		struct Min
+		{
+			template <typename T>
+			static T apply(T a, T b) { return b < a ? b : a; }
+		};
+
+		struct Max
+		{
+			template <typename T>
+			static T apply(T a, T b) { return a < b ? b : a; }
+		};
+
+		/**
+		 * @brief Node for elementwise operation of two expressions of the same size
+		 */
+		template <typename L, typename R, typename Op>
+		class Binary :
+			public MatExpr<Binary<L, R, Op>>
+		{
+		public:
+			typedef typename L::value_type value_type;
+
+			static_assert(std::is_same<value_type, typename R::value_type>::value,
+				"math: element types of matrix expression operands didn't agree");
+
+			Binary(const L& lhs, const R& rhs, const char* error)
+				: lhs_(lhs), rhs_(rhs)
+			{
+				if (lhs.rows() != rhs.rows() ||
+					lhs.cols() != rhs.cols())
+				{
+					throw(math::ExceptionInvalidValue(error));
+				}
+				// storage of vectors doesn't depend on representation
+				linear_ = (lhs.representation() == rhs.representation() || lhs.rows() == 1 || lhs.cols() == 1) &&
+					expr::linear(lhs) && expr::linear(rhs);
+			}
+
+			size_t rows() const
+			{
+				return lhs_.rows();
+			}
+
+			size_t cols() const
+			{
+				return lhs_.cols();
+			}
+
+			MatRep representation() const
+			{
+				return lhs_.representation();
+			}
+
+			bool linear() const
+			{
+				return linear_;
+			}
+
+			bool aliases(const void* begin, const void* end) const
+			{
+				return expr::aliases(lhs_, begin, end) || expr::aliases(rhs_, begin, end);
+			}
+
+			/// @brief Element at linear position, only for linear() expression
+			value_type elem(size_t pos) const
+			{
+				return Op::apply(lhs_.elem(pos), rhs_.elem(pos));
+			}
+
+			value_type coeff(size_t row, size_t col) const
+			{
+				return Op::apply(lhs_.coeff(row, col), rhs_.coeff(row, col));
+			}
+
+		private:
+			typename Storage<L>::type lhs_;
+			typename Storage<R>::type rhs_;
+			bool linear_ = true;
+		};
+
+		/**
+		 * @brief Node for elementwise operation of expression and a number
+		 */
+		template <typename E, typename Op>
+		class Scalar :
+			public MatExpr<Scalar<E, Op>>
+		{
+		public:
+			typedef typename E::value_type value_type;
+
+			Scalar(const E& e, value_type n)
+				: e_(e), n_(n)
+			{
+			}
+
+			size_t rows() const
+			{
+				return e_.rows();
+			}
+
+			size_t cols() const
+			{
+				return e_.cols();
+			}
+
+			MatRep representation() const
+			{
+				return e_.representation();
+			}
+
+			bool linear() const
+			{
+				return expr::linear(e_);
+			}
+
+			bool aliases(const void* begin, const void* end) const
+			{
+				return expr::aliases(e_, begin, end);
+			}
+
+			value_type elem(size_t pos) const
+			{
+				return Op::apply(e_.elem(pos), n_);
+			}
+
+			value_type coeff(size_t row, size_t col) const
+			{
+				return Op::apply(e_.coeff(row, col), n_);
+			}
+
+		private:
+			typename Storage<E>::type e_;
+			value_type n_;
+		};
+
+		/// @brief Enable operator only for arithmetic numbers
+		template <typename S>
+		using EnableScalar = typename std::enable_if<std::is_arithmetic<S>::value>::type;
+	}
+
+	/**
+	* @brief Addition of matrices (element by element)
+	* @detailed Representation of result is the same as representation of a first argument
+	* @throw ExceptionInvalidValue for non-equal matrix sizes
+	* @return Expression of addition
+	*/
+	template <typename E1, typename E2>
+	expr::Binary<E1, E2, expr::Add> operator+(const MatExpr<E1>& A, const MatExpr<E2>& B)
+	{
+		return expr::Binary<E1, E2, expr::Add>(A.self(), B.self(), "Matrix<T>::operator+: Matrices can't be added!");
+	}
+
+	/**
+	* @brief Subtraction of matrices (element by element)
+	* @detailed Representation of result is the same as representation of a first argument
+	* @throw ExceptionInvalidValue for non-equal matrix sizes
+	* @return Expression of subtraction
+	*/
+	template <typename E1, typename E2>
+	expr::Binary<E1, E2, expr::Sub> operator-(const MatExpr<E1>& A, const MatExpr<E2>& B)
+	{
+		return expr::Binary<E1, E2, expr::Sub>(A.self(), B.self(), "Matrix<T>::operator-: Matrices can't be subtracted!");
+	}
+
+	/**
+	* @brief multiplication of a matrix by a number
+	* @return Expression M * n
+	*/
+	template <typename E, typename S, typename = expr::EnableScalar<S>>
+	expr::Scalar<E, expr::Mul> operator*(const MatExpr<E>& M, S n)
+	{
+		return expr::Scalar<E, expr::Mul>(M.self(), static_cast<typename E::value_type>(n));
+	}
+
+	/**
+	* @brief permutation overload of operator*(const MatExpr<E>& M, S n)
+	* @return Expression n * M
+	*/
+	template <typename E, typename S, typename = expr::EnableScalar<S>>
+	expr::Scalar<E, expr::Mul> operator*(S n, const MatExpr<E>& M)
+	{
+		return expr::Scalar<E, expr::Mul>(M.self(), static_cast<typename E::value_type>(n));
+	}
+
+	/**
+	* @brief Addition of a matrix and a number
+	* @return Expression M + n element by element
+	*/
+	template <typename E, typename S, typename = expr::EnableScalar<S>>
+	expr::Scalar<E, expr::Add> operator+(const MatExpr<E>& M, S n)
+	{
+		return expr::Scalar<E, expr::Add>(M.self(), static_cast<typename E::value_type>(n));
+	}
+
+	/**
+	* @brief permutation overload of operator+(const MatExpr<E>& M, S n)
+	* @return Expression n + M element by element
+	*/
+	template <typename E, typename S, typename = expr::EnableScalar<S>>
+	expr::Scalar<E, expr::Add> operator+(S n, const MatExpr<E>& M)
+	{
+		return expr::Scalar<E, expr::Add>(M.self(), static_cast<typename E::value_type>(n));
+	}
+
+	/**
+	* @brief Subtraction of a matrix and a number
+	* @return Expression M - n element by element
+	*/
+	template <typename E, typename S, typename = expr::EnableScalar<S>>
+	expr::Scalar<E, expr::Sub> operator-(const MatExpr<E>& M, S n)
+	{
+		return expr::Scalar<E, expr::Sub>(M.self(), static_cast<typename E::value_type>(n));
+	}
+
+	/**
+	* @brief Subtraction of a number and a matrix
+	* @return Expression n - M element by element
+	*/
+	template <typename E, typename S, typename = expr::EnableScalar<S>>
+	expr::Scalar<E, expr::RSub> operator-(S n, const MatExpr<E>& M)
+	{
+		return expr::Scalar<E, expr::RSub>(M.self(), static_cast<typename E::value_type>(n));
+	}
+}
@@ -0,0 +1,458 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/matrix_view.h>
+#include <libmath/math_exception.h>
+#include <libmath/math_settings.h>
+
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <vector>
+
+/// @brief Memory-mapped loading of matrix files (POSIX hosts). On other targets MappedMatrix reads the file.
+#ifndef MATH_HAS_MMAP
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(ARDUINO) && !defined(ESP_PLATFORM)
+#define MATH_HAS_MMAP 1
+#else
+#define MATH_HAS_MMAP 0
+#endif
+#endif
+
+#if MATH_HAS_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace math
+{
+	/**
+	* @brief Type of elements in matrix file
+	*/
+	enum class ElementType : uint32_t
+	{
+		Float32 = 1,
+		Float64,
+		Int32,
+		Int64
+	};
+
+	/**
+	* @brief Header of binary matrix file
+	* @details File is the header followed by rows*cols elements starting from dataOffset,
+	* in order of layout (row by row or column by column) without gaps and in native byte order.
+	* dataOffset is a multiple of alignment, so mapped elements are aligned as Matrix storage.
+	* All fields are fixed-width, header is 64 bytes.
+	*/
+	struct MatrixFileHeader
+	{
+		/// @brief "QPMATRIX" without terminating zero
+		char magic[8];
+		uint32_t version;
+		/// @brief byteOrderMark as written by host, other value means file of different byte order
+		uint32_t byteOrder;
+		ElementType type;
+		uint32_t elementSize;
+		/// @brief MatRep of elements
+		uint32_t layout;
+		uint32_t alignment;
+		uint64_t rows;
+		uint64_t cols;
+		uint64_t dataOffset;
+		uint64_t reserved;
+
+		static constexpr char signature[8] = { 'Q', 'P', 'M', 'A', 'T', 'R', 'I', 'X' };
+		static constexpr uint32_t currentVersion = 1;
+		static constexpr uint32_t byteOrderMark = 0x01020304;
+	};
+
+	static_assert(sizeof(MatrixFileHeader) == 64, "MatrixFileHeader must be 64 bytes");
+
+	namespace detail
+	{
+		template <typename T>
+		struct ElementTypeOf;
+
+		template <>
+		struct ElementTypeOf<float>
+		{
+			static constexpr ElementType value = ElementType::Float32;
+		};
+
+		template <>
+		struct ElementTypeOf<double>
+		{
+			static constexpr ElementType value = ElementType::Float64;
+		};
+
+		template <>
+		struct ElementTypeOf<int32_t>
+		{
+			static constexpr ElementType value = ElementType::Int32;
+		};
+
+		template <>
+		struct ElementTypeOf<int64_t>
+		{
+			static constexpr ElementType value = ElementType::Int64;
+		};
+
+		/// @brief Alignment of elements in files of type T
+		template <typename T>
+		constexpr size_t fileAlignment()
+		{
+			return std::max(settings::alignment, alignof(T));
+		}
+
+		/**
+		* @brief Check header read from file path for elements of type T and file of fileSize bytes
+		* @param method: Name of calling function for messages
+		* @throws math::ExceptionIO
+		*/
+		template <typename T>
+		void checkHeader(const MatrixFileHeader& h, uint64_t fileSize, const char* method, const std::string& path)
+		{
+			const std::string where = std::string(method) + ": " + path + ": ";
+			if (std::memcmp(h.magic, MatrixFileHeader::signature, sizeof(h.magic)) != 0)
+			{
+				throw(ExceptionIO(where + "not a matrix file!"));
+			}
+			if (h.byteOrder != MatrixFileHeader::byteOrderMark)
+			{
+				throw(ExceptionIO(where + "byte order of file differs from host!"));
+			}
+			if (h.version != MatrixFileHeader::currentVersion)
+			{
+				throw(ExceptionIO(where + "unsupported version " + std::to_string(h.version) + "!"));
+			}
+			if (h.type != ElementTypeOf<T>::value || h.elementSize != sizeof(T))
+			{
+				throw(ExceptionIO(where + "type of elements differs from requested!"));
+			}
+			if (h.layout > static_cast<uint32_t>(MatRep::Column))
+			{
+				throw(ExceptionIO(where + "unknown layout!"));
+			}
+			if (h.dataOffset < sizeof(MatrixFileHeader) || h.dataOffset % alignof(T) != 0)
+			{
+				throw(ExceptionIO(where + "incorrect offset of data!"));
+			}
+			if (h.cols != 0 && h.rows > (UINT64_MAX - h.dataOffset) / sizeof(T) / h.cols)
+			{
+				throw(ExceptionIO(where + "dimensions are too large!"));
+			}
+			if (h.dataOffset + h.rows * h.cols * sizeof(T) > fileSize)
+			{
+				throw(ExceptionIO(where + "file is truncated!"));
+			}
+		}
+
+		/// @brief Read exactly bytes to dst
+		inline void readBytes(std::FILE* f, void* dst, size_t bytes, const std::string& path)
+		{
+			if (bytes != 0 && std::fread(dst, 1, bytes, f) != bytes)
+			{
+				throw(ExceptionIO("math::loadMatrix: " + path + ": read error!"));
+			}
+		}
+
+		/// @brief Closes file on scope exit
+		struct FileCloser
+		{
+			std::FILE* f;
+
+			~FileCloser()
+			{
+				if (f)
+				{
+					std::fclose(f);
+				}
+			}
+		};
+
+		/**
+		* @brief Read and check header of opened file path, file is positioned at the first element
+		* @throws math::ExceptionIO
+		*/
+		template <typename T>
+		MatrixFileHeader readHeader(std::FILE* f, const std::string& path)
+		{
+			MatrixFileHeader h;
+			readBytes(f, &h, sizeof(h), path);
+			if (std::fseek(f, 0, SEEK_END) != 0)
+			{
+				throw(ExceptionIO("math::loadMatrix: " + path + ": seek error!"));
+			}
+			const long size = std::ftell(f);
+			checkHeader<T>(h, size < 0 ? 0 : static_cast<uint64_t>(size), "math::loadMatrix", path);
+			if (std::fseek(f, static_cast<long>(h.dataOffset), SEEK_SET) != 0)
+			{
+				throw(ExceptionIO("math::loadMatrix: " + path + ": seek error!"));
+			}
+			return h;
+		}
+	}
+
+	/**
+	* @brief Write matrix expression to binary file (see MatrixFileHeader)
+	* @details Elements are written in order of e.representation(), type of elements is E::value_type
+	* (float, double, int32_t or int64_t). Dense Matrix is written directly from its storage, other
+	* expressions are evaluated line by line.
+	* @throws math::ExceptionIO if file can't be written
+	*/
+	template <typename E>
+	void saveMatrix(const std::string& path, const MatExpr<E>& expr)
+	{
+		typedef typename E::value_type T;
+		const E& e = expr.self();
+		const size_t alignment = detail::fileAlignment<T>();
+
+		MatrixFileHeader h = {};
+		std::memcpy(h.magic, MatrixFileHeader::signature, sizeof(h.magic));
+		h.version = MatrixFileHeader::currentVersion;
+		h.byteOrder = MatrixFileHeader::byteOrderMark;
+		h.type = detail::ElementTypeOf<T>::value;
+		h.elementSize = sizeof(T);
+		h.layout = static_cast<uint32_t>(e.representation());
+		h.alignment = static_cast<uint32_t>(alignment);
+		h.rows = e.rows();
+		h.cols = e.cols();
+		h.dataOffset = (sizeof(MatrixFileHeader) + alignment - 1) / alignment * alignment;
+
+		std::FILE* f = std::fopen(path.c_str(), "wb");
+		if (!f)
+		{
+			throw(ExceptionIO("math::saveMatrix: " + path + ": can't open file for writing!"));
+		}
+		detail::FileCloser closer{ f };
+
+		const auto write = [&](const void* src, size_t bytes)
+			{
+				if (bytes != 0 && std::fwrite(src, 1, bytes, f) != bytes)
+				{
+					throw(ExceptionIO("math::saveMatrix: " + path + ": write error!"));
+				}
+			};
+
+		write(&h, sizeof(h));
+		const std::vector<char> padding(h.dataOffset - sizeof(h), 0);
+		write(padding.data(), padding.size());
+
+		if constexpr (std::is_same<E, Matrix<T>>::value)
+		{
+			write(e.data(), e.numel() * sizeof(T));
+		}
+		else
+		{
+			const bool rowOrder = e.representation() == MatRep::Row;
+			const size_t lines = rowOrder ? e.rows() : e.cols();
+			const size_t length = rowOrder ? e.cols() : e.rows();
+			std::vector<T> line(length);
+			for (size_t l = 0; l < lines; ++l)
+			{
+				for (size_t k = 0; k < length; ++k)
+				{
+					line[k] = rowOrder ? e.coeff(l, k) : e.coeff(k, l);
+				}
+				write(line.data(), length * sizeof(T));
+			}
+		}
+
+		closer.f = nullptr;
+		if (std::fclose(f) != 0)
+		{
+			throw(ExceptionIO("math::saveMatrix: " + path + ": write error!"));
+		}
+	}
+
+	/**
+	* @brief Read binary matrix file (see MatrixFileHeader) into Matrix of file's layout
+	* @throws math::ExceptionIO if file can't be read, has wrong format or other type of elements
+	*/
+	template <typename T>
+	Matrix<T> loadMatrix(const std::string& path)
+	{
+		std::FILE* f = std::fopen(path.c_str(), "rb");
+		if (!f)
+		{
+			throw(ExceptionIO("math::loadMatrix: " + path + ": can't open file!"));
+		}
+		detail::FileCloser closer{ f };
+		const MatrixFileHeader h = detail::readHeader<T>(f, path);
+
+		Matrix<T> result(static_cast<size_t>(h.rows), static_cast<size_t>(h.cols), static_cast<MatRep>(h.layout));
+		detail::readBytes(f, result.data(), result.numel() * sizeof(T), path);
+		return result;
+	}
+
+	/**
+	* @brief Read-only matrix file mapped to memory
+	* @details On POSIX hosts (MATH_HAS_MMAP) file is mapped by mmap: opening doesn't read or parse
+	* elements and takes constant time regardless of file size, pages are loaded by OS on access.
+	* On other targets (ESP32) file is read to memory once by loadMatrix().
+	* Elements are accessed through view(), which stays valid while MappedMatrix is alive.
+	*
+	* Example of using in C++:
+	* @code
+	* #include <libmath/matrix_io.h>
+	*
+	* int main()
+	* {
+	*	math::Matrix<double> table(1000, 18);
+	*	math::saveMatrix("gait.qpm", table);
+	*
+	*	math::MappedMatrix<double> mapped("gait.qpm");
+	*	math::ConstMatrixView<double> t = mapped.view();
+	*	math::Matrix<double> step = t.row(10);
+	* }
+	* @endcode
+	*/
+	template <typename T>
+	class MappedMatrix
+	{
+	public:
+		MappedMatrix() = default;
+
+		/**
+		 * @brief Map file path
+		 * @throws math::ExceptionIO if file can't be opened or mapped, has wrong format or other type of elements
+		 */
+		explicit MappedMatrix(const std::string& path)
+		{
+#if MATH_HAS_MMAP
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+			{
+				throw(ExceptionIO("math::MappedMatrix: " + path + ": can't open file!"));
+			}
+			struct stat st;
+			if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(MatrixFileHeader))
+			{
+				::close(fd);
+				throw(ExceptionIO("math::MappedMatrix: " + path + ": not a matrix file!"));
+			}
+			void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+			if (p == MAP_FAILED)
+			{
+				throw(ExceptionIO("math::MappedMatrix: " + path + ": can't map file!"));
+			}
+			map_ = p;
+			mapSize_ = static_cast<size_t>(st.st_size);
+
+			MatrixFileHeader h;
+			std::memcpy(&h, map_, sizeof(h));
+			try
+			{
+				detail::checkHeader<T>(h, mapSize_, "math::MappedMatrix", path);
+			}
+			catch (...)
+			{
+				unmap();
+				throw;
+			}
+			data_ = reinterpret_cast<const T*>(static_cast<const char*>(map_) + h.dataOffset);
+			rows_ = static_cast<size_t>(h.rows);
+			cols_ = static_cast<size_t>(h.cols);
+			repr_ = static_cast<MatRep>(h.layout);
+#else
+			copy_ = loadMatrix<T>(path);
+#endif
+		}
+
+		MappedMatrix(const MappedMatrix&) = delete;
+		MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+		MappedMatrix(MappedMatrix&& other) noexcept
+		{
+			swap(other);
+		}
+
+		MappedMatrix& operator=(MappedMatrix&& other) noexcept
+		{
+			if (this != &other)
+			{
+				MappedMatrix(std::move(other)).swap(*this);
+			}
+			return *this;
+		}
+
+		~MappedMatrix()
+		{
+			unmap();
+		}
+
+		/// @brief Read-only view of elements
+		ConstMatrixView<T> view() const
+		{
+#if MATH_HAS_MMAP
+			return ConstMatrixView<T>(data_, rows_, cols_, repr_);
+#else
+			return copy_.view();
+#endif
+		}
+
+		size_t rows() const
+		{
+			return view().rows();
+		}
+
+		size_t cols() const
+		{
+			return view().cols();
+		}
+
+		/// @brief Layout of elements in file
+		MatRep representation() const
+		{
+#if MATH_HAS_MMAP
+			return repr_;
+#else
+			return copy_.representation();
+#endif
+		}
+
+		void swap(MappedMatrix& other) noexcept
+		{
+			std::swap(map_, other.map_);
+			std::swap(mapSize_, other.mapSize_);
+			std::swap(data_, other.data_);
+			std::swap(rows_, other.rows_);
+			std::swap(cols_, other.cols_);
+			std::swap(repr_, other.repr_);
+#if !MATH_HAS_MMAP
+			std::swap(copy_, other.copy_);
+#endif
+		}
+
+	private:
+		void* map_ = nullptr;
+		size_t mapSize_ = 0;
+		const T* data_ = nullptr;
+		size_t rows_ = 0;
+		size_t cols_ = 0;
+		MatRep repr_ = MatRep::Row;
+#if !MATH_HAS_MMAP
+		Matrix<T> copy_;
+#endif
+
+		void unmap() noexcept
+		{
+#if MATH_HAS_MMAP
+			if (map_)
+			{
+				::munmap(map_, mapSize_);
+			}
+#endif
+			map_ = nullptr;
+			mapSize_ = 0;
+		}
+	};
+}
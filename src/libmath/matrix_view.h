@@ -0,0 +1,348 @@
+#pragma once
+
+#include <libmath/matrix_expr.h>
+#include <libmath/elementwise.h>
+#include <libmath/math_exception.h>
+#include <libmath/math_settings.h>
+
+#include <type_traits>
+#include <algorithm>
+#include <string>
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Non-owning strided view of matrix elements
+	* @details Element (i,j) of the view is data()[i * rowStride() + j * colStride()], so the same type
+	* describes a whole Matrix, its block, row, column or diagonal, a transposed matrix and an external
+	* buffer (e.g. I/O or DMA buffer) without copying. T may be const-qualified (see ConstMatrixView),
+	* then elements can't be changed through the view.
+	*
+	* View is a matrix expression: it can be used in elementwise expressions, assigned to Matrix and
+	* multiplied (operator*, gemm, gemv). Assignment of expression to view writes elements of the viewed
+	* storage, dimensions of the view don't change. Owner of elements must outlive the view.
+	*
+	* Example of using in C++:
+	* @code
+	* #include <libmath/matrix.h>
+	*
+	* int main()
+	* {
+	*	math::Matrix<double> J(12, 18);
+	*	// Jacobian of leg 2 (rows 6:9) is updated in place
+	*	math::MatrixView<double> Jleg = J.block(6, 0, 3, 18);
+	*	Jleg.fill(0.0);
+	*
+	*	// external buffer 3*4 in row order
+	*	float buffer[12] = {};
+	*	math::MatrixView<float> B(buffer, 3, 4);
+	*	B.col(0) = B.col(1) + B.col(2);
+	* }
+	* @endcode
+	* @note Result of assignment is undefined, if the right side reads elements of the view,
+	* which are already overwritten (overlapping views). Assign to a temporary Matrix in this case.
+	*/
+	template <typename T>
+	class MatrixView :
+		public MatExpr<MatrixView<T>>
+	{
+	public:
+		/// @brief Type of elements (without const)
+		typedef std::remove_const_t<T> value_type;
+
+		MatrixView() = default;
+
+		/**
+		 * @brief View of strided storage
+		 * @param data: Pointer to element (0,0)
+		 * @param rowStride: Distance between elements (i,j) and (i+1,j)
+		 * @param colStride: Distance between elements (i,j) and (i,j+1)
+		 */
+		MatrixView(T* data, size_t rows, size_t cols, size_t rowStride, size_t colStride)
+			: data_{ data }, rows_{ rows }, cols_{ cols }, rs_{ rowStride }, cs_{ colStride }
+		{
+		}
+
+		/**
+		 * @brief View of contiguous buffer rows*cols
+		 * @param repr: Order of elements in buffer
+		 */
+		MatrixView(T* data, size_t rows, size_t cols, MatRep repr = MatRep::Row)
+			: MatrixView(data, rows, cols,
+				repr == MatRep::Row ? cols : 1,
+				repr == MatRep::Row ? 1 : rows)
+		{
+		}
+
+		/**
+		 * @brief View of mutable elements is also a view of constant elements
+		 */
+		template <typename U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+		MatrixView(const MatrixView<U>& other)
+			: MatrixView(other.data(), other.rows(), other.cols(), other.rowStride(), other.colStride())
+		{
+		}
+
+		MatrixView(const MatrixView&) = default;
+
+		/**
+		 * @brief Copy elements of other view of the same dimensions
+		 * @details View isn't rebound, elements are written (see operator=(const MatExpr<E>&))
+		 */
+		MatrixView& operator=(const MatrixView& other)
+		{
+			return assign(other);
+		}
+
+		/**
+		 * @brief Write result of expression to viewed elements
+		 * @throws math::ExceptionInvalidValue if dimensions didn't agree
+		 */
+		template <typename E>
+		MatrixView& operator=(const MatExpr<E>& expr)
+		{
+			return assign(expr.self());
+		}
+
+		template <typename E>
+		MatrixView& operator+=(const MatExpr<E>& expr)
+		{
+			return apply(expr.self(), detail::AddAssign(), "MatrixView::operator+=");
+		}
+
+		template <typename E>
+		MatrixView& operator-=(const MatExpr<E>& expr)
+		{
+			return apply(expr.self(), detail::SubAssign(), "MatrixView::operator-=");
+		}
+
+		MatrixView& operator*=(value_type n)
+		{
+			forEach([n](value_type& v) { v *= n; });
+			return *this;
+		}
+
+		/**
+		 * @brief Set all viewed elements to val
+		 */
+		void fill(value_type val)
+		{
+			forEach([val](value_type& v) { v = val; });
+		}
+
+		size_t rows() const
+		{
+			return rows_;
+		}
+
+		size_t cols() const
+		{
+			return cols_;
+		}
+
+		size_t numel() const
+		{
+			return rows_ * cols_;
+		}
+
+		T* data() const
+		{
+			return data_;
+		}
+
+		size_t rowStride() const
+		{
+			return rs_;
+		}
+
+		size_t colStride() const
+		{
+			return cs_;
+		}
+
+		/// @brief Order of enumeration of elements in expressions (the order with smaller stride inside)
+		MatRep representation() const
+		{
+			return (cs_ <= rs_ || rows_ == 1) ? MatRep::Row : MatRep::Column;
+		}
+
+		/// @brief View itself (see Matrix::view())
+		const MatrixView& view() const
+		{
+			return *this;
+		}
+
+		/// @brief elem() computes (row, col) from pos, so expressions are evaluated by coeff() (see MatExpr)
+		bool linear() const
+		{
+			return false;
+		}
+
+		/// @brief View reads memory [begin, end) (see MatExpr)
+		bool aliases(const void* begin, const void* end) const
+		{
+			if (rows_ == 0 || cols_ == 0)
+			{
+				return false;
+			}
+			return expr::overlaps(data_, data_ + (rows_ - 1) * rs_ + (cols_ - 1) * cs_ + 1, begin, end);
+		}
+
+		/**
+		 * @brief Element of linear position pos in order of representation() (see MatExpr)
+		 */
+		value_type elem(size_t pos) const
+		{
+			if (representation() == MatRep::Row)
+			{
+				const size_t row = pos / cols_;
+				return data_[row * rs_ + (pos - row * cols_) * cs_];
+			}
+			const size_t col = pos / rows_;
+			return data_[(pos - col * rows_) * rs_ + col * cs_];
+		}
+
+		/**
+		 * @brief Element at position (row, col) without check of indices
+		 */
+		value_type coeff(size_t row, size_t col) const
+		{
+			return data_[row * rs_ + col * cs_];
+		}
+
+		/**
+		 * @brief Reference to element at position (row, col) without check of indices
+		 */
+		T& coeffRef(size_t row, size_t col) const
+		{
+			return data_[row * rs_ + col * cs_];
+		}
+
+		/**
+		 * @brief Reference to element with check of indices
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		T& at(size_t row, size_t col) const
+		{
+			if (row >= rows_ || col >= cols_)
+			{
+				throw(ExceptionIndexOutOfBounds("MatrixView::at: index out of bounds!"));
+			}
+			return coeffRef(row, col);
+		}
+
+		T& operator()(size_t row, size_t col) const
+		{
+			if constexpr (settings::boundsCheck)
+			{
+				return at(row, col);
+			}
+			return coeffRef(row, col);
+		}
+
+		/**
+		 * @brief View of block rows*cols starting from element (row, col)
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		MatrixView block(size_t row, size_t col, size_t rows, size_t cols) const
+		{
+			if (row + rows > rows_ || col + cols > cols_)
+			{
+				throw(ExceptionIndexOutOfBounds("MatrixView::block: block out of bounds!"));
+			}
+			return MatrixView(data_ + row * rs_ + col * cs_, rows, cols, rs_, cs_);
+		}
+
+		/**
+		 * @brief View of row as row vector 1*cols()
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		MatrixView row(size_t row) const
+		{
+			return block(row, 0, 1, cols_);
+		}
+
+		/**
+		 * @brief View of column as column vector rows()*1
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		MatrixView col(size_t col) const
+		{
+			return block(0, col, rows_, 1);
+		}
+
+		/**
+		 * @brief View of main diagonal as column vector min(rows(), cols())*1
+		 */
+		MatrixView diag() const
+		{
+			return MatrixView(data_, std::min(rows_, cols_), 1, rs_ + cs_, cs_);
+		}
+
+		/**
+		 * @brief Transposed view of the same elements
+		 */
+		MatrixView t() const
+		{
+			return MatrixView(data_, cols_, rows_, cs_, rs_);
+		}
+
+	private:
+		T* data_ = nullptr;
+		size_t rows_ = 0;
+		size_t cols_ = 0;
+		size_t rs_ = 0;
+		size_t cs_ = 0;
+
+		template <typename E>
+		void check(const E& e, const char* method) const
+		{
+			if (e.rows() != rows_ || e.cols() != cols_)
+			{
+				throw(math::ExceptionInvalidValue(std::string(method) + ": dimensions of view and expression didn't agree!"));
+			}
+		}
+
+		/// @brief Call f(element) for every element, inner loop goes along smaller stride
+		template <typename F>
+		void forEach(F f) const
+		{
+			static_assert(!std::is_const<T>::value, "MatrixView: elements of constant view can't be changed");
+			detail::forEachElement(data_, rows_, cols_, rs_, cs_, [&f](T& v, size_t, size_t) { f(v); });
+		}
+
+		/// @brief Evaluate expression to viewed elements with operation op (see detail::evaluate)
+		template <typename E, typename Op>
+		MatrixView& apply(const E& e, Op op, const char* method)
+		{
+			static_assert(!std::is_const<T>::value, "MatrixView: elements of constant view can't be changed");
+			check(e, method);
+			detail::evaluate(e, data_, rs_, cs_, op);
+			return *this;
+		}
+
+		template <typename E>
+		MatrixView& assign(const E& e)
+		{
+			return apply(e, detail::Assign(), "MatrixView::operator=");
+		}
+	};
+
+	/// @brief View of constant elements
+	template <typename T>
+	using ConstMatrixView = MatrixView<const T>;
+
+	namespace detail
+	{
+		template <typename X>
+		struct IsMatrixView : std::false_type
+		{
+		};
+
+		template <typename T>
+		struct IsMatrixView<MatrixView<T>> : std::true_type
+		{
+		};
+	}
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <libmath/math_settings.h>
+
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace math
+{
+	/**
+	* @brief Source of memory for matrix storage and work buffers
+	* @details Minimal replacement of std::pmr::memory_resource, which isn't available in every
+	* toolchain of the project. Storage of Matrix is allocated from defaultResource() at the moment
+	* of allocation and is returned to the same resource.
+	*/
+	class MemoryResource
+	{
+	public:
+		virtual ~MemoryResource() = default;
+
+		/**
+		 * @brief Allocate bytes aligned to alignment (power of 2)
+		 */
+		void* allocate(size_t bytes, size_t alignment = settings::alignment)
+		{
+			return doAllocate(bytes, alignment);
+		}
+
+		/**
+		 * @brief Return memory, obtained by allocate() with the same bytes and alignment
+		 */
+		void deallocate(void* p, size_t bytes, size_t alignment = settings::alignment)
+		{
+			doDeallocate(p, bytes, alignment);
+		}
+
+	protected:
+		virtual void* doAllocate(size_t bytes, size_t alignment) = 0;
+		virtual void doDeallocate(void* p, size_t bytes, size_t alignment) = 0;
+	};
+
+	/**
+	* @brief Aligned global operator new and delete
+	*/
+	class NewDeleteResource :
+		public MemoryResource
+	{
+	protected:
+		virtual void* doAllocate(size_t bytes, size_t alignment) override
+		{
+			return ::operator new(bytes, std::align_val_t(alignment));
+		}
+
+		virtual void doDeallocate(void* p, size_t /*bytes*/, size_t alignment) override
+		{
+			::operator delete(p, std::align_val_t(alignment));
+		}
+	};
+
+	/**
+	* @brief Resource of aligned global new and delete, initial default resource
+	*/
+	inline MemoryResource* newDeleteResource()
+	{
+		static NewDeleteResource resource;
+		return &resource;
+	}
+
+	namespace detail
+	{
+		/// @brief Default resource of current thread
+		inline thread_local MemoryResource* defaultResource = newDeleteResource();
+	}
+
+	/**
+	* @brief Resource used by new allocations of Matrix in current thread
+	*/
+	inline MemoryResource* defaultResource()
+	{
+		return detail::defaultResource;
+	}
+
+	/**
+	* @brief Set resource for new allocations of Matrix in current thread
+	* @param resource: New resource, nullptr restores newDeleteResource()
+	* @return Previous resource
+	*/
+	inline MemoryResource* setDefaultResource(MemoryResource* resource)
+	{
+		MemoryResource* previous = detail::defaultResource;
+		detail::defaultResource = resource ? resource : newDeleteResource();
+		return previous;
+	}
+
+	/**
+	* @brief Set default resource for lifetime of the object and restore previous one at the end of scope
+	*/
+	class ScopedResource
+	{
+	public:
+		explicit ScopedResource(MemoryResource* resource)
+			: previous_{ setDefaultResource(resource) }
+		{
+		}
+
+		ScopedResource(const ScopedResource&) = delete;
+		ScopedResource& operator=(const ScopedResource&) = delete;
+
+		~ScopedResource()
+		{
+			setDefaultResource(previous_);
+		}
+
+	private:
+		MemoryResource* previous_;
+	};
+
+	/**
+	* @brief Work buffer of n elements from defaultResource(), aligned to settings::alignment
+	* @details Elements aren't initialized. T must be trivially copyable.
+	*/
+	template <typename T>
+	class AlignedBuffer
+	{
+	public:
+		explicit AlignedBuffer(size_t n)
+			: resource_{ defaultResource() }, size_{ n },
+			data_{ static_cast<T*>(resource_->allocate(std::max<size_t>(n, 1) * sizeof(T))) }
+		{
+		}
+
+		AlignedBuffer(const AlignedBuffer&) = delete;
+		AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+		~AlignedBuffer()
+		{
+			resource_->deallocate(data_, std::max<size_t>(size_, 1) * sizeof(T));
+		}
+
+		T* data()
+		{
+			return data_;
+		}
+
+		size_t size() const
+		{
+			return size_;
+		}
+
+	private:
+		MemoryResource* resource_;
+		size_t size_;
+		T* data_;
+	};
+
+	/**
+	* @brief Monotonic arena for temporaries of one control cycle
+	* @details Allocation moves a pointer inside a buffer, deallocation does nothing. Memory is reused
+	* only after reset(), which is called once per cycle, when temporaries of the cycle are destroyed.
+	* When the buffer is exhausted, additional blocks are taken from upstream resource, and the next
+	* reset() replaces all blocks by one buffer of total size, so a cycle with the same allocations
+	* doesn't touch upstream resource any more.
+	*
+	* Example of using in C++:
+	* @code
+	* #include <libmath/memory_resource.h>
+	* #include <libmath/matrix.h>
+	*
+	* math::MonotonicArena arena(16 * 1024);
+	*
+	* void loop()
+	* {
+	*	{
+	*		math::ScopedResource scope(&arena);
+	*		math::Matrix<double> J(6, 6);
+	*		// ... temporaries of the cycle are allocated from arena
+	*	}
+	*	arena.reset();
+	* }
+	* @endcode
+	* @note Matrices allocated from arena must not outlive the next reset()
+	*/
+	class MonotonicArena :
+		public MemoryResource
+	{
+	public:
+		/**
+		 * @param capacity: Size of initial buffer in bytes
+		 * @param upstream: Resource of buffers
+		 */
+		explicit MonotonicArena(size_t capacity, MemoryResource* upstream = newDeleteResource())
+			: upstream_{ upstream }
+		{
+			addBlock(capacity);
+		}
+
+		MonotonicArena(const MonotonicArena&) = delete;
+		MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+		~MonotonicArena()
+		{
+			releaseBlocks();
+		}
+
+		/**
+		 * @brief Make all memory of arena available again
+		 * @details All memory allocated from arena becomes invalid
+		 */
+		void reset()
+		{
+			if (blocks_.size() > 1)
+			{
+				size_t total = 0;
+				for (const Block& b : blocks_)
+				{
+					total += b.size;
+				}
+				releaseBlocks();
+				addBlock(total);
+			}
+			else
+			{
+				current_ = blocks_.front().data;
+				end_ = current_ + blocks_.front().size;
+			}
+			used_ = 0;
+		}
+
+		/// @brief Bytes allocated since the last reset() including alignment gaps
+		size_t used() const
+		{
+			return used_;
+		}
+
+		/// @brief Total size of buffers
+		size_t capacity() const
+		{
+			size_t total = 0;
+			for (const Block& b : blocks_)
+			{
+				total += b.size;
+			}
+			return total;
+		}
+
+	protected:
+		virtual void* doAllocate(size_t bytes, size_t alignment) override
+		{
+			size_t gap = padding(current_, alignment);
+			if (gap + bytes > static_cast<size_t>(end_ - current_))
+			{
+				addBlock(std::max(bytes + alignment, 2 * blocks_.back().size));
+				gap = padding(current_, alignment);
+			}
+			char* p = current_ + gap;
+			used_ += gap + bytes;
+			current_ = p + bytes;
+			return p;
+		}
+
+		virtual void doDeallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) override
+		{
+		}
+
+	private:
+		struct Block
+		{
+			char* data;
+			size_t size;
+		};
+
+		MemoryResource* upstream_;
+		std::vector<Block> blocks_;
+		char* current_ = nullptr;
+		char* end_ = nullptr;
+		size_t used_ = 0;
+
+		/// @brief Bytes from p to the next address aligned to alignment
+		static size_t padding(const char* p, size_t alignment)
+		{
+			const std::uintptr_t a = reinterpret_cast<std::uintptr_t>(p);
+			return static_cast<size_t>((alignment - a % alignment) % alignment);
+		}
+
+		void addBlock(size_t size)
+		{
+			size = std::max<size_t>(size, settings::alignment);
+			Block b{ static_cast<char*>(upstream_->allocate(size, settings::alignment)), size };
+			blocks_.push_back(b);
+			current_ = b.data;
+			end_ = b.data + b.size;
+		}
+
+		void releaseBlocks()
+		{
+			for (const Block& b : blocks_)
+			{
+				upstream_->deallocate(b.data, b.size, settings::alignment);
+			}
+			blocks_.clear();
+		}
+	};
+}
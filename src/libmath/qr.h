@@ -0,0 +1,330 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <libmath/blas/qr.h>
+#include <libmath/blas/layout.h>
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+namespace math
+{
+	/**
+	* @brief Form of factors of QR factorization of matrix m*n, k = min(m, n)
+	*	- Thin: Q is m*k, R is k*n
+	*	- Full: Q is m*m, R is m*n
+	*/
+	enum class QRMode
+	{
+		Thin = 0,
+		Full
+	};
+
+	/**
+	* @brief Householder QR factorization @f$ \mathbf{A} = \mathbf{Q} \mathbf{R} @f$ of matrix m*n
+	* @details Matrix is factorized once (blocked algorithm, see blas::geqrf), after that least squares
+	* problems with any number of right-hand sides are solved by the same factorization. Q isn't formed
+	* for solving: it is applied to right-hand sides by block reflectors.
+	* Unlike normal equations @f$ \mathbf{A}^T \mathbf{A} \mathbf{x} = \mathbf{A}^T \mathbf{b} @f$ condition
+	* number of A isn't squared.
+	*
+	* Example of using in C++:
+	* @code
+	* #include <libmath/qr.h>
+	*
+	* int main()
+	* {
+	*	// fit of line y = c0 + c1 * x
+	*	math::Matrix<double> A = { {1.0, 0.0}, {1.0, 1.0}, {1.0, 2.0}, {1.0, 3.0} };
+	*	math::Matrix<double> y = { {0.1}, {0.9}, {2.1}, {2.9} };
+	*	math::QR<double> qr(A);
+	*	math::Matrix<double> c = qr.solve(y);
+	*
+	*	// the same in one call
+	*	c = math::lstsq(A, y);
+	* }
+	* @endcode
+	*/
+	template <typename T>
+	class QR
+	{
+	public:
+		/**
+		* @brief Empty factorization, factorize() must be called before use
+		*/
+		QR() = default;
+
+		/**
+		* @brief Factorize matrix A
+		*/
+		explicit QR(const Matrix<T>& A)
+		{
+			factorize(A);
+		}
+
+		/**
+		* @brief Factorize matrix A, previous factorization is replaced
+		* @details Storage of previous factorization of the same size is reused.
+		*/
+		void factorize(const Matrix<T>& A)
+		{
+			const size_t m = A.rows();
+			const size_t n = A.cols();
+			// factors are stored in representation of A, kernels are specialized for the layout
+			qr_ = A;
+			t_.resize(blas::qrFactorSize(std::min(m, n)));
+			detail::withLayout(qr_.representation(), [this, m, n](auto layout)
+				{
+					blas::geqrf<decltype(layout)>(m, n, qr_.data(), ld(), t_.data());
+				});
+			factorized_ = true;
+		}
+
+		/// @brief Was factorize() called
+		bool factorized() const
+		{
+			return factorized_;
+		}
+
+		/// @brief Number of rows of factorized matrix
+		size_t rows() const
+		{
+			return qr_.rows();
+		}
+
+		/// @brief Number of columns of factorized matrix
+		size_t cols() const
+		{
+			return qr_.cols();
+		}
+
+		/**
+		* @brief Householder vectors below diagonal and R in upper triangle (in representation of factorized matrix)
+		*/
+		const Matrix<T>& matrix() const
+		{
+			return qr_;
+		}
+
+		/**
+		* @brief Numerical rank: number of diagonal elements of R, which are greater than
+		* max(m, n) * epsilon * max|R(i,i)| by absolute value
+		*/
+		size_t rank() const
+		{
+			check("rank");
+			const size_t k = std::min(rows(), cols());
+			T rmax = static_cast<T>(0);
+			for (size_t i = 0; i < k; ++i)
+			{
+				rmax = std::max(rmax, std::abs(qr_.coeff(i, i)));
+			}
+			const T tol = static_cast<T>(std::max(rows(), cols())) * std::numeric_limits<T>::epsilon() * rmax;
+			size_t r = 0;
+			for (size_t i = 0; i < k; ++i)
+			{
+				if (std::abs(qr_.coeff(i, i)) > tol)
+				{
+					++r;
+				}
+			}
+			return r;
+		}
+
+		/**
+		* @brief Upper triangular (trapezoidal) factor R: k*n (Thin) or m*n (Full)
+		*/
+		Matrix<T> R(QRMode mode = QRMode::Thin) const
+		{
+			check("R");
+			const size_t k = std::min(rows(), cols());
+			Matrix<T> result(mode == QRMode::Thin ? k : rows(), cols());
+			for (size_t i = 0; i < k; ++i)
+			{
+				for (size_t j = i; j < cols(); ++j)
+				{
+					result.coeffRef(i, j) = qr_.coeff(i, j);
+				}
+			}
+			return result;
+		}
+
+		/**
+		* @brief Orthogonal factor Q: m*k (Thin) or m*m (Full)
+		* @details Q is formed by application of reflectors to columns of identity matrix
+		*/
+		Matrix<T> Q(QRMode mode = QRMode::Thin) const
+		{
+			check("Q");
+			const size_t m = rows();
+			Matrix<T> result(m, mode == QRMode::Thin ? std::min(m, cols()) : m);
+			for (size_t i = 0; i < result.cols(); ++i)
+			{
+				result.coeffRef(i, i) = static_cast<T>(1);
+			}
+			applyQ(result);
+			return result;
+		}
+
+		/**
+		* @brief B = Q * B in place, B is m*p of any representation
+		* @throws math::ExceptionIncorrectMatrix
+		*/
+		void applyQ(Matrix<T>& B) const
+		{
+			apply(false, B, "applyQ");
+		}
+
+		/**
+		* @brief B = Q^T * B in place, B is m*p of any representation
+		* @throws math::ExceptionIncorrectMatrix
+		*/
+		void applyQt(Matrix<T>& B) const
+		{
+			apply(true, B, "applyQt");
+		}
+
+		/**
+		* @brief Least squares solution @f$ \min \|\mathbf{A} \mathbf{X} - \mathbf{B}\|_2 @f$ of overdetermined
+		* (or square) system, @f$ \mathbf{X} = \mathbf{R}_1^{-1} (\mathbf{Q}^T \mathbf{B})_{1:n} @f$
+		* @param B: Matrix m*p (p right-hand sides)
+		* @return X n*p
+		* @throws math::ExceptionIncorrectMatrix if m < n or B has other number of rows
+		* @throws math::ExceptionDegenerateMatrix if A has not full column rank
+		*/
+		Matrix<T> solve(const Matrix<T>& B) const
+		{
+			checkSolve("solve");
+			if (B.rows() != rows())
+			{
+				throw(math::ExceptionIncorrectMatrix("QR::solve: dimensions of factorized matrix and B didn't agree!"));
+			}
+			const size_t n = cols();
+			Matrix<T> QtB(B);
+			applyQt(QtB);
+			Matrix<T> X(n, B.cols());
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t j = 0; j < B.cols(); ++j)
+				{
+					X.coeffRef(i, j) = QtB.coeff(i, j);
+				}
+			}
+			triangularSolve(false, X);
+			return X;
+		}
+
+		/**
+		* @brief Minimum norm solution of underdetermined system @f$ \mathbf{A}^T \mathbf{X} = \mathbf{B} @f$,
+		* @f$ \mathbf{X} = \mathbf{Q}_1 \mathbf{R}_1^{-T} \mathbf{B} @f$
+		* @details Used for wide matrices: factorization of A^T gives minimum norm solution for A
+		* (see lstsq()).
+		* @param B: Matrix n*p (p right-hand sides)
+		* @return X m*p
+		* @throws math::ExceptionIncorrectMatrix if m < n or B has other number of rows
+		* @throws math::ExceptionDegenerateMatrix if A has not full column rank
+		*/
+		Matrix<T> solveTransposed(const Matrix<T>& B) const
+		{
+			checkSolve("solveTransposed");
+			if (B.rows() != cols())
+			{
+				throw(math::ExceptionIncorrectMatrix("QR::solveTransposed: dimensions of factorized matrix and B didn't agree!"));
+			}
+			Matrix<T> X(rows(), B.cols());
+			for (size_t i = 0; i < B.rows(); ++i)
+			{
+				for (size_t j = 0; j < B.cols(); ++j)
+				{
+					X.coeffRef(i, j) = B.coeff(i, j);
+				}
+			}
+			// top n rows of X: R^-T * B, rest are zeros
+			triangularSolve(true, X);
+			applyQ(X);
+			return X;
+		}
+
+	private:
+		/// @brief Householder vectors and R
+		Matrix<T> qr_;
+		/// @brief Triangular factors of block reflectors (see blas::geqrf)
+		std::vector<T> t_;
+		bool factorized_ = false;
+
+		size_t ld() const
+		{
+			return qr_.representation() == MatRep::Row ? qr_.cols() : qr_.rows();
+		}
+
+		void check(const char* method) const
+		{
+			if (!factorized_)
+			{
+				throw(math::Exception(std::string("QR::") + method + ": matrix isn't factorized!"));
+			}
+		}
+
+		void checkSolve(const char* method) const
+		{
+			check(method);
+			if (rows() < cols())
+			{
+				throw(math::ExceptionIncorrectMatrix(std::string("QR::") + method + ": factorized matrix has less rows than columns!"));
+			}
+			if (rank() < cols())
+			{
+				throw(math::ExceptionDegenerateMatrix(std::string("QR::") + method + ": matrix has not full column rank!"));
+			}
+		}
+
+		void apply(bool transpose, Matrix<T>& B, const char* method) const
+		{
+			check(method);
+			if (B.rows() != rows())
+			{
+				throw(math::ExceptionIncorrectMatrix(std::string("QR::") + method + ": dimensions of factorized matrix and B didn't agree!"));
+			}
+			detail::withLayout(qr_.representation(), [&](auto layout)
+				{
+					blas::ormqr<decltype(layout)>(transpose, rows(), std::min(rows(), cols()), qr_.data(), ld(), t_.data(),
+						B.cols(), B.data(), B.rowStride(), B.colStride());
+				});
+		}
+
+		/// @brief Top n rows of X = R^-1 * X or R^-T * X
+		void triangularSolve(bool transpose, Matrix<T>& X) const
+		{
+			detail::withLayout(qr_.representation(), [&](auto layout)
+				{
+					blas::trsmUpper<decltype(layout)>(transpose, cols(), qr_.data(), ld(),
+						X.cols(), X.data(), X.rowStride(), X.colStride());
+				});
+		}
+	};
+
+	/**
+	* @brief Least squares solution of @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$ by QR factorization
+	* @details Overdetermined and square systems (m >= n): @f$ \min \|\mathbf{A} \mathbf{X} - \mathbf{B}\|_2 @f$
+	* (see QR::solve). Underdetermined systems (m < n): minimum norm solution (see QR::solveTransposed).
+	* To reuse factorization for several right-hand sides use QR directly.
+	* @param A: Matrix m*n of full rank
+	* @param B: Matrix m*p (p right-hand sides)
+	* @return X n*p
+	* @throws math::ExceptionIncorrectMatrix
+	* @throws math::ExceptionDegenerateMatrix if A has not full rank
+	*/
+	template <typename T>
+	Matrix<T> lstsq(const Matrix<T>& A, const Matrix<T>& B)
+	{
+		if (A.rows() >= A.cols())
+		{
+			return QR<T>(A).solve(B);
+		}
+		return QR<T>(A.getTr()).solveTransposed(B);
+	}
+}
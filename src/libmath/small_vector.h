@@ -0,0 +1,286 @@
+#pragma once
+
+#include <libmath/memory_resource.h>
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Contiguous container with inline storage of N elements
+	* @details Up to N elements are kept inside the object, larger sizes are moved to the heap.
+	* Interface is a subset of std::vector, which is used by Matrix. Like std::vector, capacity
+	* isn't reduced by resize() or clear(). Move of inline storage copies at most N elements,
+	* move of heap storage steals the pointer. Moved-from container is empty and inline.
+	* Heap storage is aligned to settings::alignment and is taken from defaultResource()
+	* at the moment of allocation, the resource is kept to return the storage.
+	*/
+	template <typename T, size_t N>
+	class SmallVector
+	{
+		static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+			"SmallVector: elements must be trivially copyable");
+
+	public:
+		typedef T value_type;
+		typedef T* iterator;
+		typedef const T* const_iterator;
+
+		/// @brief Number of elements kept inline
+		static constexpr size_t inlineCapacity = N;
+
+		SmallVector() noexcept
+			: data_{ inline_ }, size_{ 0 }, capacity_{ N }
+		{
+		}
+
+		/**
+		 * @brief n value-initialized elements
+		 */
+		explicit SmallVector(size_t n)
+			: SmallVector()
+		{
+			resize(n);
+		}
+
+		/**
+		 * @brief Copy of std::vector with conversion of elements
+		 */
+		template <typename T1>
+		explicit SmallVector(const std::vector<T1>& vector)
+			: SmallVector()
+		{
+			assign(vector.begin(), vector.end());
+		}
+
+		SmallVector(const SmallVector& other)
+			: SmallVector()
+		{
+			assign(other.begin(), other.end());
+		}
+
+		SmallVector(SmallVector&& other) noexcept
+			: SmallVector()
+		{
+			take(other);
+		}
+
+		SmallVector& operator=(const SmallVector& other)
+		{
+			if (this != &other)
+			{
+				assign(other.begin(), other.end());
+			}
+			return *this;
+		}
+
+		SmallVector& operator=(SmallVector&& other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+				take(other);
+			}
+			return *this;
+		}
+
+		~SmallVector()
+		{
+			release();
+		}
+
+		size_t size() const
+		{
+			return size_;
+		}
+
+		bool empty() const
+		{
+			return size_ == 0;
+		}
+
+		size_t capacity() const
+		{
+			return capacity_;
+		}
+
+		/// @brief Elements are stored inside the object
+		bool isInline() const
+		{
+			return data_ == inline_;
+		}
+
+		/// @brief Resource of heap storage, nullptr for inline storage
+		MemoryResource* resource() const
+		{
+			return resource_;
+		}
+
+		T* data()
+		{
+			return data_;
+		}
+
+		const T* data() const
+		{
+			return data_;
+		}
+
+		T& operator[](size_t pos)
+		{
+			return data_[pos];
+		}
+
+		const T& operator[](size_t pos) const
+		{
+			return data_[pos];
+		}
+
+		T* begin()
+		{
+			return data_;
+		}
+
+		T* end()
+		{
+			return data_ + size_;
+		}
+
+		const T* begin() const
+		{
+			return data_;
+		}
+
+		const T* end() const
+		{
+			return data_ + size_;
+		}
+
+		/**
+		 * @brief Reserve storage for n elements, elements are kept
+		 */
+		void reserve(size_t n)
+		{
+			if (n > capacity_)
+			{
+				reallocate(n);
+			}
+		}
+
+		/**
+		 * @brief Change size, new elements are value-initialized
+		 */
+		void resize(size_t n)
+		{
+			reserve(n);
+			if (n > size_)
+			{
+				std::fill(data_ + size_, data_ + n, T());
+			}
+			size_ = n;
+		}
+
+		void clear()
+		{
+			size_ = 0;
+		}
+
+		void push_back(const T& value)
+		{
+			if (size_ == capacity_)
+			{
+				const T v = value;
+				reallocate(std::max<size_t>(2 * capacity_, 1));
+				data_[size_++] = v;
+				return;
+			}
+			data_[size_++] = value;
+		}
+
+		/**
+		 * @brief Replace elements by [first, last)
+		 */
+		template <typename It>
+		void assign(It first, It last)
+		{
+			const size_t n = static_cast<size_t>(std::distance(first, last));
+			if (n > capacity_)
+			{
+				// old elements aren't needed
+				size_ = 0;
+				reallocate(n);
+			}
+			std::transform(first, last, data_, [](const auto& v) { return static_cast<T>(v); });
+			size_ = n;
+		}
+
+		friend bool operator==(const SmallVector& a, const SmallVector& b)
+		{
+			return a.size_ == b.size_ && std::equal(a.begin(), a.end(), b.begin());
+		}
+
+		friend bool operator!=(const SmallVector& a, const SmallVector& b)
+		{
+			return !(a == b);
+		}
+
+	private:
+		//! Inline storage (not initialized until used)
+		T inline_[N > 0 ? N : 1];
+		//! Current storage: inline_ or heap
+		T* data_;
+		size_t size_;
+		size_t capacity_;
+		//! Resource of heap storage
+		MemoryResource* resource_ = nullptr;
+
+		void reallocate(size_t capacity)
+		{
+			MemoryResource* resource = defaultResource();
+			T* p = static_cast<T*>(resource->allocate(capacity * sizeof(T), std::max(settings::alignment, alignof(T))));
+			std::copy(data_, data_ + size_, p);
+			const size_t size = size_;
+			release();
+			data_ = p;
+			size_ = size;
+			capacity_ = capacity;
+			resource_ = resource;
+		}
+
+		/// @brief Free heap storage and return to inline storage, size is kept
+		void release() noexcept
+		{
+			if (data_ != inline_)
+			{
+				resource_->deallocate(data_, capacity_ * sizeof(T), std::max(settings::alignment, alignof(T)));
+				data_ = inline_;
+				capacity_ = N;
+				resource_ = nullptr;
+			}
+		}
+
+		void take(SmallVector& other) noexcept
+		{
+			if (other.data_ != other.inline_)
+			{
+				data_ = other.data_;
+				capacity_ = other.capacity_;
+				resource_ = other.resource_;
+			}
+			else
+			{
+				std::copy(other.inline_, other.inline_ + other.size_, inline_);
+			}
+			size_ = other.size_;
+			other.data_ = other.inline_;
+			other.capacity_ = N;
+			other.size_ = 0;
+			other.resource_ = nullptr;
+		}
+	};
+}
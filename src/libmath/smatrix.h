@@ -0,0 +1,663 @@
+#pragma once
+
+#include <libmath/math_exception.h>
+#include <libmath/math_settings.h>
+#include <libmath/boolean.h>
+#include <libmath/matrix.h>
+#include <libmath/blas/small.h>
+
+#include <array>
+#include <iostream>
+#include <iomanip>
+#include <type_traits>
+#include <cmath>
+#include <algorithm>
+#include <initializer_list>
+
+namespace math
+{
+	//! Class SMatrix
+	/* Class representing matrix of type T with compile-time dimensions R*C.
+	 * Elements are stored inline (row by row), so SMatrix never touches the heap.
+	 * Dimensions of operands are checked at compile time.
+	 */
+	template <typename T, size_t R, size_t C>
+	class SMatrix
+	{
+		static_assert(R > 0 && C > 0, "SMatrix: dimensions must be greater than 0");
+
+	private:
+		//! Internal inline storage (row representation)
+		std::array<T, R * C> mvec_{};
+
+	public:
+		/**
+		 * @brief Default constructor
+		 * @return Zero-filled matrix R*C of T
+		 */
+		constexpr SMatrix() = default;
+
+		/**
+		 * @brief Matrix from list initialization (initializer_list)
+		 * @details Initialization from initializer list with check for list
+		 * correctness. Number of rows and columns must match R and C.
+		 * @param listMatrix matrix initializer_list
+		 * @throws math::ExceptionInvalidValue
+		 */
+		template <class T1>
+		constexpr SMatrix(std::initializer_list<std::initializer_list<T1>> listMatrix)
+		{
+			if (listMatrix.size() != R)
+			{
+				throw(math::ExceptionInvalidValue("Incorrect initializer list for construct math::SMatrix: wrong number of rows"));
+			}
+			size_t pos = 0;
+			for (const auto& row : listMatrix)
+			{
+				if (row.size() != C)
+				{
+					throw(math::ExceptionInvalidValue("Incorrect initializer list for construct math::SMatrix: wrong number of columns"));
+				}
+				for (const auto& el : row)
+				{
+					mvec_[pos++] = static_cast<T>(el);
+				}
+			}
+		}
+
+		/**
+		 * @brief Construct from dynamic matrix
+		 * @param M Matrix of size R*C
+		 * @throws math::ExceptionIncorrectMatrix if dimensions of M didn't agree
+		 */
+		explicit SMatrix(const Matrix<T>& M)
+		{
+			if (M.rows() != R || M.cols() != C)
+			{
+				throw(math::ExceptionIncorrectMatrix("SMatrix: dimensions of dynamic matrix didn't agree!"));
+			}
+			for (size_t row = 0; row < R; ++row)
+			{
+				for (size_t col = 0; col < C; ++col)
+				{
+					mvec_[row * C + col] = M(row, col);
+				}
+			}
+		}
+
+		/**
+		 * @brief Convert to dynamic matrix
+		 * @return Row-oriented Matrix R*C of T
+		 */
+		Matrix<T> toMatrix() const
+		{
+			Matrix<T> M(R, C);
+			for (size_t row = 0; row < R; ++row)
+			{
+				for (size_t col = 0; col < C; ++col)
+				{
+					M(row, col) = mvec_[row * C + col];
+				}
+			}
+			return M;
+		}
+
+		/**
+		 * @brief number of rows
+		 */
+		static constexpr size_t rows()
+		{
+			return R;
+		}
+
+		/**
+		 * @brief number of columns
+		 */
+		static constexpr size_t cols()
+		{
+			return C;
+		}
+
+		/**
+		 * @brief total number of elements in matrix
+		 */
+		static constexpr size_t numel()
+		{
+			return R * C;
+		}
+
+		/**
+		 * @brief get reference to element at specified position (i,j)
+		 * @details Indices are checked only if settings::boundsCheck is enabled (debug builds)
+		 * @param row row number (starting from 0)
+		 * @param col column number (starting from 0)
+		 */
+		constexpr T& operator()(size_t row, size_t col)
+		{
+			if constexpr (settings::boundsCheck)
+			{
+				if (row >= R)
+				{
+					throw(ExceptionIndexOutOfBounds("SMatrix<T>::operator(): row index out of bounds!"));
+				}
+				if (col >= C)
+				{
+					throw(ExceptionIndexOutOfBounds("SMatrix<T>::operator(): col index out of bounds!"));
+				}
+			}
+			return mvec_[row * C + col];
+		}
+
+		/**
+		 * @brief const version of operator()
+		 * @param row row number (starting from 0)
+		 * @param col column number (starting from 0)
+		 */
+		constexpr T operator()(size_t row, size_t col) const
+		{
+			if constexpr (settings::boundsCheck)
+			{
+				if (row >= R)
+				{
+					throw(ExceptionIndexOutOfBounds("SMatrix<T>::operator(): row index out of bounds!"));
+				}
+				if (col >= C)
+				{
+					throw(ExceptionIndexOutOfBounds("SMatrix<T>::operator(): col index out of bounds!"));
+				}
+			}
+			return mvec_[row * C + col];
+		}
+
+		/**
+		 * @brief iterators over internal storage (row by row)
+		 */
+		constexpr T* begin()
+		{
+			return mvec_.data();
+		}
+
+		constexpr T* end()
+		{
+			return mvec_.data() + R * C;
+		}
+
+		constexpr const T* begin() const
+		{
+			return mvec_.data();
+		}
+
+		constexpr const T* end() const
+		{
+			return mvec_.data() + R * C;
+		}
+
+		/**
+		* @brief Fill matrix by value val
+		* @param val: Value to fill matrix
+		*/
+		constexpr void fill(T val)
+		{
+			for (auto& el : mvec_)
+			{
+				el = val;
+			}
+		}
+
+		/**
+		 * @brief Print Matrix to std out
+		 */
+		void print(int prec = 5) const
+		{
+			for (size_t row = 0; row < R; ++row)
+			{
+				for (size_t col = 0; col < C; ++col)
+				{
+					std::cout << std::setw(prec + 5) << std::setprecision(prec) << std::left << mvec_[row * C + col];
+				}
+				std::cout << std::endl;
+			}
+		}
+
+		/**
+		 * @brief Get transposed matrix
+		 * @return transposed SMatrix C*R
+		 */
+		constexpr SMatrix<T, C, R> getTr() const
+		{
+			SMatrix<T, C, R> M_T;
+			for (size_t row = 0; row < R; ++row)
+			{
+				for (size_t col = 0; col < C; ++col)
+				{
+					M_T.begin()[col * R + row] = mvec_[row * C + col];
+				}
+			}
+			return M_T;
+		}
+
+		/**
+		 * @brief Change square matrix to transposed
+		 */
+		constexpr void tr()
+		{
+			static_assert(R == C, "SMatrix::tr: in-place transpose requires square matrix");
+			for (size_t row = 0; row < R; ++row)
+			{
+				for (size_t col = row + 1; col < C; ++col)
+				{
+					std::swap(mvec_[row * C + col], mvec_[col * C + row]);
+				}
+			}
+		}
+
+		/**
+		* @brief Matrix p-norm
+		* @see Matrix::pnorm
+		*/
+		T pnorm(const int p) const
+		{
+			T norm = static_cast<T>(0.0);
+			// common norms without std::pow
+			if (p == 1)
+			{
+				for (const auto& el : mvec_)
+				{
+					norm += std::abs(el);
+				}
+				return norm;
+			}
+			if (p == 2)
+			{
+				for (const auto& el : mvec_)
+				{
+					norm += el * el;
+				}
+				return static_cast<T>(std::sqrt(norm));
+			}
+			// T for floating point elements, double for integers
+			typedef decltype(std::pow(T(), T())) pow_type;
+			for (const auto& el : mvec_)
+			{
+				norm += static_cast<T>(std::pow(static_cast<pow_type>(std::abs(el)), static_cast<pow_type>(p)));
+			}
+			return static_cast<T>(std::pow(static_cast<pow_type>(norm), static_cast<pow_type>(1) / static_cast<pow_type>(p)));
+		}
+
+		/**
+		 * @brief Max element of matrix
+		 */
+		T maxElement() const
+		{
+			return *std::max_element(mvec_.begin(), mvec_.end());
+		}
+
+		/**
+		 * @brief Matrix determinant
+		 * @details Closed form (constexpr) for matrices up to 4*4, larger matrices are
+		 * calculated by Gauss elimination with partial pivoting on an inline copy
+		 */
+		constexpr T det() const
+		{
+			static_assert(R == C, "SMatrix::det: matrix must be square");
+			if constexpr (R <= blas::smallMaxSize)
+			{
+				return blas::smallDet<R>(mvec_.data());
+			}
+			else
+			{
+				std::array<T, R * C> a = mvec_;
+				T d = static_cast<T>(1.0);
+				for (size_t k = 0; k < R; ++k)
+				{
+					size_t p = k;
+					for (size_t i = k + 1; i < R; ++i)
+					{
+						if (std::abs(a[i * C + k]) > std::abs(a[p * C + k]))
+						{
+							p = i;
+						}
+					}
+					if (a[p * C + k] == static_cast<T>(0.0))
+					{
+						return static_cast<T>(0.0);
+					}
+					if (p != k)
+					{
+						for (size_t j = 0; j < C; ++j)
+						{
+							std::swap(a[k * C + j], a[p * C + j]);
+						}
+						d = -d;
+					}
+					d *= a[k * C + k];
+					for (size_t i = k + 1; i < R; ++i)
+					{
+						T f = a[i * C + k] / a[k * C + k];
+						for (size_t j = k + 1; j < C; ++j)
+						{
+							a[i * C + j] -= f * a[k * C + j];
+						}
+					}
+				}
+				return d;
+			}
+		}
+
+		/**
+		 * @brief calculate inversed matrix
+		 * @details Closed form (constexpr) for matrices up to 4*4, larger matrices are
+		 * inverted by Gauss-Jordan elimination with partial pivoting on inline storage
+		 * @throws math::ExceptionDegenerateMatrix for singular matrix
+		 */
+		constexpr SMatrix<T, R, C> inverse() const
+		{
+			static_assert(R == C, "SMatrix::inverse: matrix must be square");
+			if constexpr (R <= blas::smallMaxSize)
+			{
+				SMatrix<T, R, C> X;
+				if (blas::smallInverse<R>(mvec_.data(), X.mvec_.data()) == static_cast<T>(0.0))
+				{
+					throw(math::ExceptionDegenerateMatrix("SMatrix::inverse: matrix is singular!"));
+				}
+				return X;
+			}
+			else
+			{
+				std::array<T, R * C> a = mvec_;
+				SMatrix<T, R, C> X;
+				for (size_t i = 0; i < R; ++i)
+				{
+					X.mvec_[i * C + i] = static_cast<T>(1.0);
+				}
+				for (size_t k = 0; k < R; ++k)
+				{
+					size_t p = k;
+					for (size_t i = k + 1; i < R; ++i)
+					{
+						if (std::abs(a[i * C + k]) > std::abs(a[p * C + k]))
+						{
+							p = i;
+						}
+					}
+					if (a[p * C + k] == static_cast<T>(0.0))
+					{
+						throw(math::ExceptionDegenerateMatrix("SMatrix::inverse: matrix is singular!"));
+					}
+					if (p != k)
+					{
+						for (size_t j = 0; j < C; ++j)
+						{
+							std::swap(a[k * C + j], a[p * C + j]);
+							std::swap(X.mvec_[k * C + j], X.mvec_[p * C + j]);
+						}
+					}
+					T inv_pivot = static_cast<T>(1.0) / a[k * C + k];
+					for (size_t j = 0; j < C; ++j)
+					{
+						a[k * C + j] *= inv_pivot;
+						X.mvec_[k * C + j] *= inv_pivot;
+					}
+					for (size_t i = 0; i < R; ++i)
+					{
+						if (i == k)
+						{
+							continue;
+						}
+						T f = a[i * C + k];
+						for (size_t j = 0; j < C; ++j)
+						{
+							a[i * C + j] -= f * a[k * C + j];
+							X.mvec_[i * C + j] -= f * X.mvec_[k * C + j];
+						}
+					}
+				}
+				return X;
+			}
+		}
+
+		/**
+		 * @brief Compare this matrix with another with defined precision
+		 */
+		bool compare(const SMatrix<T, R, C>& M) const
+		{
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				if (!isEqual(mvec_[i], M.mvec_[i]))
+					return false;
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Check equality of the two matrices
+		 */
+		friend constexpr bool operator==(const SMatrix<T, R, C>& A, const SMatrix<T, R, C>& B)
+		{
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				if (A.mvec_[i] != B.mvec_[i])
+					return false;
+			}
+			return true;
+		}
+
+		/**
+		* @brief multiplication of a matrix by a number
+		*/
+		friend constexpr SMatrix<T, R, C> operator*(const SMatrix<T, R, C>& M, T n)
+		{
+			SMatrix<T, R, C> mul_M;
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				mul_M.mvec_[i] = M.mvec_[i] * n;
+			}
+			return mul_M;
+		}
+
+		/**
+		* @brief permutation overload of operator*(const SMatrix&M, T n)
+		*/
+		friend constexpr SMatrix<T, R, C> operator*(T n, const SMatrix<T, R, C>& M)
+		{
+			return M * n;
+		}
+
+		/**
+		* @brief overload operator*= for multiplication by a number
+		*/
+		constexpr SMatrix<T, R, C>& operator*=(T n)
+		{
+			for (auto& el : mvec_)
+			{
+				el *= n;
+			}
+			return *this;
+		}
+
+		/**
+		* @brief overload operator*= for multiplication by a square matrix
+		*/
+		constexpr SMatrix<T, R, C>& operator*=(const SMatrix<T, C, C>& M1)
+		{
+			*this = (*this) * M1;
+			return *this;
+		}
+
+		/**
+		* @brief Addition of a matrix and a number (element by element)
+		*/
+		friend constexpr SMatrix<T, R, C> operator+(const SMatrix<T, R, C>& M, T n)
+		{
+			SMatrix<T, R, C> sum_M;
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				sum_M.mvec_[i] = M.mvec_[i] + n;
+			}
+			return sum_M;
+		}
+
+		/**
+		* @brief permutation overload of operator+(const SMatrix&M, T n)
+		*/
+		friend constexpr SMatrix<T, R, C> operator+(T n, const SMatrix<T, R, C>& M)
+		{
+			return M + n;
+		}
+
+		/**
+		* @brief overload operator+= for addition with number
+		*/
+		constexpr SMatrix<T, R, C>& operator+=(T n)
+		{
+			for (auto& el : mvec_)
+			{
+				el += n;
+			}
+			return *this;
+		}
+
+		/**
+		* @brief Addition of matrices (element by element)
+		*/
+		friend constexpr SMatrix<T, R, C> operator+(const SMatrix<T, R, C>& A, const SMatrix<T, R, C>& B)
+		{
+			SMatrix<T, R, C> S;
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				S.mvec_[i] = A.mvec_[i] + B.mvec_[i];
+			}
+			return S;
+		}
+
+		/**
+		* @brief overload operator+= for sum of matrices
+		*/
+		constexpr SMatrix<T, R, C>& operator+=(const SMatrix<T, R, C>& M1)
+		{
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				mvec_[i] += M1.mvec_[i];
+			}
+			return *this;
+		}
+
+		/**
+		* @brief Subtraction of a matrix and a number (element by element)
+		*/
+		friend constexpr SMatrix<T, R, C> operator-(const SMatrix<T, R, C>& M, T n)
+		{
+			SMatrix<T, R, C> diff_M;
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				diff_M.mvec_[i] = M.mvec_[i] - n;
+			}
+			return diff_M;
+		}
+
+		/**
+		* @brief Subtraction of a number and a matrix (element by element)
+		*/
+		friend constexpr SMatrix<T, R, C> operator-(T n, const SMatrix<T, R, C>& M)
+		{
+			SMatrix<T, R, C> diff_M;
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				diff_M.mvec_[i] = n - M.mvec_[i];
+			}
+			return diff_M;
+		}
+
+		/**
+		* @brief Unary minus (negation of every element)
+		*/
+		constexpr SMatrix<T, R, C> operator-() const
+		{
+			SMatrix<T, R, C> neg_M;
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				neg_M.mvec_[i] = -mvec_[i];
+			}
+			return neg_M;
+		}
+
+		/**
+		* @brief overload operator-= for subtraction with number
+		*/
+		constexpr SMatrix<T, R, C>& operator-=(T n)
+		{
+			for (auto& el : mvec_)
+			{
+				el -= n;
+			}
+			return *this;
+		}
+
+		/**
+		* @brief Subtraction of matrices (element by element)
+		*/
+		friend constexpr SMatrix<T, R, C> operator-(const SMatrix<T, R, C>& A, const SMatrix<T, R, C>& B)
+		{
+			SMatrix<T, R, C> D;
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				D.mvec_[i] = A.mvec_[i] - B.mvec_[i];
+			}
+			return D;
+		}
+
+		/**
+		* @brief overload operator-= for subtraction of matrices
+		*/
+		constexpr SMatrix<T, R, C>& operator-=(const SMatrix<T, R, C>& M1)
+		{
+			for (size_t i = 0; i < R * C; ++i)
+			{
+				mvec_[i] -= M1.mvec_[i];
+			}
+			return *this;
+		}
+
+		template <typename T1, size_t R1, size_t C1>
+		friend class SMatrix;
+	}; // class SMatrix
+
+	/**
+	* @brief Multiplication of a matrix by a matrix
+	* @details Inner dimensions are checked at compile time
+	* @return Multiplication of matrices, SMatrix R*C
+	*/
+	template <typename T, size_t R, size_t K, size_t C>
+	constexpr SMatrix<T, R, C> operator*(const SMatrix<T, R, K>& A, const SMatrix<T, K, C>& B)
+	{
+		SMatrix<T, R, C> P;
+		const T* a = A.begin();
+		const T* b = B.begin();
+		T* p = P.begin();
+		for (size_t row = 0; row < R; ++row)
+		{
+			for (size_t k = 0; k < K; ++k)
+			{
+				const T a_rk = a[row * K + k];
+				for (size_t col = 0; col < C; ++col)
+				{
+					p[row * C + col] += a_rk * b[k * C + col];
+				}
+			}
+		}
+		return P;
+	}
+
+	/// @brief Column-vector of 3 elements (coordinates, angles)
+	template <typename T>
+	using Vector3 = SMatrix<T, 3, 1>;
+
+	/// @brief 3x3 matrix (rotations, limb Jacobians)
+	template <typename T>
+	using Matrix3 = SMatrix<T, 3, 3>;
+
+	/// @brief 4x4 matrix (homogeneous transforms)
+	template <typename T>
+	using Matrix4 = SMatrix<T, 4, 4>;
+
+} // namespace math
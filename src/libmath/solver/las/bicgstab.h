@@ -1,17 +1,26 @@
 #pragma once
 
 #include <libmath/solver/las/lassolver.h>
+#include <libmath/solver/las/preconditioner.h>
+#include <libmath/blas.h>
+#include <libmath/linear_operator.h>
 #include <libmath/math_settings.h>
 #include <libmath/math_exception.h>
 #include <libmath/boolean.h>
 #include <vector>
 #include <string>
-#include <chrono>
+#include <algorithm>
 
 namespace math
 {
 	/**
 	* @brief Class for solving LAS with biconjugate gradient stabilized method
+	* @details Residual is updated by recurrence, true residual @f$ \mathbf{b} - \mathbf{A} \mathbf{x} @f$
+	* is computed every LASsetup::residualCheckInterval iterations and to confirm convergence, so iteration
+	* costs two products with A (and two applications of preconditioner, see setPreconditioner()).
+	* Work vectors are kept between calls of solve(): solving of systems of the same size doesn't allocate memory.
+	* @see H.A. van der Vorst, Bi-CGSTAB: a fast and smoothly converging variant of Bi-CG for the solution
+	* of nonsymmetric linear systems, SIAM J. Sci. Stat. Comput. 13(2), 1992
 	*/
 	template <typename T>
 	class BicGStab :
@@ -19,7 +28,7 @@ namespace math
 	{
 	public:
 		/// @brief Default constructor
-		BicGStab() 
+		BicGStab()
 		{
 			this->method_ = "BicGStab";
 		};
@@ -37,31 +46,83 @@ namespace math
 			this->currentSetup_ = setup;
 		}
 
+		/**
+		* @brief Set preconditioner
+		* @param M: Preconditioner, which is built for matrix of solved systems (isn't owned by solver
+		* and must outlive it), nullptr - without preconditioning
+		* @param side: Left or right preconditioning. Right one keeps residual of the original system,
+		* so tolerance has the same meaning as without preconditioning
+		*/
+		void setPreconditioner(const Preconditioner<T>* M, PreconditionerSide side = PreconditionerSide::Right)
+		{
+			M_ = M;
+			side_ = side;
+		}
+
+		/// @brief Number of iterations of the last solve
+		size_t iterations() const
+		{
+			return iterations_;
+		}
+
+		/**
+		* @brief 2-norm of residual of the last solve: true residual for tolerance stopping criteria,
+		* estimate by recurrence for iterations stopping criteria
+		*/
+		T residual() const
+		{
+			return residual_;
+		}
+
 		/**
 		* @brief LASsolver::solve
 		*/
 		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) override
+		{
+			solve(DenseOperator<T>(A), b, x);
+		}
+
+		/**
+		* @brief LASsolver::solve for matrix given as linear operator (e.g. SparseMatrix)
+		* @details Breakdowns (rho = 0, (r1, A * p) = 0, omega = 0) restart iterations from true residual.
+		* @throws math::ExceptionIncorrectMatrix if (r1, A * p) = 0 right after restart (e.g. skew-symmetric A)
+		*/
+		virtual void solve(const LinearOperator<T>& A, const Matrix<T>& b, Matrix<T>& x) override
 		{
 			// check inputs
 			this->checkInputs(A, b, x);
+			if (M_ != nullptr && M_->rows() != A.rows())
+			{
+				throw(ExceptionIncorrectMatrix(this->method_ + ": dimensions of preconditioner and matrix A didn't agree!"));
+			}
 
-			Matrix<T> x_l = x;
-
-			Matrix<T> r = b - A * x;
-			Matrix<T> r1 = r;
-
-			Matrix<T> p(b.rows(), 1);
-			p.fill(static_cast<T>(0.0));
+			const size_t n = b.rows();
+			reserve(n);
 
-			Matrix<T> v(b.rows(), 1);
-			v.fill(static_cast<T>(0.0));
+			const bool byTolerance = this->currentSetup_.criteria == LASStoppingCriteriaType::tolerance;
+			const T tolerance = static_cast<T>(this->currentSetup_.targetTolerance);
+			const size_t interval = this->currentSetup_.residualCheckInterval;
+			const bool right = M_ != nullptr && side_ == PreconditionerSide::Right;
 
-			Matrix<T> h(b.rows(), 1);
-			h.fill(static_cast<T>(0.0));
+			// search directions of x: M^-1 * p and M^-1 * s for right preconditioning
+			T* xp = right ? phat_.data() : p_.data();
+			T* xs = right ? shat_.data() : s_.data();
 
-			Matrix<T> s(b.rows(), 1);
+			T* xd = x.data();
+			T* r = r_.data();
+			T* p = p_.data();
+			T* v = v_.data();
+			T* s = s_.data();
+			T* t = t_.data();
 
-			Matrix<T> t(b.rows(), 1);
+			iterations_ = 0;
+			residual_ = trueResidual(A, b, x);
+			// ratio of norms of recurrence and true residuals (differs from 1 for left preconditioning)
+			T scale = residualScale();
+			if (byTolerance && residual_ <= tolerance)
+			{
+				return;
+			}
 
 			T rho = static_cast<T>(1.0);
 			T rho_l = static_cast<T>(1.0);
@@ -70,61 +131,214 @@ namespace math
 
 			T betta = static_cast<T>(0.0);
 
-			T tmp1 = static_cast<T>(0.0);
-			T tmp2 = static_cast<T>(0.0);
-
-			std::vector<T> tmp_E(b.rows(), static_cast<T>(1.0));
-			T E = static_cast<T>(1.0);
-			T e = static_cast<T>(math::settings::CurrentSettings.targetTolerance);
-
-			size_t iter_cnt = 0;
+			bool restart = true;
 
 			// stopping criteria
 			bool stop = 0;
 
-			//auto start = std::chrono::steady_clock::now();
 			while (!stop)
 			{
+				const bool restarted = restart;
+				if (restart)
+				{
+					// shadow residual r1 = r, p = v = 0
+					std::copy(r, r + n, r1_.data());
+					std::fill(p, p + n, static_cast<T>(0.0));
+					std::fill(v, v + n, static_cast<T>(0.0));
+					rho = alpha = omega = static_cast<T>(1.0);
+					restart = false;
+				}
+
 				rho_l = rho;
-				rho = (r1.getTr() * r)(0, 0);
+				rho = dot(r1_, r_);
+				if (rho == static_cast<T>(0.0))
+				{
+					// breakdown: r is orthogonal to shadow residual, iterations are restarted from true residual
+					residual_ = trueResidual(A, b, x);
+					scale = residualScale();
+					restart = true;
+					if (residual_ == static_cast<T>(0.0) || (byTolerance && residual_ <= tolerance))
+					{
+						break;
+					}
+					continue;
+				}
 				betta = (rho / rho_l) * (alpha / omega);
-				p = r + betta * (p - omega * v);
-				v = A * p;
-				alpha = rho / (r1.getTr() * v)(0, 0);
-				h = x + alpha * p;
-				s = r - alpha * v;
-				t = A * s;
-				omega = (t.getTr() * s)(0, 0) / (t.getTr() * t)(0, 0);
-				x = h + omega * s;
-				r = s - omega * t;
-
-				++iter_cnt;
-
-				if (this->currentSetup_.criteria == LASStoppingCriteriaType::tolerance)
+				for (size_t i = 0; i < n; ++i)
+				{
+					p[i] = r[i] + betta * (p[i] - omega * v[i]);
+				}
+				product(A, p_, phat_, v_);
+				const T r1v = dot(r1_, v_);
+				if (r1v == static_cast<T>(0.0))
 				{
-					E = (b - A * x).pnorm(2);
-					if (E <= static_cast<T>(this->currentSetup_.targetTolerance))
+					// breakdown: A * p is orthogonal to shadow residual
+					if (restarted)
 					{
-						stop = 1;
+						// the same breakdown repeats after restart
+						throw(math::ExceptionIncorrectMatrix(this->method_ + ": breakdown, (r1, A * p) = 0 after restart!"));
 					}
-					else
+					// iterations are restarted from true residual
+					residual_ = trueResidual(A, b, x);
+					scale = residualScale();
+					restart = true;
+					if (residual_ == static_cast<T>(0.0) || (byTolerance && residual_ <= tolerance))
 					{
-						if (iter_cnt > this->currentSetup_.abort_iter)
-						{
-							throw(math::ExceptionTooManyIterations("BicGStab.solve: Solver didn't converge with choosen tolerance. Too many iterations!"));
-						}
+						break;
+					}
+					continue;
+				}
+				alpha = rho / r1v;
+				for (size_t i = 0; i < n; ++i)
+				{
+					s[i] = r[i] - alpha * v[i];
+				}
+
+				++iterations_;
+
+				// s is residual of x + alpha * p: the second half of iteration isn't needed
+				if (byTolerance && nrm2(s_) <= tolerance * scale)
+				{
+					blas::axpy(n, alpha, xp, size_t(1), xd, size_t(1));
+					residual_ = trueResidual(A, b, x);
+					scale = residualScale();
+					if (residual_ <= tolerance)
+					{
+						break;
+					}
+					restart = true;
+					checkAbort();
+					continue;
+				}
+
+				product(A, s_, shat_, t_);
+				const T tt = dot(t_, t_);
+				omega = tt == static_cast<T>(0.0) ? static_cast<T>(0.0) : dot(t_, s_) / tt;
+				for (size_t i = 0; i < n; ++i)
+				{
+					xd[i] += alpha * xp[i] + omega * xs[i];
+					r[i] = s[i] - omega * t[i];
+				}
+
+				// omega = 0: stagnation, iterations are restarted from true residual
+				restart = omega == static_cast<T>(0.0);
+				const bool check = restart || (interval > 0 && iterations_ % interval == 0);
+				residual_ = check ? trueResidual(A, b, x) : nrm2(r_) / scale;
+				if (check)
+				{
+					scale = residualScale();
+				}
+
+				if (byTolerance)
+				{
+					if (residual_ <= tolerance && !check)
+					{
+						// convergence by recurrence residual is confirmed by true one
+						residual_ = trueResidual(A, b, x);
+						scale = residualScale();
+					}
+					stop = residual_ <= tolerance;
+					if (!stop)
+					{
+						checkAbort();
 					}
 				}
 				if (this->currentSetup_.criteria == LASStoppingCriteriaType::iterations)
 				{
-					if (iter_cnt > this->currentSetup_.max_iter)
+					if (iterations_ > this->currentSetup_.max_iter)
 					{
 						stop = 1;
 					}
 				}
 			}
-			//auto end = std::chrono::steady_clock::now();
-			//std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
+		}
+
+		/**
+		* @brief Allocate work vectors for systems of dimension n
+		* @details Is called by solve(), but may be called beforehand to avoid allocations in control loop
+		*/
+		void reserve(size_t n)
+		{
+			if (r_.rows() == n)
+			{
+				return;
+			}
+			for (Matrix<T>* w : { &r_, &r1_, &p_, &v_, &s_, &t_, &phat_, &shat_, &res_ })
+			{
+				*w = Matrix<T>(n, 1);
+			}
+		}
+
+	private:
+		/// @brief Preconditioner (not owned)
+		const Preconditioner<T>* M_ = nullptr;
+		PreconditionerSide side_ = PreconditionerSide::Right;
+
+		/// @brief Work vectors
+		Matrix<T> r_, r1_, p_, v_, s_, t_, phat_, shat_, res_;
+
+		size_t iterations_ = 0;
+		T residual_ = static_cast<T>(0.0);
+
+		/**
+		* @brief y = A * M^-1 * x (right), M^-1 * A * x (left) or A * x (without preconditioner)
+		* @param z: M^-1 * x for right preconditioning
+		*/
+		void product(const LinearOperator<T>& A, const Matrix<T>& x, Matrix<T>& z, Matrix<T>& y)
+		{
+			if (M_ == nullptr)
+			{
+				A.apply(static_cast<T>(1.0), x, static_cast<T>(0.0), y);
+			}
+			else if (side_ == PreconditionerSide::Right)
+			{
+				M_->apply(x, z);
+				A.apply(static_cast<T>(1.0), z, static_cast<T>(0.0), y);
+			}
+			else
+			{
+				A.apply(static_cast<T>(1.0), x, static_cast<T>(0.0), res_);
+				M_->apply(res_, y);
+			}
+		}
+
+		/**
+		* @brief res = b - A * x, recurrence residual r is replaced by res (M^-1 * res for left preconditioning)
+		* @return 2-norm of res
+		*/
+		T trueResidual(const LinearOperator<T>& A, const Matrix<T>& b, const Matrix<T>& x)
+		{
+			const size_t n = b.rows();
+			std::copy(b.data(), b.data() + n, res_.data());
+			A.apply(static_cast<T>(-1.0), x, static_cast<T>(1.0), res_);
+			if (M_ != nullptr && side_ == PreconditionerSide::Left)
+			{
+				M_->apply(res_, r_);
+			}
+			else
+			{
+				std::copy(res_.data(), res_.data() + n, r_.data());
+			}
+			return nrm2(res_);
+		}
+
+		/// @brief Ratio of norms of recurrence and true residuals after trueResidual()
+		T residualScale() const
+		{
+			if (M_ == nullptr || side_ == PreconditionerSide::Right || residual_ == static_cast<T>(0.0))
+			{
+				return static_cast<T>(1.0);
+			}
+			const T scale = nrm2(r_) / residual_;
+			return scale > static_cast<T>(0.0) ? scale : static_cast<T>(1.0);
+		}
+
+		void checkAbort() const
+		{
+			if (iterations_ > this->currentSetup_.abort_iter)
+			{
+				throw(math::ExceptionTooManyIterations("BicGStab.solve: Solver didn't converge with choosen tolerance. Too many iterations!"));
+			}
 		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <libmath/solver/las/lassolver.h>
+#include <libmath/solver/las/preconditioner.h>
+#include <libmath/blas.h>
+#include <libmath/linear_operator.h>
+#include <libmath/math_settings.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+namespace math
+{
+	/**
+	* @brief Class for solving LAS with symmetric positive-definite matrix by conjugate gradient method
+	* @details Iteration costs one product with A (half of BicGStab) and one application of preconditioner,
+	* which must be symmetric positive-definite too (JacobiPreconditioner, BlockJacobiPreconditioner of SPD
+	* matrix, IC0Preconditioner). Residual is updated by recurrence, true residual
+	* @f$ \mathbf{b} - \mathbf{A} \mathbf{x} @f$ is computed every LASsetup::residualCheckInterval iterations
+	* and to confirm convergence. Work vectors are kept between calls of solve().
+	* @see M.R. Hestenes, E. Stiefel, Methods of conjugate gradients for solving linear systems,
+	* J. Res. Nat. Bur. Standards 49(6), 1952
+	*/
+	template <typename T>
+	class CG :
+		public LASsolver<T>
+	{
+	public:
+		/// @brief Default constructor
+		CG()
+		{
+			this->method_ = "CG";
+		};
+
+		/**
+		* @brief CG solver constructor.
+		* @param setup: Solver settings
+		*/
+		CG(const LASsetup& setup)
+		{
+			this->method_ = "CG";
+
+			this->checkInputs(setup);
+
+			this->currentSetup_ = setup;
+		}
+
+		/**
+		* @brief Set preconditioner
+		* @param M: Symmetric positive-definite preconditioner, which is built for matrix of solved systems
+		* (isn't owned by solver and must outlive it), nullptr - without preconditioning
+		*/
+		void setPreconditioner(const Preconditioner<T>* M)
+		{
+			M_ = M;
+		}
+
+		/// @brief Number of iterations of the last solve
+		size_t iterations() const
+		{
+			return iterations_;
+		}
+
+		/**
+		* @brief 2-norm of residual of the last solve: true residual for tolerance stopping criteria,
+		* estimate by recurrence for iterations stopping criteria
+		*/
+		T residual() const
+		{
+			return residual_;
+		}
+
+		/**
+		* @brief LASsolver::solve
+		*/
+		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) override
+		{
+			solve(DenseOperator<T>(A), b, x);
+		}
+
+		/**
+		* @brief LASsolver::solve for matrix given as linear operator (e.g. SparseMatrix)
+		* @throws math::ExceptionIncorrectMatrix if A isn't positive definite
+		*/
+		virtual void solve(const LinearOperator<T>& A, const Matrix<T>& b, Matrix<T>& x) override
+		{
+			// check inputs
+			this->checkInputs(A, b, x);
+			if (M_ != nullptr && M_->rows() != A.rows())
+			{
+				throw(ExceptionIncorrectMatrix(this->method_ + ": dimensions of preconditioner and matrix A didn't agree!"));
+			}
+
+			const size_t n = b.rows();
+			reserve(n);
+
+			const bool byTolerance = this->currentSetup_.criteria == LASStoppingCriteriaType::tolerance;
+			const T tolerance = static_cast<T>(this->currentSetup_.targetTolerance);
+			const size_t interval = this->currentSetup_.residualCheckInterval;
+
+			T* xd = x.data();
+			T* r = r_.data();
+			T* p = p_.data();
+			T* q = q_.data();
+			const T* z = M_ != nullptr ? z_.data() : r_.data();
+
+			iterations_ = 0;
+			residual_ = trueResidual(A, b, x);
+			if (byTolerance && residual_ <= tolerance)
+			{
+				return;
+			}
+
+			// p = z = M^-1 * r
+			precondition();
+			std::copy(z, z + n, p);
+			T rz = dot(r_, M_ != nullptr ? z_ : r_);
+
+			// stopping criteria
+			bool stop = 0;
+
+			while (!stop)
+			{
+				A.apply(static_cast<T>(1.0), p_, static_cast<T>(0.0), q_);
+				const T pq = dot(p_, q_);
+				if (!(pq > static_cast<T>(0.0)))
+				{
+					if (rz == static_cast<T>(0.0))
+					{
+						// r = 0: exact solution
+						residual_ = trueResidual(A, b, x);
+						break;
+					}
+					throw(math::ExceptionIncorrectMatrix(this->method_ + ": matrix A must be positive definite!"));
+				}
+				const T alpha = rz / pq;
+				for (size_t i = 0; i < n; ++i)
+				{
+					xd[i] += alpha * p[i];
+					r[i] -= alpha * q[i];
+				}
+
+				++iterations_;
+
+				const bool check = interval > 0 && iterations_ % interval == 0;
+				residual_ = check ? trueResidual(A, b, x) : nrm2(r_);
+
+				if (byTolerance)
+				{
+					if (residual_ <= tolerance && !check)
+					{
+						// convergence by recurrence residual is confirmed by true one
+						residual_ = trueResidual(A, b, x);
+					}
+					stop = residual_ <= tolerance;
+					if (!stop && iterations_ > this->currentSetup_.abort_iter)
+					{
+						throw(math::ExceptionTooManyIterations("CG.solve: Solver didn't converge with choosen tolerance. Too many iterations!"));
+					}
+				}
+				if (this->currentSetup_.criteria == LASStoppingCriteriaType::iterations)
+				{
+					if (iterations_ > this->currentSetup_.max_iter)
+					{
+						stop = 1;
+					}
+				}
+
+				if (!stop)
+				{
+					precondition();
+					const T rz_l = rz;
+					rz = dot(r_, M_ != nullptr ? z_ : r_);
+					const T betta = rz / rz_l;
+					for (size_t i = 0; i < n; ++i)
+					{
+						p[i] = z[i] + betta * p[i];
+					}
+				}
+			}
+		}
+
+		/**
+		* @brief Allocate work vectors for systems of dimension n
+		* @details Is called by solve(), but may be called beforehand to avoid allocations in control loop
+		*/
+		void reserve(size_t n)
+		{
+			if (r_.rows() == n)
+			{
+				return;
+			}
+			for (Matrix<T>* w : { &r_, &z_, &p_, &q_ })
+			{
+				*w = Matrix<T>(n, 1);
+			}
+		}
+
+	private:
+		/// @brief Preconditioner (not owned)
+		const Preconditioner<T>* M_ = nullptr;
+
+		/// @brief Work vectors
+		Matrix<T> r_, z_, p_, q_;
+
+		size_t iterations_ = 0;
+		T residual_ = static_cast<T>(0.0);
+
+		/// @brief z = M^-1 * r
+		void precondition()
+		{
+			if (M_ != nullptr)
+			{
+				M_->apply(r_, z_);
+			}
+		}
+
+		/**
+		* @brief Recurrence residual r is replaced by b - A * x
+		* @return 2-norm of residual
+		*/
+		T trueResidual(const LinearOperator<T>& A, const Matrix<T>& b, const Matrix<T>& x)
+		{
+			std::copy(b.data(), b.data() + b.rows(), r_.data());
+			A.apply(static_cast<T>(-1.0), x, static_cast<T>(1.0), r_);
+			return nrm2(r_);
+		}
+	};
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <libmath/solver/las/lassolver.h>
+#include <libmath/matrix.h>
+#include <libmath/cholesky.h>
+
+#include <vector>
+
+namespace math
+{
+	/**
+	* @brief Class for solving LAS with symmetric positive-definite matrix by Cholesky factorization @f$ \mathbf{A} = \mathbf{L} \mathbf{L}^T @f$
+	* @details Suits for normal equations and damped least squares @f$ (\mathbf{J}^T \mathbf{J} + \lambda \mathbf{E}) \mathbf{x} = \mathbf{J}^T \mathbf{r} @f$
+	* and costs half of Kholetsky (LU). Only lower triangle of A is used and stored.
+	* Factorization is kept between calls of solve(): A is factorized again only if its lower triangle
+	* differs from matrix of the previous call.
+	*/
+	template <typename T>
+	class Cholesky :
+		public LASsolver<T>
+	{
+	public:
+		using LASsolver<T>::solve;
+
+		Cholesky()
+		{
+			this->method_ = "Cholesky";
+		}
+
+		/// @brief LASsolver::solve
+		/// @throws math::ExceptionIncorrectMatrix for non-symmetric or not positive-definite matrix
+		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) override
+		{
+			// check inputs
+			this->checkInputs(A, b, x);
+
+			if (!llt_.factorized() || !detail::sameLower(A, A_))
+			{
+				if (!detail::isSymmetric(A))
+				{
+					throw(math::ExceptionIncorrectMatrix(this->method_ + ": matrix A must be symmetric!"));
+				}
+				detail::packLower(A, A_);
+				llt_.factorize(A);
+			}
+			if (!llt_.positiveDefinite())
+			{
+				throw(math::ExceptionIncorrectMatrix(this->method_ + ": matrix A must be positive definite!"));
+			}
+			x = b;
+			llt_.solveInPlace(x);
+		}
+
+		/// @brief Solve LAS with matrix in packed storage, symmetry check and conversion aren't needed
+		/// @throws math::ExceptionIncorrectMatrix for not positive-definite matrix
+		void solve(const SymmetricMatrix<T>& A, const Matrix<T>& b, Matrix<T>& x)
+		{
+			// check inputs
+			this->checkInputs(A, b, x);
+
+			if (!llt_.factorized() || A.packed() != A_)
+			{
+				A_ = A.packed();
+				llt_.factorize(A);
+			}
+			if (!llt_.positiveDefinite())
+			{
+				throw(math::ExceptionIncorrectMatrix(this->method_ + ": matrix A must be positive definite!"));
+			}
+			x = b;
+			llt_.solveInPlace(x);
+		}
+
+		/// @brief Current factorization
+		const CholeskyFactorization<T>& factorization() const
+		{
+			return llt_;
+		}
+
+	private:
+		/// @brief Lower triangle of matrix of the last factorization
+		std::vector<T> A_;
+		CholeskyFactorization<T> llt_;
+	};
+}
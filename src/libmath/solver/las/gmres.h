@@ -0,0 +1,389 @@
+#pragma once
+
+#include <libmath/solver/las/lassolver.h>
+#include <libmath/solver/las/preconditioner.h>
+#include <libmath/blas.h>
+#include <libmath/linear_operator.h>
+#include <libmath/math_settings.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+namespace math
+{
+	/**
+	* @brief Orthogonalization of Krylov basis in GMRES
+	*	- MGS: modified Gram-Schmidt, dot products are made one after another
+	*	- CGS2: classical Gram-Schmidt with reorthogonalization: twice the work of MGS, but dot products of
+	* one pass are independent (can be vectorized or parallelized), orthogonality is kept to rounding level
+	*/
+	enum class GMRESOrthogonalization
+	{
+		MGS = 0,
+		CGS2
+	};
+
+	/**
+	* @brief Class for solving LAS with restarted generalized minimal residual method GMRES(m)
+	* @details Residual is minimized over Krylov subspace of dimension m (restart length), after that
+	* the method restarts from the current solution. Unlike BicGStab residual decreases monotonically,
+	* so GMRES suits for non-symmetric systems, where BicGStab stagnates. Iteration costs one product
+	* with A and orthogonalization against up to m vectors, memory is (m + 1) vectors.
+	* Residual of iterations is given by Givens rotations of Hessenberg matrix without products with A,
+	* true residual @f$ \mathbf{b} - \mathbf{A} \mathbf{x} @f$ is computed on every restart
+	* (LASsetup::residualCheckInterval isn't used). Work vectors are kept between calls of solve().
+	* @see Y. Saad, M.H. Schultz, GMRES: a generalized minimal residual algorithm for solving nonsymmetric
+	* linear systems, SIAM J. Sci. Stat. Comput. 7(3), 1986
+	*/
+	template <typename T>
+	class GMRES :
+		public LASsolver<T>
+	{
+	public:
+		/**
+		* @brief GMRES solver constructor.
+		* @param restart: Restart length m (dimension of Krylov subspace)
+		* @param orthogonalization: Orthogonalization of Krylov basis
+		*/
+		explicit GMRES(size_t restart = 30, GMRESOrthogonalization orthogonalization = GMRESOrthogonalization::MGS)
+		{
+			this->method_ = "GMRES";
+			setRestart(restart);
+			orth_ = orthogonalization;
+		};
+
+		/**
+		* @brief GMRES solver constructor.
+		* @param setup: Solver settings
+		* @param restart: Restart length m (dimension of Krylov subspace)
+		* @param orthogonalization: Orthogonalization of Krylov basis
+		*/
+		GMRES(const LASsetup& setup, size_t restart = 30, GMRESOrthogonalization orthogonalization = GMRESOrthogonalization::MGS)
+			: GMRES(restart, orthogonalization)
+		{
+			this->checkInputs(setup);
+
+			this->currentSetup_ = setup;
+		}
+
+		/**
+		* @brief Set restart length m
+		* @throws math::ExceptionInvalidValue for m = 0
+		*/
+		void setRestart(size_t restart)
+		{
+			if (restart == 0)
+			{
+				throw(math::ExceptionInvalidValue(this->method_ + ": restart length must be positive!"));
+			}
+			m_ = restart;
+		}
+
+		/// @brief Restart length m
+		size_t restart() const
+		{
+			return m_;
+		}
+
+		/// @brief Set orthogonalization of Krylov basis
+		void setOrthogonalization(GMRESOrthogonalization orthogonalization)
+		{
+			orth_ = orthogonalization;
+		}
+
+		/**
+		* @brief Set preconditioner
+		* @param M: Preconditioner, which is built for matrix of solved systems (isn't owned by solver
+		* and must outlive it), nullptr - without preconditioning
+		* @param side: Left or right preconditioning. Right one minimizes residual of the original system
+		*/
+		void setPreconditioner(const Preconditioner<T>* M, PreconditionerSide side = PreconditionerSide::Right)
+		{
+			M_ = M;
+			side_ = side;
+		}
+
+		/// @brief Number of iterations (products with A) of the last solve
+		size_t iterations() const
+		{
+			return iterations_;
+		}
+
+		/**
+		* @brief 2-norm of residual of the last solve: true residual for tolerance stopping criteria,
+		* estimate by Givens rotations for iterations stopping criteria
+		*/
+		T residual() const
+		{
+			return residual_;
+		}
+
+		/**
+		* @brief LASsolver::solve
+		*/
+		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) override
+		{
+			solve(DenseOperator<T>(A), b, x);
+		}
+
+		/**
+		* @brief LASsolver::solve for matrix given as linear operator (e.g. SparseMatrix)
+		*/
+		virtual void solve(const LinearOperator<T>& A, const Matrix<T>& b, Matrix<T>& x) override
+		{
+			// check inputs
+			this->checkInputs(A, b, x);
+			if (M_ != nullptr && M_->rows() != A.rows())
+			{
+				throw(ExceptionIncorrectMatrix(this->method_ + ": dimensions of preconditioner and matrix A didn't agree!"));
+			}
+
+			const size_t n = b.rows();
+			reserve(n);
+
+			const bool byTolerance = this->currentSetup_.criteria == LASStoppingCriteriaType::tolerance;
+			const T tolerance = static_cast<T>(this->currentSetup_.targetTolerance);
+			const size_t ldh = m_ + 1;
+			T* h = h_.data();
+
+			iterations_ = 0;
+
+			// stopping criteria
+			bool stop = 0;
+
+			while (!stop)
+			{
+				// restart: v0 = r / beta, r = b - A * x (M^-1 * (b - A * x) for left preconditioning)
+				residual_ = trueResidual(A, b, x);
+				if (byTolerance && residual_ <= tolerance)
+				{
+					break;
+				}
+				if (iterations_ > 0)
+				{
+					checkStop();
+				}
+				const T beta = nrm2(v_[0]);
+				if (beta == static_cast<T>(0.0))
+				{
+					break;
+				}
+				// ratio of norms of minimized and true residuals (differs from 1 for left preconditioning)
+				const T scale = beta / residual_;
+				scal(static_cast<T>(1.0) / beta, v_[0]);
+				std::fill(g_.begin(), g_.end(), static_cast<T>(0.0));
+				g_[0] = beta;
+
+				size_t k = 0;
+				while (k < m_)
+				{
+					// w = A * v_k (A * M^-1 * v_k, M^-1 * A * v_k)
+					Matrix<T>& w = v_[k + 1];
+					product(A, v_[k], w);
+					T* hk = h + k * ldh;
+					orthogonalize(k + 1, w, hk);
+					hk[k + 1] = nrm2(w);
+					if (hk[k + 1] != static_cast<T>(0.0))
+					{
+						scal(static_cast<T>(1.0) / hk[k + 1], w);
+					}
+
+					// previous rotations, new rotation eliminates h(k+1,k)
+					for (size_t i = 0; i < k; ++i)
+					{
+						const T t = c_[i] * hk[i] + s_[i] * hk[i + 1];
+						hk[i + 1] = c_[i] * hk[i + 1] - s_[i] * hk[i];
+						hk[i] = t;
+					}
+					const T rho = std::hypot(hk[k], hk[k + 1]);
+					c_[k] = rho == static_cast<T>(0.0) ? static_cast<T>(1.0) : hk[k] / rho;
+					s_[k] = rho == static_cast<T>(0.0) ? static_cast<T>(0.0) : hk[k + 1] / rho;
+					hk[k] = rho;
+					hk[k + 1] = static_cast<T>(0.0);
+					g_[k + 1] = -s_[k] * g_[k];
+					g_[k] = c_[k] * g_[k];
+
+					++k;
+					++iterations_;
+
+					residual_ = std::abs(g_[k]) / scale;
+					if ((byTolerance && residual_ <= tolerance) || s_[k - 1] == static_cast<T>(0.0))
+					{
+						// convergence (confirmed by true residual on restart) or breakdown: subspace is invariant
+						break;
+					}
+					if (this->currentSetup_.criteria == LASStoppingCriteriaType::iterations && iterations_ > this->currentSetup_.max_iter)
+					{
+						stop = 1;
+						break;
+					}
+				}
+
+				update(k, x);
+
+				if (stop)
+				{
+					break;
+				}
+			}
+		}
+
+		/**
+		* @brief Allocate work vectors for systems of dimension n
+		* @details Is called by solve(), but may be called beforehand to avoid allocations in control loop
+		*/
+		void reserve(size_t n)
+		{
+			if (v_.size() == m_ + 1 && v_[0].rows() == n)
+			{
+				return;
+			}
+			v_.assign(m_ + 1, Matrix<T>(n, 1));
+			u_ = Matrix<T>(n, 1);
+			z_ = Matrix<T>(n, 1);
+			h_.assign((m_ + 1) * m_, static_cast<T>(0.0));
+			c_.assign(m_, static_cast<T>(0.0));
+			s_.assign(m_, static_cast<T>(0.0));
+			g_.assign(m_ + 1, static_cast<T>(0.0));
+			proj_.assign(m_, static_cast<T>(0.0));
+		}
+
+	private:
+		/// @brief Restart length
+		size_t m_ = 30;
+		GMRESOrthogonalization orth_ = GMRESOrthogonalization::MGS;
+
+		/// @brief Preconditioner (not owned)
+		const Preconditioner<T>* M_ = nullptr;
+		PreconditionerSide side_ = PreconditionerSide::Right;
+
+		/// @brief Krylov basis
+		std::vector<Matrix<T>> v_;
+		/// @brief Work vectors
+		Matrix<T> u_, z_;
+		/// @brief Hessenberg matrix (m+1)*m by columns, reduced to triangular by Givens rotations
+		std::vector<T> h_;
+		/// @brief Givens rotations
+		std::vector<T> c_, s_;
+		/// @brief Rotated right-hand side of least squares problem
+		std::vector<T> g_;
+		/// @brief Projections of pass of CGS2
+		std::vector<T> proj_;
+
+		size_t iterations_ = 0;
+		T residual_ = static_cast<T>(0.0);
+
+		void checkStop() const
+		{
+			if (this->currentSetup_.criteria == LASStoppingCriteriaType::tolerance && iterations_ > this->currentSetup_.abort_iter)
+			{
+				throw(math::ExceptionTooManyIterations("GMRES.solve: Solver didn't converge with choosen tolerance. Too many iterations!"));
+			}
+		}
+
+		/**
+		* @brief y = A * M^-1 * x (right), M^-1 * A * x (left) or A * x (without preconditioner)
+		*/
+		void product(const LinearOperator<T>& A, const Matrix<T>& x, Matrix<T>& y)
+		{
+			if (M_ == nullptr)
+			{
+				A.apply(static_cast<T>(1.0), x, static_cast<T>(0.0), y);
+			}
+			else if (side_ == PreconditionerSide::Right)
+			{
+				M_->apply(x, z_);
+				A.apply(static_cast<T>(1.0), z_, static_cast<T>(0.0), y);
+			}
+			else
+			{
+				A.apply(static_cast<T>(1.0), x, static_cast<T>(0.0), z_);
+				M_->apply(z_, y);
+			}
+		}
+
+		/**
+		* @brief w = w - sum h_i * v_i, i < k, h = coefficients of projections
+		*/
+		void orthogonalize(size_t k, Matrix<T>& w, T* h)
+		{
+			if (orth_ == GMRESOrthogonalization::MGS)
+			{
+				for (size_t i = 0; i < k; ++i)
+				{
+					h[i] = dot(v_[i], w);
+					axpy(-h[i], v_[i], w);
+				}
+				return;
+			}
+			// CGS2: projections of the pass are computed with the same w, the second pass corrects lost orthogonality
+			std::fill(h, h + k, static_cast<T>(0.0));
+			for (size_t pass = 0; pass < 2; ++pass)
+			{
+				for (size_t i = 0; i < k; ++i)
+				{
+					proj_[i] = dot(v_[i], w);
+					h[i] += proj_[i];
+				}
+				for (size_t i = 0; i < k; ++i)
+				{
+					axpy(-proj_[i], v_[i], w);
+				}
+			}
+		}
+
+		/**
+		* @brief res = b - A * x, v0 = res (M^-1 * res for left preconditioning)
+		* @return 2-norm of res
+		*/
+		T trueResidual(const LinearOperator<T>& A, const Matrix<T>& b, const Matrix<T>& x)
+		{
+			const size_t n = b.rows();
+			Matrix<T>& res = M_ != nullptr && side_ == PreconditionerSide::Left ? u_ : v_[0];
+			std::copy(b.data(), b.data() + n, res.data());
+			A.apply(static_cast<T>(-1.0), x, static_cast<T>(1.0), res);
+			if (M_ != nullptr && side_ == PreconditionerSide::Left)
+			{
+				M_->apply(res, v_[0]);
+			}
+			return nrm2(res);
+		}
+
+		/**
+		* @brief x = x + V * y (x + M^-1 * V * y for right preconditioning), y solves triangular system H y = g of order k
+		*/
+		void update(size_t k, Matrix<T>& x)
+		{
+			const size_t ldh = m_ + 1;
+			const T* h = h_.data();
+			// y is stored in g
+			for (size_t i = k; i-- > 0;)
+			{
+				T s = g_[i];
+				for (size_t l = i + 1; l < k; ++l)
+				{
+					s -= h[l * ldh + i] * g_[l];
+				}
+				// zero on diagonal: singular matrix, direction is skipped
+				g_[i] = h[i * ldh + i] == static_cast<T>(0.0) ? static_cast<T>(0.0) : s / h[i * ldh + i];
+			}
+			const bool right = M_ != nullptr && side_ == PreconditionerSide::Right;
+			Matrix<T>& u = right ? u_ : x;
+			if (right)
+			{
+				u_.fill(static_cast<T>(0.0));
+			}
+			for (size_t i = 0; i < k; ++i)
+			{
+				axpy(g_[i], v_[i], u);
+			}
+			if (right)
+			{
+				M_->apply(u_, z_);
+				axpy(static_cast<T>(1.0), z_, x);
+			}
+		}
+	};
+}
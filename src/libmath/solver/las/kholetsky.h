@@ -2,52 +2,63 @@
 
 #include <libmath/solver/las/lassolver.h>
 #include <libmath/matrix.h>
+#include <libmath/lu.h>
+
+#include <algorithm>
 
 namespace math
 {
 	/**
 	* @brief Class for solving LAS with Kholetsky method (via LU-decomposition)
+	* @details LU factorization with partial pivoting is kept between calls of solve():
+	* matrix A is factorized again only if it differs from matrix of the previous call.
+	* @note Despite the name, it is a general LU solver. Use Cholesky or LDLT for symmetric systems.
 	*/
 	template <typename T>
 	class Kholetsky :
 		public LASsolver<T>
 	{
 	public:
+		using LASsolver<T>::solve;
+
 		Kholetsky()
 		{
 			this->method_ = "Kholetsky";
 		}
 
 		/// @brief LASsolver::solve
+		/// @throws math::ExceptionDegenerateMatrix
 		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) override
 		{
 			// check inputs
-			checkInputs(A, b, x);
+			this->checkInputs(A, b, x);
 
-			// working arrays
-			Matrix<T> LUE = A.decompLU();
-			Matrix<T> Y(A.rows(), 1);
-			// first run (eq 2.11 ����������, p 68)
-			for (int i = 0; i < A.rows(); ++i)
-			{
-				Y(i, 0) = b(i, 0);
-				for (int k = 0; k <= i - 1; ++k)
-				{
-					Y(i, 0) -= LUE(i, k) * Y(k, 0);
-				}
-			}
-			// second run (eq 2.13 ����������, p 68)
-			// size_t i{0};
-			for (int j = static_cast<int>(A.rows() - 1); j >= 0; --j)
+			if (!lu_.factorized() || !sameMatrix(A))
 			{
-				size_t i = static_cast<size_t>(j);
-				x(i, 0) = Y(i, 0);
-				for (size_t k = i + 1; k < A.rows(); ++k)
-				{
-					x(i, 0) = x(i, 0) - LUE(i, k) * x(k, 0);
-				}
-				x(i, 0) = x(i, 0) / LUE(i, i);
+				A_ = A;
+				lu_.factorize(A);
 			}
+			x = b;
+			lu_.solveInPlace(x);
+		}
+
+		/// @brief Current factorization
+		const LU<T>& factorization() const
+		{
+			return lu_;
+		}
+
+	private:
+		/// @brief Matrix of the last factorization
+		Matrix<T> A_;
+		LU<T> lu_;
+
+		/// @brief Exact comparison with matrix of the last factorization
+		bool sameMatrix(const Matrix<T>& A) const
+		{
+			return A.rows() == A_.rows() && A.cols() == A_.cols() &&
+				A.representation() == A_.representation() &&
+				std::equal(A.data(), A.data() + A.numel(), A_.data());
 		}
 	};
-}
\ No newline at end of file
+}
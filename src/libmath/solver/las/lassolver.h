@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libmath/matrix.h>
+#include <libmath/linear_operator.h>
 #include <libmath/math_settings.h>
 #include <libmath/boolean.h>
 #include <string>
@@ -36,6 +37,12 @@ namespace math
 
 		/// @brief Target tolerance for numerical method for tolerance stopping criteria
 		real targetTolerance = math::settings::DefaultSettings.targetTolerance;
+
+		/// @brief Interval (in iterations) of computation of true residual @f$ \mathbf{b} - \mathbf{A} \mathbf{x} @f$
+		/// by iterative methods, which update residual by recurrence
+		/// @details True residual replaces the recurrence one, so rounding errors don't accumulate.
+		/// Besides, it is computed to confirm convergence. 0 - only to confirm convergence.
+		size_t residualCheckInterval = 50;
 	};
 
 	/**
@@ -107,8 +114,10 @@ namespace math
 
 		/**
 		* @brief Check input linear system
+		* @param A: Matrix or LinearOperator
 		*/
-		void checkInputs(const Matrix<T>& A, const Matrix<T>& b, const Matrix<T>& x)
+		template <typename A_t>
+		void checkInputs(const A_t& A, const Matrix<T>& b, const Matrix<T>& x)
 		{
 			if (A.cols() != A.rows())
 			{
@@ -142,6 +151,22 @@ namespace math
 		*/
 		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) = 0;
 
+		/**
+		* @brief Solve LAS with matrix given as linear operator (e.g. SparseMatrix)
+		* @details Supported by iterative methods, which need only products A * x.
+		* Direct methods throw math::Exception.
+		* @param A[in]: Operator of coefficients matrix
+		* @param b[in]: Column-vector of equations right-hands
+		* @param x[out]: Column vector of solution. Initial value of x used
+		* as initial guess for methods, that requires initial gues values
+		*/
+		virtual void solve(const LinearOperator<T>& /*A*/, const Matrix<T>& /*b*/, Matrix<T>& /*x*/)
+		{
+			throw(math::Exception(method_ + ": solving with linear operator isn't supported by method!"));
+		}
+
+		virtual ~LASsolver() = default;
+
 		/**
 		* @brief Set solver settings
 		* @param setup: Solver settings
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <libmath/solver/las/lassolver.h>
+#include <libmath/matrix.h>
+#include <libmath/cholesky.h>
+
+#include <vector>
+
+namespace math
+{
+	/**
+	* @brief Class for solving LAS with symmetric matrix by factorization @f$ \mathbf{A} = \mathbf{L} \mathbf{D} \mathbf{L}^T @f$
+	* @details Works without square roots and accepts symmetric indefinite matrices with non-zero
+	* leading minors (e.g. saddle point systems), no pivoting is done. Only lower triangle of A is used and stored.
+	* Factorization is kept between calls of solve(): A is factorized again only if its lower triangle
+	* differs from matrix of the previous call.
+	*/
+	template <typename T>
+	class LDLT :
+		public LASsolver<T>
+	{
+	public:
+		using LASsolver<T>::solve;
+
+		LDLT()
+		{
+			this->method_ = "LDLT";
+		}
+
+		/// @brief LASsolver::solve
+		/// @throws math::ExceptionIncorrectMatrix for non-symmetric matrix
+		/// @throws math::ExceptionDegenerateMatrix
+		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) override
+		{
+			// check inputs
+			this->checkInputs(A, b, x);
+
+			if (!ldlt_.factorized() || !detail::sameLower(A, A_))
+			{
+				if (!detail::isSymmetric(A))
+				{
+					throw(math::ExceptionIncorrectMatrix(this->method_ + ": matrix A must be symmetric!"));
+				}
+				detail::packLower(A, A_);
+				ldlt_.factorize(A);
+			}
+			x = b;
+			ldlt_.solveInPlace(x);
+		}
+
+		/// @brief Solve LAS with matrix in packed storage, symmetry check and conversion aren't needed
+		/// @throws math::ExceptionDegenerateMatrix
+		void solve(const SymmetricMatrix<T>& A, const Matrix<T>& b, Matrix<T>& x)
+		{
+			// check inputs
+			this->checkInputs(A, b, x);
+
+			if (!ldlt_.factorized() || A.packed() != A_)
+			{
+				A_ = A.packed();
+				ldlt_.factorize(A);
+			}
+			x = b;
+			ldlt_.solveInPlace(x);
+		}
+
+		/// @brief Current factorization
+		const LDLTFactorization<T>& factorization() const
+		{
+			return ldlt_;
+		}
+
+	private:
+		/// @brief Lower triangle of matrix of the last factorization
+		std::vector<T> A_;
+		LDLTFactorization<T> ldlt_;
+	};
+}
@@ -0,0 +1,502 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/sparse.h>
+#include <libmath/math_exception.h>
+#include <libmath/blas/lu.h>
+#include <libmath/blas/sparse.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Side of application of preconditioner M in iterative solvers
+	*	- Left: @f$ \mathbf{M}^{-1} \mathbf{A} \mathbf{x} = \mathbf{M}^{-1} \mathbf{b} @f$
+	*	- Right: @f$ \mathbf{A} \mathbf{M}^{-1} \mathbf{y} = \mathbf{b}, \mathbf{x} = \mathbf{M}^{-1} \mathbf{y} @f$,
+	* residual of the original system is kept by recurrence
+	*/
+	enum class PreconditionerSide
+	{
+		Left = 0,
+		Right
+	};
+
+	/**
+	* @brief Interface of preconditioner @f$ \mathbf{M} \approx \mathbf{A} @f$ for iterative solvers
+	* @details Preconditioner is built from matrix by setup() (or by constructor of implementation),
+	* after that apply() computes @f$ \mathbf{z} = \mathbf{M}^{-1} \mathbf{r} @f$ without allocations.
+	* Preconditioner isn't updated by solver: setup() must be called again, when matrix changes.
+	*
+	* Example of using in C++:
+	* @code
+	* #include <libmath/solver/las/bicgstab.h>
+	*
+	* int main()
+	* {
+	*	math::SparseMatrix<double> A = ...;
+	*	math::ILU0Preconditioner<double> M(A);
+	*
+	*	math::BicGStab<double> solver;
+	*	solver.setPreconditioner(&M, math::PreconditionerSide::Right);
+	*	solver.solve(A, b, x);
+	* }
+	* @endcode
+	*/
+	template <typename T>
+	class Preconditioner
+	{
+	public:
+		virtual ~Preconditioner() = default;
+
+		/// @brief Dimension of preconditioner
+		virtual size_t rows() const = 0;
+
+		/**
+		* @brief Build preconditioner from sparse matrix
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		virtual void setup(const SparseMatrix<T>& A) = 0;
+
+		/**
+		* @brief Build preconditioner from dense matrix
+		* @details By default zero elements are dropped and preconditioner is built from sparse matrix
+		* @throws math::ExceptionNonSquareMatrix
+		*/
+		virtual void setup(const Matrix<T>& A)
+		{
+			setup(SparseMatrix<T>(A));
+		}
+
+		/**
+		* @brief @f$ \mathbf{z} = \mathbf{M}^{-1} \mathbf{r} @f$
+		* @param r: Column matrix of rows() elements
+		* @param z[out]: Column matrix of rows() elements, other than r
+		*/
+		virtual void apply(const Matrix<T>& r, Matrix<T>& z) const = 0;
+
+	protected:
+		template <typename A_t>
+		static void checkSquare(const A_t& A, const char* name)
+		{
+			if (A.rows() != A.cols())
+			{
+				throw(math::ExceptionNonSquareMatrix(std::string(name) + ": matrix must be square!"));
+			}
+		}
+
+		/**
+		* @brief Positions of diagonal elements in rows of CSR matrix
+		* @throws math::ExceptionDegenerateMatrix if diagonal element isn't stored
+		*/
+		static std::vector<size_t> diagonalPositions(const SparseMatrix<T>& A, const char* name)
+		{
+			std::vector<size_t> diag(A.rows());
+			const std::vector<size_t>& ptr = A.rowPtr();
+			const std::vector<size_t>& ind = A.colIndices();
+			for (size_t i = 0; i < A.rows(); ++i)
+			{
+				const auto it = std::lower_bound(ind.begin() + ptr[i], ind.begin() + ptr[i + 1], i);
+				if (it == ind.begin() + ptr[i + 1] || *it != i)
+				{
+					throw(math::ExceptionDegenerateMatrix(std::string(name) + ": zero on diagonal of matrix!"));
+				}
+				diag[i] = static_cast<size_t>(it - ind.begin());
+			}
+			return diag;
+		}
+	};
+
+	/**
+	* @brief Jacobi (diagonal) preconditioner @f$ \mathbf{M} = diag(\mathbf{A}) @f$
+	* @details Cheapest preconditioner: scaling of rows. Suits for matrices with dominating diagonal
+	* and elements of very different scales.
+	*/
+	template <typename T>
+	class JacobiPreconditioner :
+		public Preconditioner<T>
+	{
+	public:
+		using Preconditioner<T>::setup;
+
+		JacobiPreconditioner() = default;
+
+		explicit JacobiPreconditioner(const Matrix<T>& A)
+		{
+			setup(A);
+		}
+
+		explicit JacobiPreconditioner(const SparseMatrix<T>& A)
+		{
+			setup(A);
+		}
+
+		virtual size_t rows() const override
+		{
+			return inv_.size();
+		}
+
+		/// @brief Preconditioner::setup
+		/// @throws math::ExceptionDegenerateMatrix for zero on diagonal
+		virtual void setup(const SparseMatrix<T>& A) override
+		{
+			build(A);
+		}
+
+		/// @brief Preconditioner::setup
+		/// @throws math::ExceptionDegenerateMatrix for zero on diagonal
+		virtual void setup(const Matrix<T>& A) override
+		{
+			build(A);
+		}
+
+		/// @brief Preconditioner::apply
+		virtual void apply(const Matrix<T>& r, Matrix<T>& z) const override
+		{
+			const T* rp = r.data();
+			T* zp = z.data();
+			for (size_t i = 0; i < inv_.size(); ++i)
+			{
+				zp[i] = inv_[i] * rp[i];
+			}
+		}
+
+	private:
+		/// @brief Inverse of diagonal
+		std::vector<T> inv_;
+
+		template <typename A_t>
+		void build(const A_t& A)
+		{
+			this->checkSquare(A, "JacobiPreconditioner");
+			inv_.resize(A.rows());
+			for (size_t i = 0; i < A.rows(); ++i)
+			{
+				const T d = A.coeff(i, i);
+				if (d == static_cast<T>(0))
+				{
+					throw(math::ExceptionDegenerateMatrix("JacobiPreconditioner: zero on diagonal of matrix!"));
+				}
+				inv_[i] = static_cast<T>(1) / d;
+			}
+		}
+	};
+
+	/**
+	* @brief Block-Jacobi preconditioner: M consists of diagonal blocks of A
+	* @details Diagonal blocks blockSize*blockSize (the last block may be smaller) are factorized by LU,
+	* other elements are ignored. Suits for systems, which consist of weakly coupled groups of unknowns
+	* (e.g. joints of one limb).
+	*/
+	template <typename T>
+	class BlockJacobiPreconditioner :
+		public Preconditioner<T>
+	{
+	public:
+		using Preconditioner<T>::setup;
+
+		/**
+		* @param blockSize: Size of diagonal blocks
+		*/
+		explicit BlockJacobiPreconditioner(size_t blockSize)
+			: bs_{ std::max(blockSize, size_t(1)) }
+		{
+		}
+
+		BlockJacobiPreconditioner(const Matrix<T>& A, size_t blockSize)
+			: bs_{ std::max(blockSize, size_t(1)) }
+		{
+			setup(A);
+		}
+
+		BlockJacobiPreconditioner(const SparseMatrix<T>& A, size_t blockSize)
+			: bs_{ std::max(blockSize, size_t(1)) }
+		{
+			setup(A);
+		}
+
+		virtual size_t rows() const override
+		{
+			return n_;
+		}
+
+		/// @brief Size of diagonal blocks
+		size_t blockSize() const
+		{
+			return bs_;
+		}
+
+		/// @brief Preconditioner::setup
+		/// @throws math::ExceptionDegenerateMatrix for singular diagonal block
+		virtual void setup(const SparseMatrix<T>& A) override
+		{
+			build(A);
+		}
+
+		/// @brief Preconditioner::setup
+		/// @throws math::ExceptionDegenerateMatrix for singular diagonal block
+		virtual void setup(const Matrix<T>& A) override
+		{
+			build(A);
+		}
+
+		/// @brief Preconditioner::apply
+		virtual void apply(const Matrix<T>& r, Matrix<T>& z) const override
+		{
+			const T* rp = r.data();
+			T* zp = z.data();
+			std::copy(rp, rp + n_, zp);
+			for (size_t i0 = 0; i0 < n_; i0 += bs_)
+			{
+				const size_t b = std::min(bs_, n_ - i0);
+				blas::getrs(b, lu_.data() + i0 * bs_, b, piv_.data() + i0, 1, zp + i0, size_t(1), size_t(1));
+			}
+		}
+
+	private:
+		size_t bs_;
+		size_t n_ = 0;
+		/// @brief LU factors of blocks (row by row), block from row i0 starts from i0 * bs_
+		std::vector<T> lu_;
+		/// @brief Pivots of blocks
+		std::vector<size_t> piv_;
+
+		template <typename A_t>
+		void build(const A_t& A)
+		{
+			this->checkSquare(A, "BlockJacobiPreconditioner");
+			n_ = A.rows();
+			lu_.resize(n_ * bs_);
+			piv_.resize(n_);
+			for (size_t i0 = 0; i0 < n_; i0 += bs_)
+			{
+				const size_t b = std::min(bs_, n_ - i0);
+				T* block = lu_.data() + i0 * bs_;
+				for (size_t i = 0; i < b; ++i)
+				{
+					for (size_t j = 0; j < b; ++j)
+					{
+						block[i * b + j] = A.coeff(i0 + i, i0 + j);
+					}
+				}
+				if (blas::getrf(b, block, b, piv_.data() + i0) != 0)
+				{
+					throw(math::ExceptionDegenerateMatrix("BlockJacobiPreconditioner: diagonal block of matrix is singular!"));
+				}
+			}
+		}
+	};
+
+	/**
+	* @brief Incomplete LU factorization without fill-in ILU(0): @f$ \mathbf{M} = \mathbf{L} \mathbf{U} @f$,
+	* factors have sparsity pattern of A
+	* @details Factors are stored in one CSR matrix (L is unit lower triangular), application costs two
+	* triangular solves of nnz(A) operations. Pivoting isn't made, so all diagonal elements must be stored.
+	* Dense matrix is factorized on pattern of its non-zeros.
+	* @see Y. Saad, Iterative methods for sparse linear systems, 2nd ed., 2003, section 10.3.2
+	*/
+	template <typename T>
+	class ILU0Preconditioner :
+		public Preconditioner<T>
+	{
+	public:
+		using Preconditioner<T>::setup;
+
+		ILU0Preconditioner() = default;
+
+		explicit ILU0Preconditioner(const Matrix<T>& A)
+		{
+			setup(A);
+		}
+
+		explicit ILU0Preconditioner(const SparseMatrix<T>& A)
+		{
+			setup(A);
+		}
+
+		virtual size_t rows() const override
+		{
+			return diag_.size();
+		}
+
+		/// @brief Preconditioner::setup
+		/// @throws math::ExceptionDegenerateMatrix for zero pivot
+		virtual void setup(const SparseMatrix<T>& A) override
+		{
+			this->checkSquare(A, "ILU0Preconditioner");
+			const size_t n = A.rows();
+			ptr_ = A.rowPtr();
+			ind_ = A.colIndices();
+			val_ = A.values();
+			diag_ = this->diagonalPositions(A, "ILU0Preconditioner");
+
+			// positions of elements of current row by columns
+			const size_t none = ind_.size();
+			std::vector<size_t> pos(n, none);
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t k = ptr_[i]; k < ptr_[i + 1]; ++k)
+				{
+					pos[ind_[k]] = k;
+				}
+				// row i -= l(i,j) * row j of U for j < i
+				for (size_t k = ptr_[i]; k < diag_[i]; ++k)
+				{
+					const size_t j = ind_[k];
+					val_[k] /= val_[diag_[j]];
+					const T lij = val_[k];
+					for (size_t q = diag_[j] + 1; q < ptr_[j + 1]; ++q)
+					{
+						const size_t p = pos[ind_[q]];
+						if (p != none)
+						{
+							val_[p] -= lij * val_[q];
+						}
+					}
+				}
+				if (val_[diag_[i]] == static_cast<T>(0))
+				{
+					throw(math::ExceptionDegenerateMatrix("ILU0Preconditioner: zero pivot!"));
+				}
+				for (size_t k = ptr_[i]; k < ptr_[i + 1]; ++k)
+				{
+					pos[ind_[k]] = none;
+				}
+			}
+		}
+
+		/// @brief Preconditioner::apply
+		virtual void apply(const Matrix<T>& r, Matrix<T>& z) const override
+		{
+			const size_t n = rows();
+			T* zp = z.data();
+			std::copy(r.data(), r.data() + n, zp);
+			blas::csrsvLower(n, ptr_.data(), ind_.data(), val_.data(), diag_.data(), true, zp);
+			blas::csrsvUpper(n, ptr_.data(), ind_.data(), val_.data(), diag_.data(), zp);
+		}
+
+	private:
+		/// @brief L (without unit diagonal) and U in CSR format with pattern of A
+		std::vector<size_t> ptr_;
+		std::vector<size_t> ind_;
+		std::vector<T> val_;
+		/// @brief Positions of diagonal elements
+		std::vector<size_t> diag_;
+	};
+
+	/**
+	* @brief Incomplete Cholesky factorization without fill-in IC(0): @f$ \mathbf{M} = \mathbf{L} \mathbf{L}^T @f$,
+	* L has sparsity pattern of lower triangle of A
+	* @details For symmetric positive-definite matrices (e.g. normal equations), only lower triangle of A is used.
+	* Costs half of ILU(0) in memory and factorization.
+	* @see Y. Saad, Iterative methods for sparse linear systems, 2nd ed., 2003, section 10.3.5
+	*/
+	template <typename T>
+	class IC0Preconditioner :
+		public Preconditioner<T>
+	{
+	public:
+		using Preconditioner<T>::setup;
+
+		IC0Preconditioner() = default;
+
+		explicit IC0Preconditioner(const Matrix<T>& A)
+		{
+			setup(A);
+		}
+
+		explicit IC0Preconditioner(const SparseMatrix<T>& A)
+		{
+			setup(A);
+		}
+
+		virtual size_t rows() const override
+		{
+			return diag_.size();
+		}
+
+		/// @brief Preconditioner::setup
+		/// @throws math::ExceptionIncorrectMatrix if factorization breaks down (matrix isn't positive definite)
+		virtual void setup(const SparseMatrix<T>& A) override
+		{
+			this->checkSquare(A, "IC0Preconditioner");
+			const size_t n = A.rows();
+			const std::vector<size_t>& aptr = A.rowPtr();
+			const std::vector<size_t>& aind = A.colIndices();
+			const std::vector<T>& aval = A.values();
+			const std::vector<size_t> adiag = this->diagonalPositions(A, "IC0Preconditioner");
+
+			// lower triangle of A, diagonal is the last element of row
+			ptr_.assign(n + 1, 0);
+			ind_.clear();
+			val_.clear();
+			diag_.resize(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				ind_.insert(ind_.end(), aind.begin() + aptr[i], aind.begin() + adiag[i] + 1);
+				val_.insert(val_.end(), aval.begin() + aptr[i], aval.begin() + adiag[i] + 1);
+				ptr_[i + 1] = ind_.size();
+				diag_[i] = ind_.size() - 1;
+			}
+
+			// positions of elements of current row by columns
+			const size_t none = ind_.size();
+			std::vector<size_t> pos(n, none);
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t k = ptr_[i]; k < diag_[i]; ++k)
+				{
+					pos[ind_[k]] = k;
+				}
+				// l(i,j) = (a(i,j) - sum l(i,m) * l(j,m)) / l(j,j), m < j
+				T d = val_[diag_[i]];
+				for (size_t k = ptr_[i]; k < diag_[i]; ++k)
+				{
+					const size_t j = ind_[k];
+					T s = val_[k];
+					for (size_t q = ptr_[j]; q < diag_[j]; ++q)
+					{
+						const size_t p = pos[ind_[q]];
+						if (p != none)
+						{
+							s -= val_[p] * val_[q];
+						}
+					}
+					val_[k] = s / val_[diag_[j]];
+					d -= val_[k] * val_[k];
+				}
+				if (!(d > static_cast<T>(0)))
+				{
+					throw(math::ExceptionIncorrectMatrix("IC0Preconditioner: factorization breaks down, matrix must be positive definite!"));
+				}
+				val_[diag_[i]] = std::sqrt(d);
+				for (size_t k = ptr_[i]; k < diag_[i]; ++k)
+				{
+					pos[ind_[k]] = none;
+				}
+			}
+		}
+
+		/// @brief Preconditioner::apply
+		virtual void apply(const Matrix<T>& r, Matrix<T>& z) const override
+		{
+			const size_t n = rows();
+			T* zp = z.data();
+			std::copy(r.data(), r.data() + n, zp);
+			blas::csrsvLower(n, ptr_.data(), ind_.data(), val_.data(), diag_.data(), false, zp);
+			blas::csrsvLowerT(n, ptr_.data(), ind_.data(), val_.data(), diag_.data(), zp);
+		}
+
+	private:
+		/// @brief L in CSR format
+		std::vector<size_t> ptr_;
+		std::vector<size_t> ind_;
+		std::vector<T> val_;
+		/// @brief Positions of diagonal elements (the last in rows)
+		std::vector<size_t> diag_;
+	};
+}
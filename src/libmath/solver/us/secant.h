@@ -2,6 +2,10 @@
 
 #include <libmath/solver/us/unlinearsolver.h>
 #include <libmath/differential.h>
+#include <libmath/blas.h>
+#include <libmath/lu.h>
+#include <libmath/cholesky.h>
+#include <libmath/blas/condest.h>
 #include <functional>
 #include <vector>
 
@@ -25,6 +29,7 @@ namespace math
 		Secant(const USsetup& setup)
 		{
 			this->method_ = "Secant";
+			this->setupSolver(setup);
 		};
 
 		virtual void solve(const std::vector<std::function<T(const Matrix<T>&)>>& F, Matrix<T>& x) override
@@ -40,16 +45,16 @@ namespace math
             }
 
             size_t n = F.size();
-            Matrix<T> dx(n, 1);
+            reserve(n);
+            Matrix<T>& dx = dx_;
             dx.fill(static_cast<T>(0.0));
 
-            Matrix<T> df(F.size(), x.rows());
+            Matrix<T>& df = df_;
 
             // residuals column-matrix
-            Matrix<T> y(n, 1);
+            Matrix<T>& y = y_;
             y.fill(static_cast<T>(0.0));
 
-            std::vector<T> r(n, static_cast<T>(1.0));
             T E = static_cast<T>(1.0);
 
             size_t iter_cnt = 0;
@@ -59,7 +64,7 @@ namespace math
 
             while (!stop)
             {
-                math::jacobi(F, x, df, this->currentSetup_.diff_scheme, this->currentSetup_.diff_step);
+                math::jacobi(F, x, df, xw_, this->currentSetup_.diff_scheme, this->diffStep(x));
 
                 for (size_t i = 0; i < n; ++i)
                 {
@@ -69,7 +74,14 @@ namespace math
                 // solve system
                 if (df.numel() > 1)
                 {
-                    this->currentSetup_.linearSolver->solve(df, y, dx);
+                    if (this->currentSetup_.conditionLimit > 0.0)
+                    {
+                        step(df, y, dx);
+                    }
+                    else
+                    {
+                        this->currentSetup_.linearSolver->solve(df, y, dx);
+                    }
                 }
 
                 // solve single equation
@@ -78,21 +90,19 @@ namespace math
                     dx(0, 0) = y(0, 0) / df(0, 0);
                 }
 
-                for (size_t i = 0; i < n; ++i)
-                {
-                    x(i, 0) += dx(i, 0);
-                }
+                axpy(static_cast<T>(1.0), dx, x);
 
                 ++iter_cnt;
 
                 // define stopping criteria
                 if (this->currentSetup_.criteria == USStoppingCriteriaType::tolerance)
                 {
+                    // maximum relative step
+                    E = static_cast<T>(0.0);
                     for (size_t i = 0; i < n; ++i)
                     {
-                        r[i] = abs((x(i, 0) - (x(i, 0) + dx(i, 0))) / x(i, 0));
+                        E = std::max(E, std::abs(dx.data()[i] / x.data()[i]));
                     }
-                    E = *std::max_element(r.begin(), r.end());
 
                     if (E <= static_cast<T>(this->currentSetup_.targetTolerance))
                     {
@@ -117,5 +127,57 @@ namespace math
 
 
 		}
+
+		/**
+		* @brief Allocate work matrices for systems of n equations
+		* @details Is called by solve(), but may be called beforehand to avoid allocations in control loop.
+		* Work matrices are kept between calls of solve(), so repeated solving of systems of the same size
+		* doesn't allocate memory (if linear solver doesn't allocate, see BicGStab::reserve). With
+		* USsetup::conditionLimit only damped steps for ill-conditioned Jacobian allocate.
+		*/
+		void reserve(size_t n)
+		{
+			if (dx_.rows() == n && df_.rows() == n)
+			{
+				return;
+			}
+			dx_ = Matrix<T>(n, 1);
+			y_ = Matrix<T>(n, 1);
+			df_ = Matrix<T>(n, n);
+			xw_ = Matrix<T>(n, 1);
+		}
+
+	private:
+		/// @brief Step, Jacobian and residuals (work matrices of solve())
+		Matrix<T> dx_, df_, y_;
+		/// @brief Work copy of x for Jacobian
+		Matrix<T> xw_;
+
+		/// @brief Factorization of Jacobian (storage is reused between iterations)
+		LU<T> lu_;
+
+		/**
+		* @brief Newton step by LU, or damped step if Jacobian is ill-conditioned (see USsetup::conditionLimit)
+		*/
+		void step(const Matrix<T>& J, const Matrix<T>& y, Matrix<T>& dx)
+		{
+			lu_.factorize(J);
+			if (!lu_.singular() && lu_.rcond() * static_cast<T>(this->currentSetup_.conditionLimit) >= static_cast<T>(1))
+			{
+				dx = y;
+				lu_.solveInPlace(dx);
+				return;
+			}
+			// (J^T J + lambda^2 I) dx = J^T y
+			const Matrix<T> Jt = J.getTr();
+			Matrix<T> JtJ = Jt * J;
+			const T lambda = static_cast<T>(this->currentSetup_.damping) * blas::norm1(J.rows(), J.cols(), J.data(), J.rowStride(), J.colStride());
+			for (size_t i = 0; i < JtJ.rows(); ++i)
+			{
+				JtJ(i, i) += lambda * lambda;
+			}
+			dx = Jt * y;
+			CholeskyFactorization<T>(JtJ).solveInPlace(dx);
+		}
 	};
 }
\ No newline at end of file
@@ -8,6 +8,10 @@
 #include <libmath/solver/las/bicgstab.h>
 #include <functional>
 #include <vector>
+#include <memory>
+#include <limits>
+#include <cmath>
+#include <algorithm>
 
 namespace math
 {
@@ -27,10 +31,6 @@ namespace math
 	*/
 	struct USsetup
 	{
-		~USsetup()
-		{
-			delete linearSolver;
-		}
 		/// @brief Stopping criteria
 		USStoppingCriteriaType criteria = USStoppingCriteriaType::tolerance;
 
@@ -45,16 +45,31 @@ namespace math
 		/// @brief Target tolerance for numerical method
 		real targetTolerance = math::settings::DefaultSettings.targetTolerance;
 
-		/// @brief Differential step, @f$ \Delta x = x_i-x_{i-1} @f$, @f$ \Delta x = x_i-x_{i-1} @f$
-		real diff_step = 0.001 * math::settings::CurrentSettings.targetTolerance;
+		/// @brief Differential step, @f$ \Delta x = x_i-x_{i-1} @f$
+		/// @details 0 - step is chosen by precision of T on every iteration,
+		/// @f$ \Delta x = \sqrt{\varepsilon} \max(\|\mathbf{x}\|_\infty, 1) @f$ (see UnlinearSolver::diffStep)
+		real diff_step = 0.0;
 
 		/// @brief Differential scheme
 		/// @see math::partialDerivate
 		int diff_scheme = 1;
 
 		/// @brief Internal linear system solver
+		/// @details Copies of settings share the solver (and its work vectors), e.g.
+		/// setup.linearSolver = std::make_shared<math::Cholesky<math::real>>();
 		/// @see LASsolver
-		LASsolver<real>* linearSolver = new BicGStab<real>();
+		std::shared_ptr<LASsolver<real>> linearSolver = std::make_shared<BicGStab<real>>();
+
+		/// @brief Limit of condition number of Jacobian, from which damped steps are made
+		/// @details 0 - condition isn't checked, steps are solved by linearSolver. Otherwise Jacobian is factorized
+		/// by LU and its condition number is estimated in O(n^2) (see LU::cond). Nearly singular Jacobian
+		/// (e.g. fully stretched leg) gives damped least squares (Levenberg-Marquardt) step
+		/// @f$ (\mathbf{J}^T \mathbf{J} + \lambda^2 \mathbf{I}) \Delta x = \mathbf{J}^T \mathbf{y} @f$ instead of huge Newton step.
+		real conditionLimit = 0.0;
+
+		/// @brief Damping of steps for ill-conditioned Jacobian relative to its norm, @f$ \lambda = damping \|\mathbf{J}\|_1 @f$
+		/// @see conditionLimit
+		real damping = 1.e-3;
 
 	};
 
@@ -162,7 +177,31 @@ namespace math
 					throw(math::Exception(method_ + ": Invalid target tolerance. Tolerance must be greater than 0!"));
 				}
 			}
+			if (setup.diff_step < 0.0)
+			{
+				throw(math::ExceptionInvalidValue(method_ + ": Invalid differential step. Step must be positive number or 0!"));
+			}
 		};
+
+		/**
+		* @brief Differential step of Jacobian at point x
+		* @details USsetup::diff_step, if it is set, otherwise @f$ \sqrt{\varepsilon} \max(\|\mathbf{x}\|_\infty, 1) @f$:
+		* truncation and rounding errors of one-sided difference are balanced, so the step suits float
+		* as well as double builds (fixed step near epsilon of float gives mostly rounding noise).
+		*/
+		T diffStep(const Matrix<T>& x) const
+		{
+			if (currentSetup_.diff_step > 0.0)
+			{
+				return static_cast<T>(currentSetup_.diff_step);
+			}
+			T xmax = static_cast<T>(1.0);
+			for (size_t i = 0; i < x.numel(); ++i)
+			{
+				xmax = std::max(xmax, std::abs(x.data()[i]));
+			}
+			return std::sqrt(std::numeric_limits<T>::epsilon()) * xmax;
+		}
 	public:
 
 		/**
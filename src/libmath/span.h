@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Non-owning view of contiguous sequence of elements
+	* @details Minimal replacement of std::span (C++20). T may be const-qualified.
+	* Owner of elements must outlive the span.
+	*/
+	template <typename T>
+	class Span
+	{
+	public:
+		typedef T element_type;
+		typedef T* iterator;
+
+		Span() = default;
+
+		Span(T* data, size_t size)
+			: data_(data), size_(size)
+		{
+		}
+
+		T* data() const
+		{
+			return data_;
+		}
+
+		size_t size() const
+		{
+			return size_;
+		}
+
+		bool empty() const
+		{
+			return size_ == 0;
+		}
+
+		T& operator[](size_t i) const
+		{
+			return data_[i];
+		}
+
+		T* begin() const
+		{
+			return data_;
+		}
+
+		T* end() const
+		{
+			return data_ + size_;
+		}
+
+		const T* cbegin() const
+		{
+			return data_;
+		}
+
+		const T* cend() const
+		{
+			return data_ + size_;
+		}
+
+	private:
+		T* data_ = nullptr;
+		size_t size_ = 0;
+	};
+}
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <libmath/linear_operator.h>
+#include <libmath/blas/sparse.h>
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Element of sparse matrix for building from triplets (row, col, value)
+	*/
+	template <typename T>
+	struct Triplet
+	{
+		size_t row;
+		size_t col;
+		T value;
+	};
+
+	/**
+	* @brief Sparse matrix in compressed sparse row (CSR) format
+	* @details Only non-zero elements are stored: values of row i are values()[rowPtr()[i]:rowPtr()[i+1]]
+	* in columns colIndices()[rowPtr()[i]:rowPtr()[i+1]], columns are sorted inside a row.
+	* Memory and time of product with vector are proportional to number of non-zeros nnz().
+	* SparseMatrix is a LinearOperator, so it can be passed to iterative solvers directly.
+	*
+	* Example of using in C++:
+	* @code
+	* #include <libmath/sparse.h>
+	* #include <libmath/solver/las/bicgstab.h>
+	*
+	* int main()
+	* {
+	*	std::vector<math::Triplet<double>> t = { {0, 0, 4.0}, {0, 1, 1.0}, {1, 0, 1.0}, {1, 1, 3.0} };
+	*	math::SparseMatrix<double> A = math::SparseMatrix<double>::fromTriplets(2, 2, t);
+	*
+	*	math::Matrix<double> b = { {1.0}, {2.0} };
+	*	math::Matrix<double> x(2, 1);
+	*	math::BicGStab<double>().solve(A, b, x);
+	* }
+	* @endcode
+	*/
+	template <typename T>
+	class SparseMatrix :
+		public LinearOperator<T>
+	{
+	public:
+		typedef T value_type;
+
+		/**
+		 * @brief Empty matrix 0*0
+		 */
+		SparseMatrix()
+			: rows_{ 0 }, cols_{ 0 }, ptr_(1, 0)
+		{
+		}
+
+		/**
+		 * @brief Zero matrix rows*cols without non-zeros
+		 */
+		SparseMatrix(size_t rows, size_t cols)
+			: rows_{ rows }, cols_{ cols }, ptr_(rows + 1, 0)
+		{
+		}
+
+		/**
+		 * @brief Compress dense matrix
+		 * @param dropTolerance: Elements with absolute value not greater than dropTolerance aren't stored
+		 */
+		explicit SparseMatrix(const Matrix<T>& A, T dropTolerance = static_cast<T>(0))
+			: rows_{ A.rows() }, cols_{ A.cols() }, ptr_(A.rows() + 1, 0)
+		{
+			for (size_t i = 0; i < rows_; ++i)
+			{
+				for (size_t j = 0; j < cols_; ++j)
+				{
+					const T v = A.coeff(i, j);
+					if (std::abs(v) > dropTolerance)
+					{
+						ind_.push_back(j);
+						val_.push_back(v);
+					}
+				}
+				ptr_[i + 1] = ind_.size();
+			}
+		}
+
+		/**
+		 * @brief Build matrix from list of triplets (row, col, value)
+		 * @details Triplets may be given in any order, values of duplicated positions are summed.
+		 * Complexity is O(nnz log(nnz / rows) + rows).
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		static SparseMatrix<T> fromTriplets(size_t rows, size_t cols, const std::vector<Triplet<T>>& triplets)
+		{
+			SparseMatrix<T> S(rows, cols);
+			// count elements of rows
+			for (const Triplet<T>& t : triplets)
+			{
+				if (t.row >= rows || t.col >= cols)
+				{
+					throw(math::ExceptionIndexOutOfBounds("SparseMatrix::fromTriplets: index of triplet out of bounds!"));
+				}
+				++S.ptr_[t.row + 1];
+			}
+			for (size_t i = 0; i < rows; ++i)
+			{
+				S.ptr_[i + 1] += S.ptr_[i];
+			}
+			// distribute by rows
+			std::vector<size_t> next(S.ptr_.begin(), S.ptr_.end() - 1);
+			std::vector<std::pair<size_t, T>> entries(triplets.size());
+			for (const Triplet<T>& t : triplets)
+			{
+				entries[next[t.row]++] = { t.col, t.value };
+			}
+			// sort columns inside rows and sum duplicates
+			S.ind_.reserve(entries.size());
+			S.val_.reserve(entries.size());
+			size_t begin = 0;
+			for (size_t i = 0; i < rows; ++i)
+			{
+				const size_t end = S.ptr_[i + 1];
+				std::sort(entries.begin() + begin, entries.begin() + end,
+					[](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b) { return a.first < b.first; });
+				const size_t rowStart = S.ind_.size();
+				for (size_t k = begin; k < end; ++k)
+				{
+					if (S.ind_.size() > rowStart && S.ind_.back() == entries[k].first)
+					{
+						S.val_.back() += entries[k].second;
+					}
+					else
+					{
+						S.ind_.push_back(entries[k].first);
+						S.val_.push_back(entries[k].second);
+					}
+				}
+				begin = end;
+				S.ptr_[i + 1] = S.ind_.size();
+			}
+			return S;
+		}
+
+		virtual size_t rows() const override
+		{
+			return rows_;
+		}
+
+		virtual size_t cols() const override
+		{
+			return cols_;
+		}
+
+		/// @brief Number of stored elements
+		size_t nnz() const
+		{
+			return val_.size();
+		}
+
+		/// @brief Positions of rows in colIndices() and values(), rows() + 1 elements
+		const std::vector<size_t>& rowPtr() const
+		{
+			return ptr_;
+		}
+
+		/// @brief Columns of stored elements
+		const std::vector<size_t>& colIndices() const
+		{
+			return ind_;
+		}
+
+		/// @brief Stored elements
+		const std::vector<T>& values() const
+		{
+			return val_;
+		}
+
+		/**
+		 * @brief Stored elements for update of values with the same sparsity pattern
+		 */
+		std::vector<T>& values()
+		{
+			return val_;
+		}
+
+		/**
+		 * @brief Element (row, col), zero if it isn't stored
+		 * @details Binary search inside the row
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		T coeff(size_t row, size_t col) const
+		{
+			if (row >= rows_ || col >= cols_)
+			{
+				throw(math::ExceptionIndexOutOfBounds("SparseMatrix::coeff: index out of bounds!"));
+			}
+			auto first = ind_.begin() + ptr_[row];
+			auto last = ind_.begin() + ptr_[row + 1];
+			auto it = std::lower_bound(first, last, col);
+			if (it != last && *it == col)
+			{
+				return val_[it - ind_.begin()];
+			}
+			return static_cast<T>(0);
+		}
+
+		/**
+		 * @brief Dense copy of matrix
+		 */
+		Matrix<T> toMatrix() const
+		{
+			Matrix<T> A(rows_, cols_);
+			A.fill(static_cast<T>(0));
+			for (size_t i = 0; i < rows_; ++i)
+			{
+				for (size_t k = ptr_[i]; k < ptr_[i + 1]; ++k)
+				{
+					A.coeffRef(i, ind_[k]) = val_[k];
+				}
+			}
+			return A;
+		}
+
+		/**
+		 * @brief Product @f$ \mathbf{y} = \alpha \mathbf{A} \mathbf{x} + \beta \mathbf{y} @f$ (see blas::csrmv)
+		 * @throws math::ExceptionIncorrectMatrix
+		 */
+		virtual void apply(T alpha, const Matrix<T>& x, T beta, Matrix<T>& y) const override
+		{
+			if (x.numel() != cols_ || (x.rows() != 1 && x.cols() != 1))
+			{
+				throw(math::ExceptionIncorrectMatrix("SparseMatrix::apply: dimensions of arguments A and x didn't agree!"));
+			}
+			if (y.numel() != rows_ || (y.rows() != 1 && y.cols() != 1))
+			{
+				throw(math::ExceptionIncorrectMatrix("SparseMatrix::apply: dimensions of arguments A and y didn't agree!"));
+			}
+			blas::csrmv(rows_, alpha, ptr_.data(), ind_.data(), val_.data(),
+				x.data(), static_cast<size_t>(1),
+				beta,
+				y.data(), static_cast<size_t>(1));
+		}
+
+	private:
+		size_t rows_;
+		size_t cols_;
+		//! Row pointers (rows_ + 1)
+		std::vector<size_t> ptr_;
+		//! Column indices of non-zeros
+		std::vector<size_t> ind_;
+		//! Non-zeros
+		std::vector<T> val_;
+	};
+
+	/**
+	* @brief Product of sparse and dense matrices
+	* @details Every column of B is multiplied by SpMV
+	* @throws math::ExceptionInvalidValue
+	*/
+	template <typename T>
+	Matrix<T> operator*(const SparseMatrix<T>& A, const Matrix<T>& B)
+	{
+		if (A.cols() != B.rows())
+		{
+			throw(math::ExceptionInvalidValue("SparseMatrix<T>::operator*: Matrices can't be multiplied!"));
+		}
+		Matrix<T> C(A.rows(), B.cols(), MatRep::Column);
+		for (size_t j = 0; j < B.cols(); ++j)
+		{
+			blas::csrmv(A.rows(), static_cast<T>(1),
+				A.rowPtr().data(), A.colIndices().data(), A.values().data(),
+				B.data() + j * B.colStride(), B.rowStride(),
+				static_cast<T>(0),
+				C.data() + j * C.colStride(), C.rowStride());
+		}
+		return C;
+	}
+}
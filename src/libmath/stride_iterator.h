@@ -0,0 +1,145 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Random access iterator over elements, which are placed in memory with constant stride
+	* @details Used for walking along rows and columns of matrices. Iterator keeps base pointer and
+	* element index, so end iterators never point outside of storage.
+	* T may be const-qualified for read-only iteration.
+	*/
+	template <typename T>
+	class StrideIterator
+	{
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef typename std::remove_cv<T>::type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T* pointer;
+		typedef T& reference;
+
+		StrideIterator() = default;
+
+		/**
+		* @param base: Pointer to first element
+		* @param stride: Distance between neighbouring elements
+		* @param idx: Index of current element
+		*/
+		StrideIterator(T* base, difference_type stride, difference_type idx = 0)
+			: base_(base), stride_(stride), idx_(idx)
+		{
+		}
+
+		reference operator*() const
+		{
+			return base_[idx_ * stride_];
+		}
+
+		pointer operator->() const
+		{
+			return base_ + idx_ * stride_;
+		}
+
+		reference operator[](difference_type n) const
+		{
+			return base_[(idx_ + n) * stride_];
+		}
+
+		StrideIterator& operator++()
+		{
+			++idx_;
+			return *this;
+		}
+
+		StrideIterator operator++(int)
+		{
+			StrideIterator tmp = *this;
+			++idx_;
+			return tmp;
+		}
+
+		StrideIterator& operator--()
+		{
+			--idx_;
+			return *this;
+		}
+
+		StrideIterator operator--(int)
+		{
+			StrideIterator tmp = *this;
+			--idx_;
+			return tmp;
+		}
+
+		StrideIterator& operator+=(difference_type n)
+		{
+			idx_ += n;
+			return *this;
+		}
+
+		StrideIterator& operator-=(difference_type n)
+		{
+			idx_ -= n;
+			return *this;
+		}
+
+		friend StrideIterator operator+(StrideIterator it, difference_type n)
+		{
+			return it += n;
+		}
+
+		friend StrideIterator operator+(difference_type n, StrideIterator it)
+		{
+			return it += n;
+		}
+
+		friend StrideIterator operator-(StrideIterator it, difference_type n)
+		{
+			return it -= n;
+		}
+
+		friend difference_type operator-(const StrideIterator& a, const StrideIterator& b)
+		{
+			return a.idx_ - b.idx_;
+		}
+
+		friend bool operator==(const StrideIterator& a, const StrideIterator& b)
+		{
+			return a.idx_ == b.idx_;
+		}
+
+		friend bool operator!=(const StrideIterator& a, const StrideIterator& b)
+		{
+			return a.idx_ != b.idx_;
+		}
+
+		friend bool operator<(const StrideIterator& a, const StrideIterator& b)
+		{
+			return a.idx_ < b.idx_;
+		}
+
+		friend bool operator>(const StrideIterator& a, const StrideIterator& b)
+		{
+			return b < a;
+		}
+
+		friend bool operator<=(const StrideIterator& a, const StrideIterator& b)
+		{
+			return !(b < a);
+		}
+
+		friend bool operator>=(const StrideIterator& a, const StrideIterator& b)
+		{
+			return !(a < b);
+		}
+
+	private:
+		T* base_ = nullptr;
+		difference_type stride_ = 1;
+		difference_type idx_ = 0;
+	};
+}
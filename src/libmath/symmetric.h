@@ -0,0 +1,317 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <libmath/math_settings.h>
+#include <libmath/linear_operator.h>
+#include <libmath/blas/packed.h>
+#include <libmath/blas/gemm.h>
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Symmetric matrix in packed storage
+	* @details Only lower triangle is stored, n*(n+1)/2 elements (see blas::spmv). Element (i,j) and (j,i)
+	* are the same element, so symmetry can't be broken by assignment. Product with vector reads every stored
+	* element once. SymmetricMatrix is a matrix expression and a LinearOperator, so it can be used in elementwise
+	* expressions with Matrix, assigned to Matrix, factorized by CholeskyFactorization without copy to dense
+	* storage and passed to iterative solvers.
+	*/
+	template <typename T>
+	class SymmetricMatrix :
+		public MatExpr<SymmetricMatrix<T>>,
+		public LinearOperator<T>
+	{
+	public:
+		typedef T value_type;
+
+		/**
+		 * @brief Empty matrix 0*0
+		 */
+		SymmetricMatrix()
+			: n_{ 0 }
+		{
+		}
+
+		/**
+		 * @brief Zero matrix n*n
+		 */
+		explicit SymmetricMatrix(size_t n)
+			: n_{ n }, ap_(blas::packedSize(n))
+		{
+		}
+
+		/**
+		 * @brief Symmetric matrix from lower triangle of square matrix A
+		 * @throws math::ExceptionNonSquareMatrix
+		 */
+		explicit SymmetricMatrix(const Matrix<T>& A)
+			: n_{ A.rows() }, ap_(blas::packedSize(A.rows()))
+		{
+			if (A.rows() != A.cols())
+			{
+				throw(math::ExceptionNonSquareMatrix("SymmetricMatrix: matrix must be square!"));
+			}
+			T* a = ap_.data();
+			for (size_t i = 0; i < n_; ++i)
+			{
+				for (size_t j = 0; j <= i; ++j)
+				{
+					*a++ = A.coeff(i, j);
+				}
+			}
+		}
+
+		/**
+		 * @brief Symmetric matrix from packed lower triangle
+		 * @throws math::ExceptionInvalidValue if size of storage isn't n*(n+1)/2
+		 */
+		SymmetricMatrix(size_t n, std::vector<T> packed)
+			: n_{ n }, ap_(std::move(packed))
+		{
+			if (ap_.size() != blas::packedSize(n))
+			{
+				throw(math::ExceptionInvalidValue("SymmetricMatrix: incorrect size of packed storage!"));
+			}
+		}
+
+		virtual size_t rows() const override
+		{
+			return n_;
+		}
+
+		virtual size_t cols() const override
+		{
+			return n_;
+		}
+
+		/// @brief Elements are enumerated row by row in expressions
+		MatRep representation() const
+		{
+			return MatRep::Row;
+		}
+
+		/// @brief Packed lower triangle
+		const std::vector<T>& packed() const
+		{
+			return ap_;
+		}
+
+		/// @brief Packed lower triangle
+		std::vector<T>& packed()
+		{
+			return ap_;
+		}
+
+		/**
+		 * @brief Element at position (row, col) without check of indices
+		 */
+		T coeff(size_t row, size_t col) const
+		{
+			return row >= col ? ap_[blas::packedRow(row) + col] : ap_[blas::packedRow(col) + row];
+		}
+
+		/**
+		 * @brief Reference to element (row, col), which is also element (col, row), without check of indices
+		 */
+		T& coeffRef(size_t row, size_t col)
+		{
+			return row >= col ? ap_[blas::packedRow(row) + col] : ap_[blas::packedRow(col) + row];
+		}
+
+		/// @brief elem() computes (row, col) from pos, so expressions are evaluated by coeff() (see MatExpr)
+		bool linear() const
+		{
+			return false;
+		}
+
+		/**
+		 * @brief Element of linear position pos in row-by-row order (see MatExpr)
+		 */
+		T elem(size_t pos) const
+		{
+			return coeff(pos / n_, pos % n_);
+		}
+
+		/**
+		 * @brief Reference to element with check of indices
+		 * @throws math::ExceptionIndexOutOfBounds
+		 */
+		T& at(size_t row, size_t col)
+		{
+			if (row >= n_ || col >= n_)
+			{
+				throw(ExceptionIndexOutOfBounds("SymmetricMatrix::at: index out of bounds!"));
+			}
+			return coeffRef(row, col);
+		}
+
+		T& operator()(size_t row, size_t col)
+		{
+			if constexpr (settings::boundsCheck)
+			{
+				return at(row, col);
+			}
+			return coeffRef(row, col);
+		}
+
+		T operator()(size_t row, size_t col) const
+		{
+			if constexpr (settings::boundsCheck)
+			{
+				if (row >= n_ || col >= n_)
+				{
+					throw(ExceptionIndexOutOfBounds("SymmetricMatrix::operator(): index out of bounds!"));
+				}
+			}
+			return coeff(row, col);
+		}
+
+		/**
+		 * @brief Add lambda to diagonal: @f$ \mathbf{A} = \mathbf{A} + \lambda \mathbf{E} @f$
+		 */
+		SymmetricMatrix<T>& addToDiagonal(T lambda)
+		{
+			for (size_t i = 0; i < n_; ++i)
+			{
+				ap_[blas::packedRow(i) + i] += lambda;
+			}
+			return *this;
+		}
+
+		SymmetricMatrix<T>& operator*=(T value)
+		{
+			blas::scal(ap_.size(), value, ap_.data(), static_cast<size_t>(1));
+			return *this;
+		}
+
+		/**
+		 * @brief Sum of symmetric matrices, result stays packed
+		 * @throws math::ExceptionInvalidValue
+		 */
+		SymmetricMatrix<T>& operator+=(const SymmetricMatrix<T>& B)
+		{
+			if (B.n_ != n_)
+			{
+				throw(math::ExceptionInvalidValue("SymmetricMatrix::operator+=: Matrices must have the same dimensions!"));
+			}
+			blas::axpy(ap_.size(), static_cast<T>(1), B.ap_.data(), static_cast<size_t>(1), ap_.data(), static_cast<size_t>(1));
+			return *this;
+		}
+
+		/**
+		 * @brief Difference of symmetric matrices, result stays packed
+		 * @throws math::ExceptionInvalidValue
+		 */
+		SymmetricMatrix<T>& operator-=(const SymmetricMatrix<T>& B)
+		{
+			if (B.n_ != n_)
+			{
+				throw(math::ExceptionInvalidValue("SymmetricMatrix::operator-=: Matrices must have the same dimensions!"));
+			}
+			blas::axpy(ap_.size(), static_cast<T>(-1), B.ap_.data(), static_cast<size_t>(1), ap_.data(), static_cast<size_t>(1));
+			return *this;
+		}
+
+		/**
+		 * @brief Product @f$ \mathbf{y} = \alpha \mathbf{A} \mathbf{x} + \beta \mathbf{y} @f$ (see blas::spmv)
+		 * @throws math::ExceptionIncorrectMatrix
+		 */
+		virtual void apply(T alpha, const Matrix<T>& x, T beta, Matrix<T>& y) const override
+		{
+			if (x.numel() != n_ || (x.rows() != 1 && x.cols() != 1))
+			{
+				throw(math::ExceptionIncorrectMatrix("SymmetricMatrix::apply: dimensions of arguments A and x didn't agree!"));
+			}
+			if (y.numel() != n_ || (y.rows() != 1 && y.cols() != 1))
+			{
+				throw(math::ExceptionIncorrectMatrix("SymmetricMatrix::apply: dimensions of arguments A and y didn't agree!"));
+			}
+			blas::spmv(n_, alpha, ap_.data(),
+				x.data(), static_cast<size_t>(1),
+				beta,
+				y.data(), static_cast<size_t>(1));
+		}
+
+	private:
+		size_t n_;
+		//! Packed lower triangle
+		std::vector<T> ap_;
+	};
+
+	namespace expr
+	{
+		template <typename T>
+		struct Storage<SymmetricMatrix<T>>
+		{
+			typedef const SymmetricMatrix<T>& type;
+		};
+	}
+
+	/**
+	* @brief Product of symmetric and dense matrices
+	* @details Every column of B is multiplied by blas::spmv
+	* @throws math::ExceptionInvalidValue
+	*/
+	template <typename T>
+	Matrix<T> operator*(const SymmetricMatrix<T>& A, const Matrix<T>& B)
+	{
+		if (A.cols() != B.rows())
+		{
+			throw(math::ExceptionInvalidValue("SymmetricMatrix<T>::operator*: Matrices can't be multiplied!"));
+		}
+		Matrix<T> C(A.rows(), B.cols(), MatRep::Column);
+		for (size_t j = 0; j < B.cols(); ++j)
+		{
+			blas::spmv(A.rows(), static_cast<T>(1), A.packed().data(),
+				B.data() + j * B.colStride(), B.rowStride(),
+				static_cast<T>(0),
+				C.data() + j * C.colStride(), C.rowStride());
+		}
+		return C;
+	}
+
+	/**
+	* @brief Gram matrix @f$ \mathbf{J}^T \mathbf{J} @f$ in packed storage
+	* @details Only blocks of lower triangle are computed by gemm (blocks of blas::packedBlock columns),
+	* i.e. about half of multiplications of J.t() * J, and result takes half of memory.
+	*/
+	template <typename T>
+	SymmetricMatrix<T> gram(const Matrix<T>& J)
+	{
+		const size_t m = J.rows();
+		const size_t n = J.cols();
+		SymmetricMatrix<T> G(n);
+		T* ap = G.packed().data();
+		const T* a = J.data();
+		const size_t rs = J.rowStride();
+		const size_t cs = J.colStride();
+		const size_t nb = std::min(n, blas::packedBlock);
+		std::vector<T> W(nb * nb);
+		for (size_t i0 = 0; i0 < n; i0 += blas::packedBlock)
+		{
+			const size_t i1 = std::min(n, i0 + blas::packedBlock);
+			for (size_t j0 = 0; j0 <= i0; j0 += blas::packedBlock)
+			{
+				const size_t j1 = std::min(n, j0 + blas::packedBlock);
+				// W = J(:,I)^T * J(:,J)
+				blas::gemm(i1 - i0, j1 - j0, m, static_cast<T>(1),
+					a + i0 * cs, cs, rs,
+					a + j0 * cs, rs, cs,
+					static_cast<T>(0),
+					W.data(), nb, static_cast<size_t>(1));
+				for (size_t i = i0; i < i1; ++i)
+				{
+					const T* w = W.data() + (i - i0) * nb;
+					std::copy(w, w + std::min(j1, i + 1) - j0, ap + blas::packedRow(i) + j0);
+				}
+			}
+		}
+		return G;
+	}
+}
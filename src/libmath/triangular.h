@@ -0,0 +1,312 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <libmath/math_settings.h>
+#include <libmath/blas/packed.h>
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Lower or upper triangular matrix in packed storage
+	* @details Only the triangle is stored, n*(n+1)/2 elements (see blas::tpsv), elements
+	* outside the triangle are zeros and can't be changed. Products and solutions use packed
+	* kernels and don't touch zeros. TriangularMatrix is a matrix expression, so it can be used
+	* in elementwise expressions with Matrix and assigned to Matrix.
+	*/
+	template <typename T>
+	class TriangularMatrix :
+		public MatExpr<TriangularMatrix<T>>
+	{
+	public:
+		typedef T value_type;
+
+		/**
+		 * @brief Empty lower triangular matrix 0*0
+		 */
+		TriangularMatrix()
+			: n_{ 0 }, uplo_{ Uplo::Lower }
+		{
+		}
+
+		/**
+		 * @brief Zero triangular matrix n*n
+		 */
+		explicit TriangularMatrix(size_t n, Uplo uplo = Uplo::Lower)
+			: n_{ n }, uplo_{ uplo }, ap_(blas::packedSize(n))
+		{
+		}
+
+		/**
+		 * @brief Triangle of square matrix A
+		 * @throws math::ExceptionNonSquareMatrix
+		 */
+		TriangularMatrix(const Matrix<T>& A, Uplo uplo)
+			: n_{ A.rows() }, uplo_{ uplo }, ap_(blas::packedSize(A.rows()))
+		{
+			if (A.rows() != A.cols())
+			{
+				throw(math::ExceptionNonSquareMatrix("TriangularMatrix: matrix must be square!"));
+			}
+			T* a = ap_.data();
+			for (size_t i = 0; i < n_; ++i)
+			{
+				const size_t j0 = (uplo_ == Uplo::Lower) ? 0 : i;
+				const size_t j1 = (uplo_ == Uplo::Lower) ? i + 1 : n_;
+				for (size_t j = j0; j < j1; ++j)
+				{
+					*a++ = A.coeff(i, j);
+				}
+			}
+		}
+
+		/**
+		 * @brief Triangular matrix from packed storage
+		 * @throws math::ExceptionInvalidValue if size of storage isn't n*(n+1)/2
+		 */
+		TriangularMatrix(size_t n, Uplo uplo, std::vector<T> packed)
+			: n_{ n }, uplo_{ uplo }, ap_(std::move(packed))
+		{
+			if (ap_.size() != blas::packedSize(n))
+			{
+				throw(math::ExceptionInvalidValue("TriangularMatrix: incorrect size of packed storage!"));
+			}
+		}
+
+		/// @brief Stored triangle
+		Uplo uplo() const
+		{
+			return uplo_;
+		}
+
+		size_t rows() const
+		{
+			return n_;
+		}
+
+		size_t cols() const
+		{
+			return n_;
+		}
+
+		/// @brief Elements are enumerated row by row in expressions
+		MatRep representation() const
+		{
+			return MatRep::Row;
+		}
+
+		/// @brief Packed storage of triangle
+		const std::vector<T>& packed() const
+		{
+			return ap_;
+		}
+
+		/// @brief Packed storage of triangle
+		std::vector<T>& packed()
+		{
+			return ap_;
+		}
+
+		/// @brief Check, that (row, col) is in stored triangle
+		bool stored(size_t row, size_t col) const
+		{
+			return (uplo_ == Uplo::Lower) ? col <= row : col >= row;
+		}
+
+		/**
+		 * @brief Element at position (row, col) without check of indices
+		 */
+		T coeff(size_t row, size_t col) const
+		{
+			return stored(row, col) ? ap_[blas::packedIndex(uplo_, n_, row, col)] : static_cast<T>(0);
+		}
+
+		/**
+		 * @brief Reference to element of stored triangle without check of indices
+		 */
+		T& coeffRef(size_t row, size_t col)
+		{
+			return ap_[blas::packedIndex(uplo_, n_, row, col)];
+		}
+
+		/// @brief elem() computes (row, col) from pos, so expressions are evaluated by coeff() (see MatExpr)
+		bool linear() const
+		{
+			return false;
+		}
+
+		/**
+		 * @brief Element of linear position pos in row-by-row order (see MatExpr)
+		 */
+		T elem(size_t pos) const
+		{
+			return coeff(pos / n_, pos % n_);
+		}
+
+		/**
+		 * @brief Reference to element of stored triangle with check of indices
+		 * @throws math::ExceptionIndexOutOfBounds also for elements outside the triangle
+		 */
+		T& at(size_t row, size_t col)
+		{
+			if (row >= n_ || col >= n_ || !stored(row, col))
+			{
+				throw(ExceptionIndexOutOfBounds("TriangularMatrix::at: index out of stored triangle!"));
+			}
+			return coeffRef(row, col);
+		}
+
+		T& operator()(size_t row, size_t col)
+		{
+			if constexpr (settings::boundsCheck)
+			{
+				return at(row, col);
+			}
+			return coeffRef(row, col);
+		}
+
+		T operator()(size_t row, size_t col) const
+		{
+			if constexpr (settings::boundsCheck)
+			{
+				if (row >= n_ || col >= n_)
+				{
+					throw(ExceptionIndexOutOfBounds("TriangularMatrix::operator(): index out of bounds!"));
+				}
+			}
+			return coeff(row, col);
+		}
+
+		/**
+		 * @brief Determinant (product of diagonal)
+		 */
+		T det() const
+		{
+			T d = static_cast<T>(1);
+			for (size_t i = 0; i < n_; ++i)
+			{
+				d *= ap_[blas::packedIndex(uplo_, n_, i, i)];
+			}
+			return d;
+		}
+
+		/**
+		 * @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$ in place: B is replaced by X
+		 * @throws math::ExceptionIncorrectMatrix
+		 * @throws math::ExceptionDegenerateMatrix
+		 */
+		void solveInPlace(Matrix<T>& B) const
+		{
+			if (B.rows() != n_)
+			{
+				throw(math::ExceptionIncorrectMatrix("TriangularMatrix::solveInPlace: dimensions of matrix and B didn't agree!"));
+			}
+			checkDiagonal("TriangularMatrix::solveInPlace");
+			for (size_t j = 0; j < B.cols(); ++j)
+			{
+				blas::tpsv(uplo_, n_, ap_.data(), B.data() + j * B.colStride(), B.rowStride());
+			}
+		}
+
+		/**
+		 * @brief Solve @f$ \mathbf{A} \mathbf{X} = \mathbf{B} @f$
+		 * @return X with dimensions and representation of B
+		 */
+		Matrix<T> solve(const Matrix<T>& B) const
+		{
+			Matrix<T> X(B);
+			solveInPlace(X);
+			return X;
+		}
+
+		/**
+		 * @brief Inverse matrix, which is triangular with the same stored triangle
+		 * @details Computed column by column inside the triangle
+		 * @throws math::ExceptionDegenerateMatrix
+		 */
+		TriangularMatrix<T> inverse() const
+		{
+			checkDiagonal("TriangularMatrix::inverse");
+			TriangularMatrix<T> X(n_, uplo_);
+			std::vector<T> x(n_);
+			const T* a = ap_.data();
+			for (size_t j = 0; j < n_; ++j)
+			{
+				if (uplo_ == Uplo::Lower)
+				{
+					// column j of inverse has non-zeros in rows j:n
+					x[j] = static_cast<T>(1) / a[blas::packedRow(j) + j];
+					X.coeffRef(j, j) = x[j];
+					for (size_t i = j + 1; i < n_; ++i)
+					{
+						const T* ai = a + blas::packedRow(i);
+						x[i] = -blas::dot(i - j, ai + j, 1, x.data() + j, 1) / ai[i];
+						X.coeffRef(i, j) = x[i];
+					}
+				}
+				else
+				{
+					// column j of inverse has non-zeros in rows 0:j+1
+					x[j] = static_cast<T>(1) / a[blas::packedRowUpper(n_, j)];
+					X.coeffRef(j, j) = x[j];
+					for (size_t i = j; i-- > 0;)
+					{
+						const T* ai = a + blas::packedRowUpper(n_, i);
+						x[i] = -blas::dot(j - i, ai + 1, 1, x.data() + i + 1, 1) / ai[0];
+						X.coeffRef(i, j) = x[i];
+					}
+				}
+			}
+			return X;
+		}
+
+	private:
+		size_t n_;
+		Uplo uplo_;
+		//! Packed triangle
+		std::vector<T> ap_;
+
+		void checkDiagonal(const char* method) const
+		{
+			for (size_t i = 0; i < n_; ++i)
+			{
+				if (ap_[blas::packedIndex(uplo_, n_, i, i)] == static_cast<T>(0))
+				{
+					throw(math::ExceptionDegenerateMatrix(std::string(method) + ": zero on diagonal of triangular matrix!"));
+				}
+			}
+		}
+	};
+
+	namespace expr
+	{
+		template <typename T>
+		struct Storage<TriangularMatrix<T>>
+		{
+			typedef const TriangularMatrix<T>& type;
+		};
+	}
+
+	/**
+	* @brief Product of triangular and dense matrices, zeros of A aren't touched
+	* @throws math::ExceptionInvalidValue
+	*/
+	template <typename T>
+	Matrix<T> operator*(const TriangularMatrix<T>& A, const Matrix<T>& B)
+	{
+		if (A.cols() != B.rows())
+		{
+			throw(math::ExceptionInvalidValue("TriangularMatrix<T>::operator*: Matrices can't be multiplied!"));
+		}
+		Matrix<T> C(B);
+		for (size_t j = 0; j < C.cols(); ++j)
+		{
+			blas::tpmv(A.uplo(), A.rows(), A.packed().data(), C.data() + j * C.colStride(), C.rowStride());
+		}
+		return C;
+	}
+}
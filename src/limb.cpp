@@ -1,46 +1,50 @@
 #include <limb.h>
 #define _USE_MATH_DEFINES
 #include <cmath>
-#include <libmath/matrix.h>
+#include <libmath/smatrix.h>
 
 using namespace robo;
 
-void Limb::calcServoPos(const math::Matrix<real> &coord)
+/// @brief Radians to degrees (in precision of real, see MATH_SINGLE_PRECISION)
+static const real rad2deg = static_cast<real>(180.0 / M_PI);
+
+void Limb::calcServoPos(const math::Vector3<real> &coord)
 {
     // calc target servos angles
 
-    math::Matrix<real> target_coords_2d_ =
+    math::SMatrix<real, 2, 1> target_coords_2d_ =
         {
-            {std::sqrt(std::pow(coord(0, 0), 2.0) + std::pow(coord(1, 0), 2.0))},
+            {std::sqrt(coord(0, 0) * coord(0, 0) + coord(1, 0) * coord(1, 0))},
             {coord(2, 0)}
         };
 
     servo_target_pos_(0, 0) =
-        std::acos(coord(0, 0) / std::sqrt(std::pow(coord(0, 0), 2.0) + std::pow(coord(1, 0), 2.0))) * (180.0/M_PI);
+        std::acos(coord(0, 0) / target_coords_2d_(0, 0)) * rad2deg;
 
     real L03 = std::sqrt(
-        std::pow(target_coords_2d_(0, 0), 2.0) + std::pow(target_coords_2d_(1, 0), 2.0)
+        target_coords_2d_(0, 0) * target_coords_2d_(0, 0) + target_coords_2d_(1, 0) * target_coords_2d_(1, 0)
     );
 
+    const real dx = target_coords_2d_(0, 0) - L_(0, 0);
     real L13 =
         std::sqrt(
-            std::pow(target_coords_2d_(0, 0) - L_(0, 0), 2.0) +
-            std::pow(target_coords_2d_(1, 0), 2.0));
+            dx * dx +
+            target_coords_2d_(1, 0) * target_coords_2d_(1, 0));
 
     real f03 = std::acos(
-        (L03 * L03 - L_(0, 0) * L_(0, 0) - L13 * L13) / (-2.0 * L_(0, 0) * L13)
-    ) * (180.0/M_PI);
+        (L03 * L03 - L_(0, 0) * L_(0, 0) - L13 * L13) / (static_cast<real>(-2.0) * L_(0, 0) * L13)
+    ) * rad2deg;
 
     real f13 = std::acos(
-        (L_(2, 0) * L_(2, 0) - L_(1, 0) * L_(1, 0) - L13 * L13) / (-2.0 * L_(1, 0) * L13)
-    ) * (180.0/M_PI);
+        (L_(2, 0) * L_(2, 0) - L_(1, 0) * L_(1, 0) - L13 * L13) / (static_cast<real>(-2.0) * L_(1, 0) * L13)
+    ) * rad2deg;
 
     // invert, if Z > 0
-    servo_target_pos_(1, 0) = coord(2,0) > 0 ? f03 - f13 : 360.0 - f03 - f13;
+    servo_target_pos_(1, 0) = coord(2,0) > 0 ? f03 - f13 : static_cast<real>(360.0) - f03 - f13;
 
     servo_target_pos_(2, 0) = std::acos(
-        (L13 * L13 - L_(1, 0) * L_(1, 0) - L_(2, 0) * L_(2, 0)) / (-2.0 * L_(1, 0) * L_(2, 0))
-    ) * (180.0/M_PI);
+        (L13 * L13 - L_(1, 0) * L_(1, 0) - L_(2, 0) * L_(2, 0)) / (static_cast<real>(-2.0) * L_(1, 0) * L_(2, 0))
+    ) * rad2deg;
 
     // re-calc positions with zero servo positions
 
@@ -51,7 +55,7 @@ void Limb::calcServoPos(const math::Matrix<real> &coord)
 
     // set target servos angles
 
-    auto pos = servo_target_pos_.vectorized().cbegin();
+    auto pos = servo_target_pos_.begin();
     for(auto& servo : servo_)
     {
         servo.setTargetPosition(*pos);
@@ -1,5 +1,5 @@
 #pragma once
-#include <libmath/matrix.h>
+#include <libmath/smatrix.h>
 #include <vector>
 #include <defines.h>
 #include <string>
@@ -22,7 +22,7 @@ namespace robo
         Adafruit_PWMServoDriver* pwm_ = nullptr;
 
         /// @brief Length of limb parts
-        math::Matrix<real> L_;
+        math::Vector3<real> L_;
 
         /// @brief Number of vertexes
         size_t vertex_num_;
@@ -34,10 +34,10 @@ namespace robo
         std::string name_;
 
         /// @brief Target servo positions [deg]
-        math::Matrix<real> servo_target_pos_ = math::Matrix<real>(3, 1);
+        math::Vector3<real> servo_target_pos_;
 
         /// @brief Zero servo positions [deg]
-        math::Matrix<real> servo_zero_pos_ = math::Matrix<real>(3, 1);
+        math::Vector3<real> servo_zero_pos_;
 
         /// @brief Servos pins
         std::vector<int> servo_pins_;
@@ -60,10 +60,10 @@ namespace robo
          * @param name: Limb name. Default name is "Limb_[idx]""
          */
         Limb(
-            const math::Matrix<real> &L,
+            const math::Vector3<real> &L,
             const std::vector<int> &servo_pins,
             Adafruit_PWMServoDriver* pwm, 
-            const math::Matrix<real> &servo_zero_pos =
+            const math::Vector3<real> &servo_zero_pos =
             {
                 {0.0},
                 {0.0},
@@ -77,19 +77,11 @@ namespace robo
             servo_zero_pos_(servo_zero_pos),
             name_(name)
         {
-            // check inputs
-            if (L_.rows() != 3)
-            {
-                throw(ExceptionInvalidValue("Limb: links amount must be 3!"));
-            }
+            // check inputs (dimensions of L are checked at compile time)
             if (servo_pins_.size() != 3)
             {
                 throw(ExceptionInvalidValue("Limb: servo pins amount must be 3!"));
             }
-            if (L_.cols() != 1)
-            {
-                throw(ExceptionInvalidValue("Limb: L must be column vector!"));
-            }
 
             if (name_ == "")
             {
@@ -113,7 +105,7 @@ namespace robo
 
         /// @brief Set target coordinates of the limb end (foot) and compute
         /// target servos angles
-        void calcServoPos(const math::Matrix<real> &coords);
+        void calcServoPos(const math::Vector3<real> &coords);
 
         /**
          * @brief Move limb servos to target positions at each controller's loop iteration
@@ -25,19 +25,20 @@ bool robo::Servo::move()
 {
     t_c_ = millis();
 
-    real dt = t_c_ - t_l_;
+    // time step, s
+    real dt = static_cast<real>(t_c_ - t_l_) * static_cast<real>(1.e-3);
 
     // calculate current position
     real err = target_pos_ - current_pos_;
     
-    if (!math::isEqual(t_l_, 0.0))
+    if (t_l_ != 0)
     {
-        if (abs(err) > 0.1)
+        if (abs(err) > static_cast<real>(0.1))
         {
-            bool thisDir = (speed_ * speed_ / acceleration_ / 2.0 >= abs(err)); // пора тормозить
-            speed_ += acceleration_ * dt * 1.e-3 * (thisDir ? -sign(speed_) : sign(err));
+            bool thisDir = (speed_ * speed_ / acceleration_ / static_cast<real>(2.0) >= abs(err)); // пора тормозить
+            speed_ += acceleration_ * dt * (thisDir ? -sign(speed_) : sign(err));
             speed_ = constrain(speed_, -max_speed_, speed_);
-            current_pos_ += speed_ * dt * 1.e-3;
+            current_pos_ += speed_ * dt;
         }
     }
 
@@ -47,7 +48,7 @@ bool robo::Servo::move()
 
     t_l_ = t_c_;
 
-    if (math::isEqual(err, 0.0))
+    if (math::isEqual(err, static_cast<real>(0.0)))
     {
         return true;
     }
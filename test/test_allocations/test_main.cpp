@@ -0,0 +1,251 @@
+/**
+* @brief Heap allocations of repeated solves and of operators on temporary matrices (native environment,
+* see platformio.ini)
+* @details operator new is replaced by counting one. Solvers keep their workspaces between calls,
+* so after the first solve of given dimension solving must not allocate memory. Operators on expiring
+* matrices store result in storage of the temporary.
+*/
+
+#include <libmath/solver/us/secant.h>
+#include <libmath/solver/las/bicgstab.h>
+#include <libmath/solver/las/cg.h>
+#include <libmath/solver/las/gmres.h>
+#include <libmath/sparse.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace
+{
+	size_t allocations = 0;
+	bool counting = false;
+
+	void* allocate(size_t bytes, size_t alignment)
+	{
+		if (counting)
+		{
+			++allocations;
+		}
+		bytes = (std::max<size_t>(bytes, 1) + alignment - 1) / alignment * alignment;
+		void* p = std::aligned_alloc(alignment, bytes);
+		if (p == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	/// @brief Number of allocations of call of f
+	template <typename F>
+	size_t allocationsOf(F f)
+	{
+		allocations = 0;
+		counting = true;
+		f();
+		counting = false;
+		return allocations;
+	}
+
+	/// @brief Number of allocations of the second call of f (the first one sizes workspaces)
+	template <typename F>
+	size_t steadyStateAllocations(F f)
+	{
+		f();
+		allocations = 0;
+		counting = true;
+		f();
+		counting = false;
+		return allocations;
+	}
+
+	/// @brief Unlinear system of n equations with tridiagonal Jacobian
+	std::vector<std::function<double(const math::Matrix<double>&)>> system(size_t n)
+	{
+		std::vector<std::function<double(const math::Matrix<double>&)>> F;
+		for (size_t i = 0; i < n; ++i)
+		{
+			F.push_back([i, n](const math::Matrix<double>& x)
+				{
+					double f = x(i, 0) * x(i, 0) * x(i, 0) + 4.0 * x(i, 0) - 1.0 - 0.1 * i;
+					if (i + 1 < n)
+					{
+						f += 0.5 * x(i + 1, 0);
+					}
+					if (i > 0)
+					{
+						f += 0.3 * x(i - 1, 0);
+					}
+					return f;
+				});
+		}
+		return F;
+	}
+
+	/// @brief Symmetric positive-definite tridiagonal matrix n*n
+	math::SparseMatrix<double> laplacian(size_t n)
+	{
+		std::vector<math::Triplet<double>> t;
+		for (size_t i = 0; i < n; ++i)
+		{
+			t.push_back({ i, i, 4.0 });
+			if (i > 0)
+			{
+				t.push_back({ i, i - 1, -1.0 });
+			}
+			if (i + 1 < n)
+			{
+				t.push_back({ i, i + 1, -1.0 });
+			}
+		}
+		return math::SparseMatrix<double>::fromTriplets(n, n, t);
+	}
+}
+
+void* operator new(size_t bytes)
+{
+	return allocate(bytes, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t bytes)
+{
+	return allocate(bytes, alignof(std::max_align_t));
+}
+
+void* operator new(size_t bytes, std::align_val_t alignment)
+{
+	return allocate(bytes, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t bytes, std::align_val_t alignment)
+{
+	return allocate(bytes, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_secant_bicgstab()
+{
+	// 18 - dimension of quadropod, 40 - matrices don't fit inline storage
+	for (size_t n : { 3, 18, 40 })
+	{
+		const auto F = system(n);
+		math::Secant<double> secant;
+		math::Matrix<double> x(n, 1);
+		TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]()
+			{
+				x.fill(1.0);
+				secant.solve(F, x);
+			}));
+	}
+}
+
+void test_secant_condition_limit()
+{
+	for (size_t n : { 3, 18, 40 })
+	{
+		const auto F = system(n);
+		math::USsetup setup;
+		setup.conditionLimit = 1e8;
+		math::Secant<double> secant(setup);
+		math::Matrix<double> x(n, 1);
+		TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]()
+			{
+				x.fill(1.0);
+				secant.solve(F, x);
+			}));
+	}
+}
+
+void test_jacobi_workspace()
+{
+	const size_t n = 40;
+	const auto F = system(n);
+	math::Matrix<double> x(n, 1);
+	x.fill(1.0);
+	math::Matrix<double> J(n, n);
+	math::Matrix<double> xw;
+	TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]()
+		{
+			math::jacobi(F, x, J, xw);
+		}));
+}
+
+void test_las_solvers()
+{
+	const size_t n = 400;
+	const math::SparseMatrix<double> A = laplacian(n);
+	const math::Matrix<double> D = A.toMatrix();
+	math::Matrix<double> b(n, 1);
+	b.fill(1.0);
+	math::Matrix<double> x(n, 1);
+
+	math::BicGStab<double> bicgstab;
+	math::CG<double> cg;
+	math::GMRES<double> gmres;
+	const math::ILU0Preconditioner<double> ilu(A);
+	const math::JacobiPreconditioner<double> jacobi(A);
+
+	TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]() { x.fill(0.0); bicgstab.solve(A, b, x); }));
+	TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]() { x.fill(0.0); bicgstab.solve(D, b, x); }));
+	TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]() { x.fill(0.0); cg.solve(A, b, x); }));
+	TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]() { x.fill(0.0); gmres.solve(A, b, x); }));
+
+	bicgstab.setPreconditioner(&ilu);
+	cg.setPreconditioner(&jacobi);
+	gmres.setPreconditioner(&ilu);
+	TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]() { x.fill(0.0); bicgstab.solve(A, b, x); }));
+	TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]() { x.fill(0.0); cg.solve(A, b, x); }));
+	TEST_ASSERT_EQUAL_UINT(0, steadyStateAllocations([&]() { x.fill(0.0); gmres.solve(A, b, x); }));
+}
+
+void test_rvalue_operators()
+{
+	// 50 elements don't fit inline storage, so the only allocation is the product
+	const size_t n = 50;
+	math::Matrix<double> A(n, n);
+	math::Matrix<double> x(n, 1);
+	math::Matrix<double> b(n, 1);
+	A.fill(1.0);
+	x.fill(1.0);
+	b.fill(1.0);
+	math::Matrix<double> r;
+
+	TEST_ASSERT_EQUAL_UINT(1, allocationsOf([&]() { r = A * x - b; }));
+	TEST_ASSERT_EQUAL_UINT(1, allocationsOf([&]() { r = b - A * x; }));
+	TEST_ASSERT_EQUAL_UINT(1, allocationsOf([&]() { r = 2.0 * (A * x) + 1.0; }));
+	TEST_ASSERT_EQUAL_UINT(0, allocationsOf([&]() { math::Matrix<double> moved(std::move(r)); }));
+	size_t size = 0;
+	TEST_ASSERT_EQUAL_UINT(0, allocationsOf([&]() { size = A.vectorized().size(); }));
+	TEST_ASSERT_EQUAL_UINT(n * n, size);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_secant_bicgstab);
+	RUN_TEST(test_secant_condition_limit);
+	RUN_TEST(test_jacobi_workspace);
+	RUN_TEST(test_las_solvers);
+	RUN_TEST(test_rvalue_operators);
+	return UNITY_END();
+}
@@ -0,0 +1,261 @@
+/**
+* @brief Time and accuracy of float, double and mixed precision solves (runs on ESP32-S3 and on host)
+* @details Compares LU<float>, LU<double> and MixedPrecisionLU<double, float> on random well-conditioned
+* systems of quadropod sizes, and Secant in math::real (linear solver of USsetup works in math::real only) on
+* unlinear system with tridiagonal Jacobian: float on ESP32 (MATH_SINGLE_PRECISION), double in native environment.
+* Times (average of repeats, us) are printed as test messages, so
+* @code
+* pio test -e esp32-s3-devkitc-1 -f test_bench_precision -v
+* @endcode
+* prints them for the target. Accuracy is checked by assertions, time isn't: it depends on the host.
+*/
+
+#include <libmath/lu.h>
+#include <libmath/solver/us/secant.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace
+{
+	/// @brief Dimensions: leg, 2 legs, quadropod
+	const size_t sizes[] = { 3, 6, 18 };
+
+	/// @brief Number of timed repeats of each solve
+	const int repeats = 50;
+
+	/// @brief Monotonic time in us
+	double now()
+	{
+#ifdef ARDUINO
+		return static_cast<double>(micros());
+#else
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	/// @brief Average time of call of f in us
+	template <typename F>
+	double timeOf(F f)
+	{
+		f();
+		const double start = now();
+		for (int r = 0; r < repeats; ++r)
+		{
+			f();
+		}
+		return (now() - start) / repeats;
+	}
+
+	/// @brief Print time and error (relative error of solution, or maximum residual) as test message
+	void report(const char* name, size_t n, double us, double error)
+	{
+		char message[128];
+		std::snprintf(message, sizeof(message), "%-18s n = %2u  %10.1f us  error %.1e", name,
+			static_cast<unsigned>(n), us, error);
+		TEST_MESSAGE(message);
+	}
+
+	/// @brief Random diagonally dominant matrix n*n
+	math::Matrix<double> randomMatrix(size_t n)
+	{
+		std::mt19937 generator(static_cast<unsigned>(n));
+		std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+		math::Matrix<double> A(n, n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t j = 0; j < n; ++j)
+			{
+				A(i, j) = uniform(generator) + (i == j ? static_cast<double>(n) : 0.0);
+			}
+		}
+		return A;
+	}
+
+	/// @brief Element-wise conversion of matrix to precision T
+	template <typename T, typename S>
+	math::Matrix<T> convert(const math::Matrix<S>& A)
+	{
+		math::Matrix<T> B(A.rows(), A.cols());
+		for (size_t i = 0; i < A.rows(); ++i)
+		{
+			for (size_t j = 0; j < A.cols(); ++j)
+			{
+				B(i, j) = static_cast<T>(A(i, j));
+			}
+		}
+		return B;
+	}
+
+	/// @brief ||x - x_ref||_inf / ||x_ref||_inf
+	template <typename T>
+	double relativeError(const math::Matrix<T>& x, const math::Matrix<double>& xref)
+	{
+		double diff = 0.0, norm = 0.0;
+		for (size_t i = 0; i < xref.rows(); ++i)
+		{
+			diff = std::max(diff, std::abs(static_cast<double>(x(i, 0)) - xref(i, 0)));
+			norm = std::max(norm, std::abs(xref(i, 0)));
+		}
+		return diff / norm;
+	}
+
+	/// @brief Unlinear system of n equations with tridiagonal Jacobian
+	template <typename T>
+	std::vector<std::function<T(const math::Matrix<T>&)>> system(size_t n)
+	{
+		std::vector<std::function<T(const math::Matrix<T>&)>> F;
+		for (size_t i = 0; i < n; ++i)
+		{
+			F.push_back([i, n](const math::Matrix<T>& x)
+				{
+					T f = x(i, 0) * x(i, 0) * x(i, 0) + T(4) * x(i, 0) - T(1) - T(0.1) * static_cast<T>(i);
+					if (i + 1 < n)
+					{
+						f += T(0.5) * x(i + 1, 0);
+					}
+					if (i > 0)
+					{
+						f += T(0.3) * x(i - 1, 0);
+					}
+					return f;
+				});
+		}
+		return F;
+	}
+
+	/// @brief Average time of solving system(n) by Secant with LU steps, solution x
+	double secant(size_t n, math::Matrix<math::real>& x)
+	{
+		const auto F = system<math::real>(n);
+		math::USsetup setup;
+		setup.conditionLimit = 1e6;
+		setup.targetTolerance = static_cast<math::real>(1e-5);
+		math::Secant<math::real> solver(setup);
+		return timeOf([&]()
+			{
+				x.fill(math::real(1));
+				solver.solve(F, x);
+			});
+	}
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_lu_precision()
+{
+	for (size_t n : sizes)
+	{
+		const math::Matrix<double> A = randomMatrix(n);
+		math::Matrix<double> xref(n, 1);
+		for (size_t i = 0; i < n; ++i)
+		{
+			xref(i, 0) = 1.0 + static_cast<double>(i);
+		}
+		const math::Matrix<double> b = A * xref;
+
+		const math::Matrix<float> Af = convert<float>(A);
+		const math::Matrix<float> bf = convert<float>(b);
+		math::LU<float> luf;
+		math::Matrix<float> xf;
+		const double tf = timeOf([&]()
+			{
+				luf.factorize(Af);
+				xf = bf;
+				luf.solveInPlace(xf);
+			});
+		const double ef = relativeError(xf, xref);
+		report("LU<float>", n, tf, ef);
+
+		math::LU<double> lud;
+		math::Matrix<double> xd;
+		const double td = timeOf([&]()
+			{
+				lud.factorize(A);
+				xd = b;
+				lud.solveInPlace(xd);
+			});
+		const double ed = relativeError(xd, xref);
+		report("LU<double>", n, td, ed);
+
+		math::MixedPrecisionLU<double, float> lum;
+		math::Matrix<double> xm;
+		const double tm = timeOf([&]()
+			{
+				lum.factorize(A);
+				xm = b;
+				lum.solveInPlace(xm);
+			});
+		const double em = relativeError(xm, xref);
+		report("MixedPrecisionLU", n, tm, em);
+
+		TEST_ASSERT_TRUE(ef < 1e-5);
+		TEST_ASSERT_TRUE(ed < 1e-13);
+		TEST_ASSERT_TRUE(lum.converged());
+		TEST_ASSERT_TRUE(em < 1e-13);
+	}
+}
+
+void test_secant_precision()
+{
+	for (size_t n : sizes)
+	{
+		math::Matrix<math::real> x(n, 1);
+		const double t = secant(n, x);
+
+		// residuals in double
+		const auto F = system<double>(n);
+		const math::Matrix<double> xd = convert<double>(x);
+		double residual = 0.0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			residual = std::max(residual, std::abs(F[i](xd)));
+		}
+		report("Secant<real>", n, t, residual);
+
+		TEST_ASSERT_TRUE(residual < (sizeof(math::real) == sizeof(float) ? 1e-5 : 1e-10));
+	}
+}
+
+int runTests()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_lu_precision);
+	RUN_TEST(test_secant_precision);
+	return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup()
+{
+	// wait for serial monitor of test runner
+	delay(2000);
+	runTests();
+}
+
+void loop()
+{
+}
+#else
+int main()
+{
+	return runTests();
+}
+#endif